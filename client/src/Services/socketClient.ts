@@ -3,6 +3,7 @@ import { Socket, io } from 'socket.io-client';
 import { create } from 'zustand';
 import { ServerToClientEvent } from './socketClientType';
 import { ClientToServerEvents } from './socketServerType';
+import { Addr, AnnotatedRoots, RangeRequest } from '../visualiser-debugger/Types/backendType';
 
 const URL = import.meta.env.VITE_DEBUGGER_URL || 'http://localhost:8000';
 
@@ -69,6 +70,12 @@ class SocketClient {
     executeNext: () => {
       this.socket.emit('executeNext');
     },
+    stepBack: () => {
+      this.socket.emit('stepBack');
+    },
+    goToStep: (step: number) => {
+      this.socket.emit('goToStep', step);
+    },
     sendStdin: (data: any) => {
       this.socket.emit('send_stdin', data);
     },
@@ -78,6 +85,27 @@ class SocketClient {
     sendSIGINT: () => {
       this.socket.emit('SIGINT');
     },
+    saveTrace: (name: string) => {
+      this.socket.emit('saveTrace', name);
+    },
+    startLecture: (name: string) => {
+      this.socket.emit('startLecture', name);
+    },
+    joinLecture: (name: string) => {
+      this.socket.emit('joinLecture', name);
+    },
+    leaveLecture: (name: string) => {
+      this.socket.emit('leaveLecture', name);
+    },
+    setAnnotatedRoots: (roots: AnnotatedRoots) => {
+      this.socket.emit('setAnnotatedRoots', roots);
+    },
+    expandObject: (step: number, addr: Addr, typeName: string) => {
+      this.socket.emit('expandObject', { step, addr, typeName });
+    },
+    readRange: (request: RangeRequest) => {
+      this.socket.emit('readRange', request);
+    },
   };
 }
 
@@ -1,7 +1,9 @@
 import {
   BackendState,
   BackendTypeDeclaration,
+  CellRange,
   FunctionStructure,
+  ObjectExpansion,
 } from '../visualiser-debugger/Types/backendType';
 
 // key in below object is used for socket.on as key
@@ -11,11 +13,22 @@ type ServerToClientEventsType = {
   sendTypeDeclaration: BackendTypeDeclaration;
   sendBackendStateToUser: BackendState;
   sendStdoutToUser: string;
-  programWaitingForInput: any;
+  programWaitingForInput: void;
   compileError: string[];
   send_stdin: string;
   acknowledgedEOF: string;
   acknowledgedSIGINT: string;
+  saveTrace: string;
+  saveTraceError: string;
+  startLecture: string;
+  // The lecturer's step, whose state follows
+  joinLecture: { name: string; step: number };
+  lectureClosed: string;
+  lectureError: string;
+  // The step the program was taken back to, and the state after it, null for step 0
+  goToStep: { step: number; state: BackendState | null };
+  expandObject: ObjectExpansion;
+  readRange: CellRange;
 };
 
 export type ServerToClientEvent = {
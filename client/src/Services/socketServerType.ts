@@ -1,7 +1,22 @@
+import {
+  AnnotatedRoots,
+  ObjectExpansion,
+  RangeRequest,
+} from '../visualiser-debugger/Types/backendType';
+
 export interface ClientToServerEvents {
   mainDebug: (debugInfo: string) => void;
   executeNext: () => void;
+  stepBack: () => void;
+  goToStep: (step: number) => void;
   send_stdin: (data: any) => void;
   EOF: () => void;
   SIGINT: () => void;
+  saveTrace: (name: string) => void;
+  startLecture: (name: string) => void;
+  joinLecture: (name: string) => void;
+  leaveLecture: (name: string) => void;
+  setAnnotatedRoots: (roots: AnnotatedRoots) => void;
+  expandObject: (request: Omit<ObjectExpansion, 'heap_data'>) => void;
+  readRange: (request: RangeRequest) => void;
 }
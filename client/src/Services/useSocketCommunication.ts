@@ -2,9 +2,11 @@ import { useCallback, useMemo, useState } from 'react';
 import {
   BackendState,
   BackendTypeDeclaration,
+  CellRange,
   FunctionStructure,
   INITIAL_BACKEND_STATE,
   isProgramEnd,
+  ObjectExpansion,
   ProgramEnd,
 } from '../visualiser-debugger/Types/backendType';
 import useSocketClientStore from './socketClient';
@@ -12,15 +14,21 @@ import { ServerToClientEvent } from './socketClientType';
 import { useGlobalStore } from '../visualiser-debugger/Store/globalStateStore';
 import { useUserFsStateStore } from '../visualiser-debugger/Store/userFsStateStore';
 import { useFrontendStateStore } from '../visualiser-debugger/Store/frontendStateStore';
+import { useCellPageStore } from '../visualiser-debugger/Store/cellPageStore';
 import {
   DEFAULT_MESSAGE_DURATION,
   useToastStateStore,
 } from '../visualiser-debugger/Store/toastStateStore';
+import { fetchTrace } from '../visualiser-debugger/Trace/traceLibrary';
+import { INITIAL_GRAPH } from '../visualiser-debugger/Types/frontendType';
+
+// Steps of a lecture from before the viewer joined
+const UNSEEN = { backendState: INITIAL_BACKEND_STATE, frontendState: INITIAL_GRAPH };
 
 export const useSocketCommunication = () => {
   const { updateNextFrame, updateTypeDeclaration, clearTypeDeclarations, clearUserAnnotation } =
     useGlobalStore();
-  const { setActive } = useFrontendStateStore();
+  const { setActive, setOffline } = useFrontendStateStore();
   const { clearFrontendState } = useFrontendStateStore();
 
   const { socketClient } = useSocketClientStore();
@@ -31,8 +39,27 @@ export const useSocketCommunication = () => {
   const { setToastMessage: setMessage } = useToastStateStore();
 
   useMemo(() => {
+    /**
+     * Lecture viewers have no session of their own, so nothing is asked of the server. Their
+     * timeline starts at the lecturer's step with the steps before it blank, so that states stay at
+     * index step - 1 like everywhere else.
+     */
+    const watchFrom = (step: number) => {
+      updateNextFrame(INITIAL_BACKEND_STATE);
+      clearFrontendState();
+      useCellPageStore.getState().clearPages();
+      clearTypeDeclarations();
+      useFrontendStateStore.getState().loadStates(Array(Math.max(step - 1, 0)).fill(UNSEEN));
+      setOffline(true);
+      setActive(true);
+    };
+
     const eventHandler: ServerToClientEvent = {
       mainDebug: (_data: 'Finished mainDebug event on server') => {
+        if (useFrontendStateStore.getState().offline) {
+          // Watching a lecture, whose lecturer ran their code again
+          watchFrom(0);
+        }
         setMessage({
           content: 'Debug session started.',
           colorTheme: 'info',
@@ -62,8 +89,13 @@ export const useSocketCommunication = () => {
       sendStdoutToUser: (output: string) => {
         appendConsoleChunks([...output]);
       },
-      programWaitingForInput: (_data: any) => {
-        // Implement as needed
+      programWaitingForInput: () => {
+        // Only sent once the program is blocked reading stdin
+        setMessage({
+          content: 'Program is waiting for input, type it in the console.',
+          colorTheme: 'info',
+          durationMs: DEFAULT_MESSAGE_DURATION,
+        });
       },
       acknowledgedEOF: () => {
         console.log('Debugger sent acknowledged EOF signal');
@@ -76,6 +108,105 @@ export const useSocketCommunication = () => {
         updateCurrFocusedTab('2');
       },
       send_stdin: (_data: string) => {},
+      saveTrace: (path: string) => {
+        // Keep a copy for offline playback
+        fetchTrace(path)
+          .then(() =>
+            setMessage({
+              content: `Trace saved to ${path}`,
+              colorTheme: 'info',
+              durationMs: DEFAULT_MESSAGE_DURATION,
+            })
+          )
+          .catch((error: Error) =>
+            setMessage({
+              content: error.message,
+              colorTheme: 'error',
+              durationMs: DEFAULT_MESSAGE_DURATION,
+            })
+          );
+      },
+      saveTraceError: (error: string) => {
+        setMessage({
+          content: error,
+          colorTheme: 'error',
+          durationMs: DEFAULT_MESSAGE_DURATION,
+        });
+      },
+      startLecture: (name: string) => {
+        setMessage({
+          content: `Lecture started, students can join with ?lecture=${name}`,
+          colorTheme: 'info',
+          durationMs: DEFAULT_MESSAGE_DURATION,
+        });
+      },
+      joinLecture: ({ name, step }: { name: string; step: number }) => {
+        // States are pushed by the lecturer's session, there is none to step
+        watchFrom(step);
+        setMessage({
+          content: `Joined lecture ${name}.`,
+          colorTheme: 'info',
+          durationMs: DEFAULT_MESSAGE_DURATION,
+        });
+      },
+      lectureClosed: (name: string) => {
+        setMessage({
+          content: `Lecture ${name} ended.`,
+          colorTheme: 'info',
+          durationMs: DEFAULT_MESSAGE_DURATION,
+        });
+      },
+      lectureError: (error: string) => {
+        setMessage({
+          content: error,
+          colorTheme: 'error',
+          durationMs: DEFAULT_MESSAGE_DURATION,
+        });
+      },
+      expandObject: (expansion: ObjectExpansion) => {
+        // Step n is shown at index n - 1, the first state comes after one step
+        const index = expansion.step - 1;
+        const mapped = useFrontendStateStore.getState().states[index];
+        if (!mapped) {
+          return;
+        }
+
+        const stack = { ...mapped.backendState.stack_data };
+        Object.entries(stack).forEach(([name, value]) => {
+          if (value.addr === expansion.addr) {
+            stack[name] = { ...value, truncated: false };
+          }
+        });
+        const backendState: BackendState = {
+          ...mapped.backendState,
+          stack_data: stack,
+          heap_data: { ...mapped.backendState.heap_data, ...expansion.heap_data },
+        };
+        const { parser, userAnnotation } = useGlobalStore.getState().visualizer;
+        useFrontendStateStore
+          .getState()
+          .replaceState(index, backendState, parser.parseState(backendState, userAnnotation));
+      },
+
+      goToStep: ({ step, state }: { step: number; state: BackendState | null }) => {
+        // Pages were read for steps that are gone, and will differ if stepped again
+        useCellPageStore.getState().clearPages();
+        useFrontendStateStore.getState().rewindTo(step);
+        if (state) {
+          // Also fills the step in for viewers that joined after it
+          const { parser, userAnnotation } = useGlobalStore.getState().visualizer;
+          useFrontendStateStore
+            .getState()
+            .replaceState(step - 1, state, parser.parseState(state, userAnnotation));
+        }
+        // Parsed again from here if the annotations change
+        updateNextFrame(state ?? INITIAL_BACKEND_STATE);
+        setActive(true);
+      },
+
+      readRange: (range: CellRange) => {
+        useCellPageStore.getState().receiveRange(range.step, range);
+      },
     };
 
     socketClient.setupEventHandlers(eventHandler);
@@ -84,6 +215,7 @@ export const useSocketCommunication = () => {
   const resetDebugSession = useCallback(() => {
     updateNextFrame(INITIAL_BACKEND_STATE);
     clearFrontendState();
+    useCellPageStore.getState().clearPages();
     setActive(false);
     clearTypeDeclarations();
     clearUserAnnotation();
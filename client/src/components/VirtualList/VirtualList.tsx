@@ -0,0 +1,76 @@
+import React, { ReactNode, useEffect, useState } from 'react';
+
+// Browsers stop growing an element somewhere past 10^7 pixels, longer lists
+// scroll through their rows proportionally instead
+const MAX_SCROLL_HEIGHT = 10_000_000;
+// Rows rendered above and below the visible ones, so fast scrolling does not
+// show blank space before they render
+const OVERSCAN = 5;
+
+/**
+ * A list that only renders the rows in view, for arrays with millions of cells
+ */
+export const VirtualList = ({
+  count,
+  rowHeight,
+  height,
+  renderRow,
+  onVisibleRange,
+  className,
+}: {
+  count: number;
+  rowHeight: number;
+  height: number;
+  renderRow: (index: number) => ReactNode;
+  // Called with [first, last) of the rendered rows whenever they change
+  onVisibleRange?: (first: number, last: number) => void;
+  className?: string;
+}) => {
+  const [scrollTop, setScrollTop] = useState(0);
+
+  const viewHeight = Math.min(height, count * rowHeight);
+  const fullHeight = count * rowHeight;
+  const scrollHeight = Math.min(fullHeight, MAX_SCROLL_HEIGHT);
+  // Offset into the full list of the top of the view
+  const offset =
+    scrollHeight > viewHeight
+      ? (scrollTop * (fullHeight - viewHeight)) / (scrollHeight - viewHeight)
+      : 0;
+
+  const first = Math.max(0, Math.floor(offset / rowHeight) - OVERSCAN);
+  const last = Math.min(count, Math.ceil((offset + viewHeight) / rowHeight) + OVERSCAN);
+
+  useEffect(() => {
+    onVisibleRange?.(first, last);
+  }, [first, last, onVisibleRange]);
+
+  const rows: ReactNode[] = [];
+  for (let i = first; i < last; i += 1) {
+    rows.push(
+      <div
+        key={i}
+        style={{
+          position: 'absolute',
+          top: scrollTop + i * rowHeight - offset,
+          height: rowHeight,
+          left: 0,
+          right: 0,
+        }}
+      >
+        {renderRow(i)}
+      </div>
+    );
+  }
+
+  return (
+    <div
+      className={className}
+      style={{ height: viewHeight, overflowY: 'auto', position: 'relative' }}
+      onScroll={(event: React.UIEvent<HTMLDivElement>) =>
+        setScrollTop(event.currentTarget.scrollTop)
+      }
+    >
+      <div style={{ height: scrollHeight, position: 'relative' }}>{rows}</div>
+    </div>
+  );
+};
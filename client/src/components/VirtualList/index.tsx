@@ -0,0 +1,3 @@
+import { VirtualList } from './VirtualList';
+
+export { VirtualList };
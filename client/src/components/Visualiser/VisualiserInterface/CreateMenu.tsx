@@ -1,9 +1,12 @@
 import { Box, Typography, Button } from '@mui/material';
 import { styled } from '@mui/material/styles';
 import React, { useCallback, useContext } from 'react';
+import { DataStructure } from 'visualiser-src/common/typedefs';
 import VisualiserContext from './VisualiserContext';
 import CreateLink from './CreateLink';
+import LargeSorts from './LargeSorts';
 import Saving from './Saving';
+import SortRace from './SortRace';
 import useGlobalState from '../../../store/globalStore';
 
 const MenuButton = styled(Button)({
@@ -22,7 +25,11 @@ const MenuButton = styled(Button)({
  * Eg. it receives a `handlePlay` callback and attaches it to the Play button's
  *     `onClick` handler.
  */
-const CreateMenu = () => {
+interface CreateMenuProps {
+  topicTitle: string;
+}
+
+const CreateMenu = ({ topicTitle }: CreateMenuProps) => {
   const { controller } = useContext(VisualiserContext);
 
   const handleReset = useCallback(() => {
@@ -54,6 +61,12 @@ const CreateMenu = () => {
           Reset All
         </Typography>
       </MenuButton>
+      {topicTitle.toLowerCase() === DataStructure.SORTING.toLowerCase() && (
+        <>
+          <LargeSorts />
+          <SortRace />
+        </>
+      )}
       {/* TODO: Release this feature */}
       {inDev && (
         <>
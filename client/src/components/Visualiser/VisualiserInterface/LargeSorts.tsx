@@ -0,0 +1,234 @@
+import { useCallback, useEffect, useRef, useState } from 'react';
+import {
+  Box,
+  Button,
+  Checkbox,
+  FormControlLabel,
+  MenuItem,
+  TextField,
+  Typography,
+  useTheme,
+} from '@mui/material';
+import { styled } from '@mui/material/styles';
+import {
+  InputPreset,
+  inputPresets,
+  makeInput,
+  SortAlgorithm,
+  sortAlgorithms,
+} from 'visualiser-src/sorting-visualiser/trace/sortTrace';
+import traceInWorker from 'visualiser-src/sorting-visualiser/trace/traceInWorker';
+import SortBarsRenderer from 'visualiser-src/sorting-visualiser/canvas/SortBarsRenderer';
+import {
+  defaultOpsPerFrame,
+  largeSortMaxSize,
+  maxTraceOps,
+} from 'visualiser-src/sorting-visualiser/util/constants';
+
+const MenuButton = styled(Button)({
+  backgroundColor: '#46B693',
+  '&:hover': {
+    backgroundColor: '#2b6e5a',
+  },
+});
+
+interface Run {
+  // Undefined while the sort is being recorded
+  total?: number;
+  position: number;
+  truncated: boolean;
+}
+
+/**
+ * Sorts inputs far too large to animate element by element, each algorithm side by side. Each
+ * sort is recorded in a worker first, then its trace replayed onto a canvas of bars.
+ */
+const LargeSorts = () => {
+  const theme = useTheme();
+  const [isOpen, setIsOpen] = useState<boolean>(false);
+  const [preset, setPreset] = useState<InputPreset>('random');
+  const [size, setSize] = useState<string>('10000');
+  const [opsPerFrame, setOpsPerFrame] = useState<string>(String(defaultOpsPerFrame));
+  const [selected, setSelected] = useState<SortAlgorithm[]>(['merge', 'quick']);
+  const [runs, setRuns] = useState<Partial<Record<SortAlgorithm, Run>>>({});
+  const [errorMessage, setErrorMessage] = useState<string>('');
+
+  const canvases = useRef<Partial<Record<SortAlgorithm, HTMLCanvasElement | null>>>({});
+  const renderers = useRef<SortBarsRenderer[]>([]);
+  // Which Run click the traces coming back are for, so those of an earlier one are dropped
+  const runId = useRef<number>(0);
+
+  const stop = useCallback(() => {
+    runId.current += 1;
+    renderers.current.forEach((renderer) => renderer.pause());
+    renderers.current = [];
+  }, []);
+
+  useEffect(() => stop, []);
+
+  const getOpsPerFrame = () => Math.max(Number(opsPerFrame) || defaultOpsPerFrame, 1);
+
+  useEffect(() => {
+    renderers.current.forEach((renderer) => {
+      renderer.opsPerFrame = getOpsPerFrame();
+    });
+  }, [opsPerFrame]);
+
+  const toggleAlgorithm = (algorithm: SortAlgorithm) => {
+    setSelected((prev) =>
+      prev.includes(algorithm)
+        ? prev.filter((other) => other !== algorithm)
+        : sortAlgorithms.filter((other) => other === algorithm || prev.includes(other))
+    );
+  };
+
+  const handleRun = () => {
+    const n = Number(size);
+    if (!Number.isInteger(n) || n < 1 || n > largeSortMaxSize) {
+      setErrorMessage(`Size must be between 1 and ${largeSortMaxSize}`);
+      setTimeout(() => setErrorMessage(''), 2000);
+      return;
+    }
+
+    stop();
+    const id = runId.current;
+    const values = makeInput(preset, n);
+    setRuns(
+      Object.fromEntries(
+        selected.map((algorithm) => [algorithm, { position: 0, truncated: false }])
+      )
+    );
+    selected.forEach((algorithm) => {
+      traceInWorker({ algorithm, values, maxOps: maxTraceOps }).then((trace) => {
+        const canvas = canvases.current[algorithm];
+        if (id !== runId.current || !canvas) return;
+        const updateRun = (position: number) =>
+          setRuns((prev) => ({
+            ...prev,
+            [algorithm]: { total: trace.length, position, truncated: trace.truncated },
+          }));
+        const renderer = new SortBarsRenderer(canvas, values, trace, getOpsPerFrame(), updateRun);
+        renderers.current.push(renderer);
+        updateRun(0);
+        renderer.play();
+      });
+    });
+  };
+
+  const handleToggle = () => {
+    if (isOpen) {
+      stop();
+      setRuns({});
+    }
+    setIsOpen(!isOpen);
+  };
+
+  const describe = (run: Run) => {
+    if (run.total === undefined) {
+      return 'Recording...';
+    }
+    const ops = `${run.position} / ${run.total} operations`;
+    return run.truncated ? `${ops}, the rest skipped` : ops;
+  };
+
+  return (
+    <>
+      <MenuButton onClick={handleToggle}>
+        <Typography color="textPrimary" whiteSpace="nowrap">
+          Large Inputs
+        </Typography>
+      </MenuButton>
+      {isOpen && (
+        <Box
+          position="fixed"
+          top="80px"
+          left="10px"
+          right="230px"
+          maxHeight="70vh"
+          overflow="auto"
+          padding="10px"
+          bgcolor={theme.palette.background.default}
+          color={theme.palette.text.primary}
+        >
+          <Box display="flex" flexWrap="wrap" alignItems="center" gap="10px">
+            <TextField
+              select
+              size="small"
+              label="Input"
+              value={preset}
+              onChange={(e) => setPreset(e.target.value as InputPreset)}
+              sx={{ width: '130px' }}
+            >
+              {inputPresets.map((option) => (
+                <MenuItem key={option} value={option}>
+                  {option}
+                </MenuItem>
+              ))}
+            </TextField>
+            <TextField
+              size="small"
+              label="Size"
+              value={size}
+              onChange={(e) => setSize(e.target.value)}
+              sx={{ width: '110px' }}
+            />
+            <TextField
+              size="small"
+              label="Ops per frame"
+              value={opsPerFrame}
+              onChange={(e) => setOpsPerFrame(e.target.value)}
+              sx={{ width: '130px' }}
+            />
+            {sortAlgorithms.map((algorithm) => (
+              <FormControlLabel
+                key={algorithm}
+                label={algorithm}
+                control={
+                  <Checkbox
+                    checked={selected.includes(algorithm)}
+                    onChange={() => toggleAlgorithm(algorithm)}
+                  />
+                }
+              />
+            ))}
+            <Button variant="contained" onClick={handleRun} disabled={selected.length === 0}>
+              Run
+            </Button>
+            <Button
+              variant="contained"
+              onClick={() => renderers.current.forEach((renderer) => renderer.finish())}
+            >
+              Finish
+            </Button>
+            <Typography color="error">{errorMessage}</Typography>
+          </Box>
+          <Box
+            display="grid"
+            gridTemplateColumns="repeat(auto-fill, minmax(400px, 1fr))"
+            gap="10px"
+          >
+            {sortAlgorithms
+              .filter((algorithm) => runs[algorithm])
+              .map((algorithm) => (
+                <Box key={algorithm}>
+                  <Typography>
+                    {algorithm}: {describe(runs[algorithm]!)}
+                  </Typography>
+                  <canvas
+                    ref={(canvas) => {
+                      canvases.current[algorithm] = canvas;
+                    }}
+                    width={800}
+                    height={200}
+                    style={{ width: '100%' }}
+                  />
+                </Box>
+              ))}
+          </Box>
+        </Box>
+      )}
+    </>
+  );
+};
+
+export default LargeSorts;
@@ -0,0 +1,241 @@
+import { useEffect, useRef, useState } from 'react';
+import { Box, Button, MenuItem, TextField, Typography, useTheme } from '@mui/material';
+import { styled } from '@mui/material/styles';
+import {
+  InputPreset,
+  inputPresets,
+  makeInput,
+  SortAlgorithm,
+  sortAlgorithms,
+} from 'visualiser-src/sorting-visualiser/trace/sortTrace';
+import { SortCounts } from 'visualiser-src/sorting-visualiser/trace/SortCounter';
+import countInWorker, { CountingSort } from 'visualiser-src/sorting-visualiser/trace/countInWorker';
+import { drawGrowth, drawRaceBars } from 'visualiser-src/sorting-visualiser/canvas/raceCharts';
+import {
+  raceColours,
+  raceMaxOps,
+  raceMaxSize,
+} from 'visualiser-src/sorting-visualiser/util/constants';
+
+const MenuButton = styled(Button)({
+  backgroundColor: '#46B693',
+  '&:hover': {
+    backgroundColor: '#2b6e5a',
+  },
+});
+
+type Metric = keyof SortCounts;
+
+const metrics: Metric[] = ['comparisons', 'swaps', 'writes', 'time'];
+
+interface RaceResult {
+  algorithm: SortAlgorithm;
+  preset: InputPreset;
+  size: number;
+  counts: SortCounts;
+}
+
+/**
+ * Races every sort on the same input, each in a worker of its own, plotting their operation
+ * counts and wall times as they run. Finished races are kept, so racing again at other sizes
+ * plots how each count grows with the input, and the exponent of that growth. A sort that reaches
+ * raceMaxOps is stopped and left out of the growth plot, being too slow at that size.
+ */
+const SortRace = () => {
+  const theme = useTheme();
+  const [isOpen, setIsOpen] = useState<boolean>(false);
+  const [preset, setPreset] = useState<InputPreset>('random');
+  const [size, setSize] = useState<string>('10000');
+  const [metric, setMetric] = useState<Metric>('comparisons');
+  const [counts, setCounts] = useState<Partial<Record<SortAlgorithm, SortCounts>>>({});
+  const [finished, setFinished] = useState<SortAlgorithm[]>([]);
+  const [cutOff, setCutOff] = useState<SortAlgorithm[]>([]);
+  const [isRacing, setIsRacing] = useState<boolean>(false);
+  const [results, setResults] = useState<RaceResult[]>([]);
+  const [errorMessage, setErrorMessage] = useState<string>('');
+
+  const barsCanvas = useRef<HTMLCanvasElement | null>(null);
+  const growthCanvas = useRef<HTMLCanvasElement | null>(null);
+  const running = useRef<CountingSort[]>([]);
+  // Which race the reports coming back are for, so those of a stopped one are dropped
+  const raceId = useRef<number>(0);
+
+  const stop = () => {
+    raceId.current += 1;
+    running.current.forEach((sort) => sort.cancel());
+    running.current = [];
+  };
+
+  useEffect(() => stop, []);
+
+  useEffect(() => {
+    if (barsCanvas.current) {
+      drawRaceBars(
+        barsCanvas.current,
+        sortAlgorithms.map((algorithm, i) => ({
+          label: algorithm,
+          value: Math.round(counts[algorithm]?.[metric] ?? 0),
+          colour: raceColours[i],
+        })),
+        theme.palette.text.primary
+      );
+    }
+    if (growthCanvas.current) {
+      drawGrowth(
+        growthCanvas.current,
+        sortAlgorithms.map((algorithm, i) => ({
+          label: algorithm,
+          colour: raceColours[i],
+          points: results
+            .filter((result) => result.algorithm === algorithm && result.preset === preset)
+            .sort((x, y) => x.size - y.size)
+            .map((result): [number, number] => [result.size, result.counts[metric]]),
+        })),
+        theme.palette.text.primary
+      );
+    }
+  }, [counts, results, metric, preset, isOpen]);
+
+  const handleRun = () => {
+    const n = Number(size);
+    if (!Number.isInteger(n) || n < 2 || n > raceMaxSize) {
+      setErrorMessage(`Size must be between 2 and ${raceMaxSize}`);
+      setTimeout(() => setErrorMessage(''), 2000);
+      return;
+    }
+
+    stop();
+    const id = raceId.current;
+    const values = makeInput(preset, n);
+    setCounts({});
+    setFinished([]);
+    setCutOff([]);
+    setIsRacing(true);
+    running.current = sortAlgorithms.map((algorithm) => {
+      const sort = countInWorker({ algorithm, values, maxOps: raceMaxOps }, (progress) => {
+        if (id !== raceId.current) return;
+        setCounts((prev) => ({ ...prev, [algorithm]: progress }));
+      });
+      sort.done.then((final) => {
+        if (id !== raceId.current) return;
+        if (final.cutOff) {
+          // Its counts so far say nothing of how it grows
+          setCutOff((prev) => [...prev, algorithm]);
+          return;
+        }
+        setFinished((prev) => [...prev, algorithm]);
+        setResults((prev) => [...prev, { algorithm, preset, size: n, counts: final.counts }]);
+      });
+      return sort;
+    });
+  };
+
+  const handleStop = () => {
+    stop();
+    setIsRacing(false);
+  };
+
+  const handleToggle = () => {
+    if (isOpen) {
+      handleStop();
+    }
+    setIsOpen(!isOpen);
+  };
+
+  const describe = (algorithm: SortAlgorithm) => {
+    if (cutOff.includes(algorithm)) {
+      return `${algorithm} too slow at this n`;
+    }
+    if (finished.includes(algorithm)) {
+      return `${algorithm} done`;
+    }
+    return `${algorithm} ${isRacing ? 'running' : 'stopped'}`;
+  };
+
+  const unit = metric === 'time' ? 'ms' : metric;
+  const status = sortAlgorithms
+    .filter((algorithm) => counts[algorithm])
+    .map(describe)
+    .join(', ');
+
+  return (
+    <>
+      <MenuButton onClick={handleToggle}>
+        <Typography color="textPrimary" whiteSpace="nowrap">
+          Sorting Race
+        </Typography>
+      </MenuButton>
+      {isOpen && (
+        <Box
+          position="fixed"
+          top="80px"
+          left="10px"
+          right="230px"
+          maxHeight="70vh"
+          overflow="auto"
+          padding="10px"
+          bgcolor={theme.palette.background.default}
+          color={theme.palette.text.primary}
+        >
+          <Box display="flex" flexWrap="wrap" alignItems="center" gap="10px">
+            <TextField
+              select
+              size="small"
+              label="Input"
+              value={preset}
+              onChange={(e) => setPreset(e.target.value as InputPreset)}
+              sx={{ width: '130px' }}
+            >
+              {inputPresets.map((option) => (
+                <MenuItem key={option} value={option}>
+                  {option}
+                </MenuItem>
+              ))}
+            </TextField>
+            <TextField
+              size="small"
+              label="Size"
+              value={size}
+              onChange={(e) => setSize(e.target.value)}
+              sx={{ width: '110px' }}
+            />
+            <TextField
+              select
+              size="small"
+              label="Measure"
+              value={metric}
+              onChange={(e) => setMetric(e.target.value as Metric)}
+              sx={{ width: '140px' }}
+            >
+              {metrics.map((option) => (
+                <MenuItem key={option} value={option}>
+                  {option}
+                </MenuItem>
+              ))}
+            </TextField>
+            <Button variant="contained" onClick={handleRun}>
+              Race
+            </Button>
+            <Button variant="contained" onClick={handleStop}>
+              Stop
+            </Button>
+            <Button variant="contained" onClick={() => setResults([])}>
+              Clear
+            </Button>
+            <Typography color="error">{errorMessage}</Typography>
+          </Box>
+          <Typography>
+            {unit}, log scale{status && ` (${status})`}
+          </Typography>
+          <canvas ref={barsCanvas} width={800} height={150} style={{ width: '100%' }} />
+          <Typography>
+            {unit} against input size on {preset} inputs, log-log
+          </Typography>
+          <canvas ref={growthCanvas} width={800} height={250} style={{ width: '100%' }} />
+        </Box>
+      )}
+    </>
+  );
+};
+
+export default SortRace;
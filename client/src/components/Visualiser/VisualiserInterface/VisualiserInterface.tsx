@@ -69,7 +69,7 @@ const VisualiserInterface: FC<VisualiserInterfaceProps> = ({ topicTitle, data })
 
   return (
     <VisualiserContext.Provider value={contextValue}>
-      <CreateMenu />
+      <CreateMenu topicTitle={topicTitle} />
       {/* Operations */}
       {!documentation || (
         <FloatingWindow
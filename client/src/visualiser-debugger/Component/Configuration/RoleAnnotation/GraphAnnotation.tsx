@@ -0,0 +1,220 @@
+import { useEffect, useState } from 'react';
+import * as RadioGroup from '@radix-ui/react-radio-group';
+import styles from 'styles/Configuration.module.css';
+import { AnnotationComponent, AnnotationProp } from './AnnotationComponentBase';
+import {
+  DataStructureType,
+  GraphAnnotation,
+  PossibleGraphAnnotation,
+  PossibleLinkedListAnnotation,
+} from '../../../Types/annotationType';
+import { useGlobalStore } from '../../../Store/globalStateStore';
+import {
+  BackendTypeDeclaration,
+  isNativeTypeName,
+  isPointerType,
+  isStructTypeName,
+} from '../../../Types/backendType';
+import { VisualizerType } from '../../../Types/visualizerType';
+import ConfigurationSelect from '../ConfigurationSelect';
+import { createPossibleLinkedListTypeDecl } from './LinkedListAnnotation';
+
+// The list node struct an adjacency list field is made of, as a linked list annotation
+const findEdgeTypeDecl = (
+  listTypeName: string,
+  typeDeclarations: BackendTypeDeclaration[]
+): PossibleLinkedListAnnotation | null => {
+  const edgeTypeName = listTypeName.slice(0, -2).trim();
+  const edgeDecl = typeDeclarations.find((decl) => decl.typeName === edgeTypeName);
+  return edgeDecl ? createPossibleLinkedListTypeDecl(edgeDecl) : null;
+};
+
+export const createPossibleGraphTypeDecl = (
+  typeDecl: BackendTypeDeclaration,
+  typeDeclarations: BackendTypeDeclaration[]
+): PossibleGraphAnnotation | null => {
+  if (!typeDecl.fields) {
+    return null;
+  }
+  if (!isStructTypeName(typeDecl.typeName)) {
+    return null;
+  }
+
+  const possibleTypeDecl: PossibleGraphAnnotation = {
+    typeName: typeDecl.typeName,
+    possibleCounts: [],
+    possibleLists: [],
+  };
+
+  typeDecl.fields.forEach((field) => {
+    if (field.typeName === 'int') {
+      possibleTypeDecl.possibleCounts.push({
+        name: field.name,
+        typeName: field.typeName,
+      });
+    }
+    if (
+      isPointerType(field.typeName) &&
+      field.typeName.endsWith('**') &&
+      findEdgeTypeDecl(field.typeName, typeDeclarations) !== null
+    ) {
+      possibleTypeDecl.possibleLists.push({
+        name: field.name,
+        typeName: field.typeName,
+      });
+    }
+  });
+
+  if (possibleTypeDecl.possibleCounts.length >= 1 && possibleTypeDecl.possibleLists.length >= 1) {
+    return possibleTypeDecl;
+  }
+
+  return null;
+};
+
+export const GraphStructAnnotation: AnnotationComponent = ({ backendType }: AnnotationProp) => {
+  const { updateUserAnnotation, setVisualizerType, visualizer } = useGlobalStore();
+  const { typeDeclarations } = visualizer;
+  const [possibleTypeDeclForGraph, setPossibleTypeDeclForGraph] =
+    useState<PossibleGraphAnnotation | null>(
+      createPossibleGraphTypeDecl(backendType, typeDeclarations)
+    );
+  const [graphAnnotation, setGraphAnnotation] = useState<GraphAnnotation | null>(null);
+
+  const handleUpdateGraphAnnotation = (newAnnotation: GraphAnnotation) => {
+    setGraphAnnotation(newAnnotation);
+    // Before the annotation, so the change re-parses the frame as a graph
+    setVisualizerType(VisualizerType.GRAPH);
+    const { userAnnotation } = useGlobalStore.getState().visualizer;
+    updateUserAnnotation({
+      stackAnnotation: userAnnotation.stackAnnotation,
+      typeAnnotation: {
+        ...userAnnotation.typeAnnotation,
+        [newAnnotation.typeName]: newAnnotation,
+      },
+    });
+  };
+
+  // The annotation for a choice of adjacency list field, with the first fields of its list nodes
+  const createGraphAnnotation = (
+    vertexCount: GraphAnnotation['vertexCount'],
+    list: PossibleGraphAnnotation['possibleLists'][number]
+  ): GraphAnnotation | null => {
+    const edgeDecl = findEdgeTypeDecl(list.typeName, typeDeclarations);
+    if (edgeDecl === null) return null;
+    return {
+      typeName: backendType.typeName as `struct ${string}`,
+      type: DataStructureType.Graph,
+      vertexCount,
+      adjacencyLists: list,
+      edge: {
+        typeName: edgeDecl.typeName,
+        vertex: edgeDecl.possibleValues[0],
+        next: edgeDecl.possibleNexts[0],
+      },
+    };
+  };
+
+  useEffect(() => {
+    setPossibleTypeDeclForGraph(createPossibleGraphTypeDecl(backendType, typeDeclarations));
+  }, [backendType, typeDeclarations]);
+
+  useEffect(() => {
+    if (possibleTypeDeclForGraph === null) return;
+    const newAnnotation = createGraphAnnotation(
+      possibleTypeDeclForGraph.possibleCounts[0],
+      possibleTypeDeclForGraph.possibleLists[0]
+    );
+    if (newAnnotation) handleUpdateGraphAnnotation(newAnnotation);
+  }, [possibleTypeDeclForGraph]);
+
+  // Back to linked lists once the struct is no longer annotated as a graph
+  useEffect(
+    () => () => {
+      const { userAnnotation } = useGlobalStore.getState().visualizer;
+      const { [backendType.typeName]: _, ...typeAnnotation } = userAnnotation.typeAnnotation;
+      useGlobalStore.getState().setVisualizerType(VisualizerType.LINKED_LIST);
+      useGlobalStore.getState().updateUserAnnotation({
+        stackAnnotation: userAnnotation.stackAnnotation,
+        typeAnnotation,
+      });
+    },
+    []
+  );
+
+  const handleUpdateVertexCount = (newCount: string, newCountType: string) => {
+    if (graphAnnotation && isNativeTypeName(newCountType)) {
+      handleUpdateGraphAnnotation({
+        ...graphAnnotation,
+        vertexCount: { name: newCount, typeName: newCountType },
+      });
+    }
+  };
+
+  const handleUpdateLists = (newLists: string, newListsType: string) => {
+    if (graphAnnotation && isPointerType(newListsType)) {
+      const newAnnotation = createGraphAnnotation(graphAnnotation.vertexCount, {
+        name: newLists,
+        typeName: newListsType,
+      });
+      if (newAnnotation) handleUpdateGraphAnnotation(newAnnotation);
+    }
+  };
+
+  const handleUpdateEdgeVertex = (newVertex: string, newVertexType: string) => {
+    if (graphAnnotation && isNativeTypeName(newVertexType)) {
+      handleUpdateGraphAnnotation({
+        ...graphAnnotation,
+        edge: { ...graphAnnotation.edge, vertex: { name: newVertex, typeName: newVertexType } },
+      });
+    }
+  };
+
+  if (!possibleTypeDeclForGraph) {
+    return (
+      <div className={styles.configuratorField}>
+        <span>
+          <span className={styles.highlightError}>Error:</span> No possible{' '}
+          <span className={styles.highlightLinkedList}>graph</span> annotation can be made.
+        </span>
+      </div>
+    );
+  }
+
+  const edgeDecl = graphAnnotation
+    ? findEdgeTypeDecl(graphAnnotation.adjacencyLists.typeName, typeDeclarations)
+    : null;
+
+  return (
+    <div style={{ paddingTop: '10px', fontSize: '0.8rem' }}>
+      <RadioGroup.Root className={styles.RadioGroupRoot} value="Stub">
+        <div className={styles.configuratorField}>
+          <span>Vertex Count</span>
+          <ConfigurationSelect
+            fields={possibleTypeDeclForGraph.possibleCounts}
+            handleUpdateAnnotation={handleUpdateVertexCount}
+          />
+        </div>
+
+        <div className={styles.configuratorField}>
+          <span>Adjacency Lists</span>
+          <ConfigurationSelect
+            fields={possibleTypeDeclForGraph.possibleLists}
+            handleUpdateAnnotation={handleUpdateLists}
+          />
+        </div>
+
+        {edgeDecl && (
+          <div className={styles.configuratorField}>
+            <span>Edge Vertex</span>
+            <ConfigurationSelect
+              key={edgeDecl.typeName}
+              fields={edgeDecl.possibleValues}
+              handleUpdateAnnotation={handleUpdateEdgeVertex}
+            />
+          </div>
+        )}
+      </RadioGroup.Root>
+    </div>
+  );
+};
@@ -0,0 +1,57 @@
+import { useEffect } from 'react';
+import styles from 'styles/Configuration.module.css';
+import { useGlobalStore } from '../../../Store/globalStateStore';
+import { MemoryValue } from '../../../Types/backendType';
+import ConfigurationSelect from '../ConfigurationSelect';
+
+// Arrays of arrays and arrays of pointers to rows know their shape, flat arrays do not
+export const isFlatArrayType = (typeName: string) =>
+  (typeName.match(/\[/g) ?? []).length + (typeName.match(/\*/g) ?? []).length === 1;
+
+export const MatrixVariableAnnotation = ({
+  name,
+  memoryValue,
+}: {
+  name: string;
+  memoryValue: MemoryValue;
+}) => {
+  const { currFrame, updateStackAnnotation } = useGlobalStore();
+  const flat = isFlatArrayType(memoryValue.typeName);
+  const possibleColumns = Object.entries(currFrame.stack_data)
+    .filter(([other, value]) => other !== name && value.typeName === 'int')
+    .map(([other]) => ({ name: other, typeName: 'int' as const }));
+
+  const handleUpdateColumns = (columns: string | null) => {
+    updateStackAnnotation({
+      [name]: { typeName: memoryValue.typeName, matrix: { columns } },
+    });
+  };
+
+  useEffect(() => {
+    if (flat) handleUpdateColumns(possibleColumns[0]?.name ?? null);
+  }, []);
+
+  if (!flat) return null;
+  if (possibleColumns.length === 0) {
+    return (
+      <div className={styles.configuratorField}>
+        <span>
+          <span className={styles.highlightError}>Error:</span> No int variable holds the length
+          of the rows of this flat array.
+        </span>
+      </div>
+    );
+  }
+
+  return (
+    <div style={{ paddingTop: '10px', fontSize: '0.8rem' }}>
+      <div className={styles.configuratorField}>
+        <span>Row Length</span>
+        <ConfigurationSelect
+          fields={possibleColumns}
+          handleUpdateAnnotation={(columns) => handleUpdateColumns(columns)}
+        />
+      </div>
+    </div>
+  );
+};
@@ -8,7 +8,9 @@ import { MotionCollapse } from './MotionCollapse';
 import './typeAnnotation.css';
 import { StackVariableRole } from '../../Types/annotationType';
 import { MemoryValue, isPointerType } from '../../Types/backendType';
+import { VisualizerType } from '../../Types/visualizerType';
 import { useGlobalStore } from '../../Store/globalStateStore';
+import { MatrixVariableAnnotation } from './RoleAnnotation/MatrixAnnotation';
 
 export type StackVariableAnnotationProp = {
   name: string;
@@ -30,6 +32,7 @@ export const StackVarAnnotation: React.FC<StackVariableAnnotationProp> = ({
     (state) => state.visualizer.userAnnotation.stackAnnotation
   );
   const updateStackAnnotation = useGlobalStore((state) => state.updateStackAnnotation);
+  const setVisualizerType = useGlobalStore((state) => state.setVisualizerType);
 
   // Annotate by default if the variable contains a pointer
   useEffect(() => {
@@ -83,9 +86,19 @@ export const StackVarAnnotation: React.FC<StackVariableAnnotationProp> = ({
                     key={role[0]}
                     type="button"
                     onClick={() => {
+                      // Before the annotation, so the change re-parses the frame with it
+                      if (role[1] === StackVariableRole.Matrix) {
+                        setVisualizerType(VisualizerType.MATRIX);
+                      } else if (selectedRole === StackVariableRole.Matrix) {
+                        setVisualizerType(VisualizerType.LINKED_LIST);
+                      }
                       setSelectedRole(role[1]);
                       if (role[1] === StackVariableRole.LinkedListPointer) {
                         updateStackAnnotation({ [name]: memoryValue.typeName });
+                      } else if (role[1] === StackVariableRole.Matrix) {
+                        updateStackAnnotation({
+                          [name]: { typeName: memoryValue.typeName, matrix: { columns: null } },
+                        });
                       } else {
                         updateStackAnnotation({ [name]: null });
                       }
@@ -130,6 +143,10 @@ export const StackVarAnnotation: React.FC<StackVariableAnnotationProp> = ({
           </div>
         ) : null}
       </MotionCollapse>
+
+      <MotionCollapse isOpen={selectedRole === StackVariableRole.Matrix}>
+        <MatrixVariableAnnotation name={name} memoryValue={memoryValue} />
+      </MotionCollapse>
     </div>
   );
 };
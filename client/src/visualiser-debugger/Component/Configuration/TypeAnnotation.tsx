@@ -9,7 +9,12 @@ import {
   LinkedListNodeAnnotation,
   createPossibleLinkedListTypeDecl,
 } from './RoleAnnotation/LinkedListAnnotation';
+import {
+  GraphStructAnnotation,
+  createPossibleGraphTypeDecl,
+} from './RoleAnnotation/GraphAnnotation';
 import { BackendTypeDeclaration } from '../../Types/backendType';
+import { useGlobalStore } from '../../Store/globalStateStore';
 
 export type TypeAnnotationProp = {
   typeDeclaration: BackendTypeDeclaration;
@@ -21,10 +26,13 @@ export const TypeAnnotation: React.FC<TypeAnnotationProp> = ({
   const { typeName } = typeDeclaration;
   const [selectedRole, setSelectedRole] = useState<BackendTypeRole>(BackendTypeRole.Empty);
   const [isDropdownOpen, setIsDropdownOpen] = useState(false);
+  const { typeDeclarations } = useGlobalStore().visualizer;
 
   useEffect(() => {
     if (createPossibleLinkedListTypeDecl(typeDeclaration) !== null) {
       setSelectedRole(BackendTypeRole.LinkedList);
+    } else if (createPossibleGraphTypeDecl(typeDeclaration, typeDeclarations) !== null) {
+      setSelectedRole(BackendTypeRole.Graph);
     }
   }, []);
 
@@ -99,6 +107,10 @@ export const TypeAnnotation: React.FC<TypeAnnotationProp> = ({
       <MotionCollapse isOpen={selectedRole === BackendTypeRole.LinkedList}>
         <LinkedListNodeAnnotation backendType={typeDeclaration} />
       </MotionCollapse>
+
+      <MotionCollapse isOpen={selectedRole === BackendTypeRole.Graph}>
+        <GraphStructAnnotation backendType={typeDeclaration} />
+      </MotionCollapse>
     </div>
   );
 };
@@ -2,16 +2,20 @@ import styles from 'styles/Timeline.module.css';
 import PlayArrowIcon from '@mui/icons-material/PlayArrow';
 import UndoIcon from '@mui/icons-material/Undo';
 import RedoIcon from '@mui/icons-material/Redo';
+import SaveIcon from '@mui/icons-material/Save';
+import HistoryIcon from '@mui/icons-material/History';
 import CircularProgress from '@mui/material/CircularProgress';
 import { useEffect, useRef, useState } from 'react';
 import { Fade } from '@mui/material';
 import { handleCompileClicked } from 'visualiser-debugger/Store/onboardingStore';
 import { useSocketCommunication } from '../../../Services/useSocketCommunication';
+import useSocketClientStore from '../../../Services/socketClient';
 import { useFrontendStateStore } from '../../Store/frontendStateStore';
 import { Button } from '../../../components/Button';
 import Slider from '../../../components/Timeline/Slider';
 import { useGlobalStore } from '../../Store/globalStateStore';
-import { isInitialBackendState } from '../../Types/backendType';
+import { AnnotatedRoots, isInitialBackendState } from '../../Types/backendType';
+import { DataStructureType } from '../../Types/annotationType';
 import { DEFAULT_MESSAGE_DURATION, useToastStateStore } from '../../Store/toastStateStore';
 
 const BUFFER_THRESHOLD = 30;
@@ -19,8 +23,17 @@ const Controls = () => {
   const { currFrame } = useGlobalStore();
   const { userAnnotation, parser } = useGlobalStore().visualizer;
   const { sendCode, bulkSendNextStates, getNextState } = useSocketCommunication();
-  const { states, currentIndex, stepForward, stepBackward, jumpToState, isActive, setActive } =
-    useFrontendStateStore();
+  const { socketClient } = useSocketClientStore();
+  const {
+    states,
+    currentIndex,
+    stepForward,
+    stepBackward,
+    jumpToState,
+    isActive,
+    setActive,
+    offline,
+  } = useFrontendStateStore();
 
   const [loading, setLoading] = useState<boolean>(false);
   const [bufferMode, setBufferMode] = useState<boolean>(false);
@@ -80,6 +93,27 @@ const Controls = () => {
     }
   }, [bufferMode]);
 
+  useEffect(() => {
+    if (!isActive || offline) {
+      return;
+    }
+    // The debugger follows pointers from these first, big structures are cut short
+    const { stackAnnotation, typeAnnotation } = userAnnotation;
+    const lengths: AnnotatedRoots['lengths'] = {};
+    Object.values(typeAnnotation).forEach((annotation) => {
+      if (annotation.type === DataStructureType.Graph) {
+        lengths[annotation.typeName] = {
+          [annotation.adjacencyLists.name]: annotation.vertexCount.name,
+        };
+      }
+    });
+    socketClient.serverAction.setAnnotatedRoots({
+      variables: Object.keys(stackAnnotation).filter((name) => stackAnnotation[name]),
+      types: Object.keys(typeAnnotation),
+      lengths,
+    });
+  }, [userAnnotation, isActive, offline]);
+
   const [autoNext, setAutoNext] = useState<boolean>(false);
   useEffect(() => {
     if (isInitialBackendState(currFrame)) {
@@ -119,7 +153,11 @@ const Controls = () => {
       >
         Compile
       </Button>
-      <Button disabled={!isActive} onClick={playToggle} className="Onboarding-playButton">
+      <Button
+        disabled={!isActive || offline}
+        onClick={playToggle}
+        className="Onboarding-playButton"
+      >
         {loading ? (
           <Fade in={loading} timeout={500}>
             <CircularProgress size={24} />
@@ -139,7 +177,7 @@ const Controls = () => {
         <UndoIcon />
       </Button>
       <Button
-        disabled={!isActive}
+        disabled={!isActive || (offline && currentIndex === states.length - 1)}
         onClick={async () => {
           if (currentIndex === states.length - 1) {
             setActive(false);
@@ -153,6 +191,31 @@ const Controls = () => {
       >
         <RedoIcon />
       </Button>
+      <Button
+        disabled={!isActive || offline || states.length === 0}
+        onClick={() => {
+          // Take the program back to the step shown, or the last step back one, to run it again
+          // from there, e.g. with other input
+          if (currentIndex === states.length - 1) {
+            socketClient.serverAction.stepBack();
+          } else {
+            socketClient.serverAction.goToStep(currentIndex + 1);
+          }
+        }}
+      >
+        <HistoryIcon />
+      </Button>
+      <Button
+        disabled={!isActive || offline || states.length === 0}
+        onClick={() => {
+          const name = window.prompt('Save the steps so far as a trace named (a-z, 0-9, - and _)');
+          if (name) {
+            socketClient.serverAction.saveTrace(name);
+          }
+        }}
+      >
+        <SaveIcon />
+      </Button>
       <Slider
         max={states.length - 1}
         value={currentIndex}
@@ -25,12 +25,20 @@ const AboutText = () => {
         Some notes while in development:
         <ul>
           <li>
-            Stack inspector is current just a placeholder, doesn&#39;t show actual stack data from
-            the debugger yet.
+            Very large structures are only traced part of the way each step, the stack inspector
+            lists the values that were cut short and can expand them.
           </li>
           <li>
-            If your program reads from stdin (e.g. using scanf, fgets, fgetc etc) you must enter
-            your input into the console before executing the line.
+            Arrays and long strings come with their first 200 cells, the stack inspector fetches
+            the rest as you scroll through them.
+          </li>
+          <li>
+            The stack inspector also lists the heap blocks the visualisation does not show, such as
+            leaked ones, and marks pointers to freed or unmapped memory as dangling or invalid.
+          </li>
+          <li>
+            If your program reads from stdin (e.g. using scanf, fgets, fgetc etc) you will be
+            asked to enter your input into the console when the line reading it is executed.
           </li>
         </ul>
       </p>
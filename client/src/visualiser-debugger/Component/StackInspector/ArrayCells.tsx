@@ -0,0 +1,106 @@
+/**
+ * The cells of an array or long string, fetched a page at a time as they
+ * are scrolled into view
+ */
+import { useCallback } from 'react';
+import useSocketClientStore from 'Services/socketClient';
+import { VirtualList } from 'components/VirtualList';
+import { Addr, MemoryValue } from 'visualiser-debugger/Types/backendType';
+import { PAGE_CELLS, pagesKey, useCellPageStore } from 'visualiser-debugger/Store/cellPageStore';
+import styles from './StackInspector.module.scss';
+
+const ROW_HEIGHT = 24;
+const LIST_HEIGHT = 240;
+
+// Where the cells are: an array is its own address, a string is pointed to
+const cellsAddr = (value: MemoryValue): Addr | undefined => {
+  if (value.typeName.endsWith('*')) {
+    const match = String(value.value).match(/0x[0-9a-fA-F]+/);
+    return match ? (match[0] as Addr) : undefined;
+  }
+  return value.addr;
+};
+
+// The first page came with the state, except for strings
+const firstPage = (value: MemoryValue): unknown[] | undefined => {
+  if (Array.isArray(value.value)) {
+    return value.value;
+  }
+  const { array } = value as { array?: unknown[] };
+  return array;
+};
+
+const formatCell = (cell: unknown) => {
+  if (cell === undefined) {
+    return '…';
+  }
+  if (typeof cell === 'string' && cell.length === 1) {
+    return cell === '\0' ? "'\\0'" : `'${cell}'`;
+  }
+  return typeof cell === 'object' ? JSON.stringify(cell) : String(cell);
+};
+
+const ArrayCells = ({
+  value,
+  step,
+  offline,
+}: {
+  value: MemoryValue;
+  // The step whose state the value belongs to
+  step: number;
+  offline: boolean;
+}) => {
+  const { socketClient } = useSocketClientStore();
+  const addr = cellsAddr(value);
+  const pages = useCellPageStore((state) =>
+    addr ? state.pages[pagesKey(step, addr)] : undefined
+  );
+  const length = value.length ?? 0;
+  const initial = firstPage(value);
+
+  const cell = (index: number) => {
+    const start = index - (index % PAGE_CELLS);
+    const page = start === 0 && initial ? initial : pages?.[start];
+    return page?.[index - start];
+  };
+
+  const fetchVisible = useCallback(
+    (first: number, last: number) => {
+      if (!addr || offline || !value.elementType) {
+        return;
+      }
+      const { requestPage } = useCellPageStore.getState();
+      for (let start = first - (first % PAGE_CELLS); start < last; start += PAGE_CELLS) {
+        const sent = start === 0 && initial;
+        if (!sent && requestPage(step, addr, start)) {
+          socketClient.serverAction.readRange({
+            step,
+            addr,
+            elementType: value.elementType,
+            start,
+            count: Math.min(PAGE_CELLS, length - start),
+          });
+        }
+      }
+    },
+    [addr, offline, value.elementType, step, initial, length, socketClient]
+  );
+
+  return (
+    <VirtualList
+      className={styles.cells}
+      count={length}
+      rowHeight={ROW_HEIGHT}
+      height={LIST_HEIGHT}
+      onVisibleRange={fetchVisible}
+      renderRow={(index) => (
+        <>
+          <span className={styles.index}>[{index}]</span>
+          <span className={styles.cell}>{formatCell(cell(index))}</span>
+        </>
+      )}
+    />
+  );
+};
+
+export default ArrayCells;
@@ -1,16 +1,145 @@
 /**
- * TODO: this is incomplete, horrible code
- * Need huge refactor work
+ * The variables of the current frame and the objects the debugger stopped
+ * tracing at, which can be expanded on request. Arrays and long strings show
+ * their cells, a page at a time. Pointers show what they point to, so a
+ * dangling or wild one stands out.
  */
+import { Fragment } from 'react';
+import useSocketClientStore from 'Services/socketClient';
+import { useFrontendStateStore } from 'visualiser-debugger/Store/frontendStateStore';
+import { isPointerType, MemoryValue } from 'visualiser-debugger/Types/backendType';
+import { Button } from 'components/Button';
+import ArrayCells from './ArrayCells';
 import styles from './StackInspector.module.scss';
 
 const StackInspector = () => {
+  const { socketClient } = useSocketClientStore();
+  const { currentIndex, offline, currState } = useFrontendStateStore();
+  const { backendState } = currState();
+  const {
+    frame_info: frameInfo,
+    stack_data: stack,
+    heap_data: heap,
+    heap_blocks: blocks = {},
+    pointers = {},
+  } = backendState;
+
+  const expand = (value: MemoryValue) => {
+    // The state at index i is the one after step i + 1
+    socketClient.serverAction.expandObject(currentIndex + 1, value.addr, value.typeName);
+  };
+
+  const expandButton = (value: MemoryValue) =>
+    value.truncated ? (
+      <Button disabled={offline} onClick={() => expand(value)}>
+        Expand
+      </Button>
+    ) : null;
+
+  const pointerTag = (value: MemoryValue) => {
+    if (!isPointerType(value.typeName) || typeof value.value !== 'string') return null;
+    // Values of char pointers are followed by the string
+    const tag = pointers[value.value.split(' ')[0]];
+    return tag ? <span className={`${styles.pointer} ${styles[tag] ?? ''}`}>{tag}</span> : null;
+  };
+
+  const cells = (value: MemoryValue) =>
+    value.length !== undefined ? (
+      <dd className={styles.cellsRow}>
+        <ArrayCells value={value} step={currentIndex + 1} offline={offline} />
+      </dd>
+    ) : null;
+
+  const truncatedHeap = Object.values(heap).filter((value) => value.truncated);
+  const heapArrays = Object.values(heap).filter((value) => value.length !== undefined);
+  // Blocks the visualisation does not show, like leaked ones
+  const unshownBlocks = Object.entries(blocks).filter(([addr]) => !(addr in heap));
+
   return (
     <div className={styles.stackInspector}>
-      <div style={{ fontSize: 'small' }}>
-        Note: This is so far just a placeholder, doesn&#39;t show actual stack data from the
-        debugger yet.
-      </div>
+      {frameInfo.function && (
+        <div className={styles.frame}>
+          <div className={styles.frameHeader}>
+            <span className={styles.function}>{frameInfo.function}</span>{' '}
+            <span className={styles.location}>line {frameInfo.line_num}</span>
+          </div>
+          <dl>
+            {Object.entries(stack).map(([name, value]) => (
+              <Fragment key={name}>
+                <dt>
+                  <span className={styles.type}>{value.typeName}</span>
+                  <span className={styles.name}>{name}</span>
+                </dt>
+                <dd>
+                  {pointerTag(value)}
+                  {value.length !== undefined && (
+                    <span className={styles.location}>{value.length} cells</span>
+                  )}
+                  {expandButton(value)}
+                </dd>
+                {cells(value)}
+              </Fragment>
+            ))}
+          </dl>
+        </div>
+      )}
+      {heapArrays.length > 0 && (
+        <div className={styles.frame}>
+          <div className={styles.frameHeader}>Heap arrays</div>
+          <dl>
+            {heapArrays.map((value) => (
+              <Fragment key={value.addr}>
+                <dt>
+                  <span className={styles.type}>{value.typeName}</span>
+                  <span className={styles.name}>{value.addr}</span>
+                </dt>
+                <dd>
+                  <span className={styles.location}>{value.length} cells</span>
+                </dd>
+                {cells(value)}
+              </Fragment>
+            ))}
+          </dl>
+        </div>
+      )}
+      {unshownBlocks.length > 0 && (
+        <div className={styles.frame}>
+          <div className={styles.frameHeader}>
+            Other heap blocks{' '}
+            <span className={styles.location}>
+              {unshownBlocks.length} of {Object.keys(blocks).length} live
+            </span>
+          </div>
+          <dl>
+            {unshownBlocks.map(([addr, size]) => (
+              <Fragment key={addr}>
+                <dt>
+                  <span className={styles.name}>{addr}</span>
+                </dt>
+                <dd>
+                  <span className={styles.location}>{size} bytes</span>
+                </dd>
+              </Fragment>
+            ))}
+          </dl>
+        </div>
+      )}
+      {truncatedHeap.length > 0 && (
+        <div className={styles.frame}>
+          <div className={styles.frameHeader}>Not fully traced</div>
+          <dl>
+            {truncatedHeap.map((value) => (
+              <Fragment key={value.addr}>
+                <dt>
+                  <span className={styles.type}>{value.typeName}</span>
+                  <span className={styles.name}>{value.addr}</span>
+                </dt>
+                <dd>{expandButton(value)}</dd>
+              </Fragment>
+            ))}
+          </dl>
+        </div>
+      )}
     </div>
   );
 };
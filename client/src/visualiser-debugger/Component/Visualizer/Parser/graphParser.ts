@@ -0,0 +1,213 @@
+import { UserAnnotation, DataStructureType, GraphAnnotation } from '../../../Types/annotationType';
+import { Addr, BackendState, MemoryValue } from '../../../Types/backendType';
+import { EntityType } from '../Entities/BaseEntity/baseEntity';
+import { EdgeEntity } from '../Entities/BaseEntity/edgeEntity';
+import { NodeEntity, DEFAULT_NODE_SIZE } from '../Entities/BaseEntity/nodeEntity';
+import { GenericGraph, EntityConcrete } from '../../../Types/frontendType';
+import { Coord } from '../../../Types/geometryType';
+import { useFrontendStateStore } from '../../../Store/frontendStateStore';
+import { HeapIndex, heapIndexOf, objectAt, objectsOfType } from '../../../Store/heapIndex';
+import { assertUnreachable } from '../Util/util';
+import { Parser } from './parser';
+import { LayoutRequest, LayoutResult, layoutFrom, seedPositions } from './util/forceLayout';
+
+type GraphEdge = {
+  from: number;
+  to: number;
+};
+
+type Vertex = {
+  uid: string;
+  label: string;
+};
+
+/**
+ * Parses adjacency list graphs: a struct with a vertex count and a malloced array of list heads,
+ * one per vertex, whose list nodes each lead to another vertex.
+ *
+ * Vertices are laid out by a force simulation in a worker, starting from where they were in the
+ * step before. parseState returns at once with those starting places, and the state is replaced
+ * when the worker is done with it.
+ */
+export class GraphParser implements Parser {
+  // Where each vertex was last laid out, for the first render of the next step
+  private positions: Map<string, Coord> = new Map();
+
+  private worker: Worker | null = null;
+
+  private nextLayoutId = 0;
+
+  // States waiting on the worker, by layout id
+  private pending: Map<number, { backendState: BackendState; graph: GenericGraph }> = new Map();
+
+  private parseGraph(
+    heap: HeapIndex,
+    uid: string,
+    graph: MemoryValue,
+    annotation: GraphAnnotation
+  ): [Vertex[], GraphEdge[]] {
+    // @ts-ignore
+    const count = Number(graph.value[annotation.vertexCount.name].value);
+    // @ts-ignore
+    const lists = objectAt(heap, graph.value[annotation.adjacencyLists.name].value);
+    if (!Number.isInteger(count) || count <= 0 || !lists || !Array.isArray(lists.value)) {
+      return [[], []];
+    }
+
+    // The array's block may fit more heads than there are vertices
+    const heads = (lists.value as unknown as Addr[]).slice(0, count);
+    const vertices: Vertex[] = heads.map((_, v) => ({ uid: `${uid}-${v}`, label: `${v}` }));
+    const edges: GraphEdge[] = [];
+    heads.forEach((head, from) => {
+      const visited = new Set<MemoryValue>();
+      let node = objectAt(heap, head);
+      while (node && !visited.has(node)) {
+        visited.add(node);
+        if (!('typeName' in node) || node.typeName !== annotation.edge.typeName) break;
+        const { value } = node;
+        // @ts-ignore
+        const to = Number(value[annotation.edge.vertex.name].value);
+        if (Number.isInteger(to) && to >= 0 && to < heads.length) {
+          edges.push({ from, to });
+        }
+        // @ts-ignore
+        node = objectAt(heap, value[annotation.edge.next.name].value);
+      }
+    });
+    return [vertices, edges];
+  }
+
+  parseHeapData(
+    backendStructure: BackendState,
+    annotation: UserAnnotation
+  ): [Vertex[], GraphEdge[]] {
+    const vertices: Vertex[] = [];
+    const edges: GraphEdge[] = [];
+    const heap = heapIndexOf(backendStructure);
+
+    Object.entries(annotation.typeAnnotation).forEach(([_, graphAnnotation]) => {
+      switch (graphAnnotation.type) {
+        case DataStructureType.LinkedList:
+        case DataStructureType.BinaryTree: {
+          break;
+        }
+        case DataStructureType.Graph: {
+          objectsOfType(heap, graphAnnotation.typeName).forEach(([uid, heapValue]) => {
+            const offset = vertices.length;
+            const [graphVertices, graphEdges] = this.parseGraph(
+              heap,
+              uid,
+              heapValue,
+              graphAnnotation
+            );
+            vertices.push(...graphVertices);
+            graphEdges.forEach(({ from, to }) => {
+              edges.push({ from: from + offset, to: to + offset });
+            });
+          });
+          break;
+        }
+        default: {
+          assertUnreachable(graphAnnotation);
+        }
+      }
+    });
+    return [vertices, edges];
+  }
+
+  private layoutInWorker(request: LayoutRequest, backendState: BackendState, graph: GenericGraph) {
+    if (this.worker === null) {
+      this.worker = new Worker(new URL('./util/forceLayout.worker.ts', import.meta.url), {
+        type: 'module',
+      });
+      this.worker.onmessage = (event: MessageEvent<LayoutResult>) => this.onLayout(event.data);
+    }
+    this.pending.set(request.id, { backendState, graph });
+    this.worker.postMessage(request);
+  }
+
+  private onLayout({ id, x, y }: LayoutResult) {
+    const waiting = this.pending.get(id);
+    if (!waiting) return;
+    this.pending.delete(id);
+
+    const { backendState, graph } = waiting;
+    const moved = this.withPositions(graph, x, y);
+    const store = useFrontendStateStore.getState();
+    const index = store.states.findIndex((state) => state.backendState === backendState);
+    store.replaceState(index, backendState, moved);
+  }
+
+  // The graph with its vertices, in order, moved to (x, y)
+  private withPositions(graph: GenericGraph, x: Float64Array, y: Float64Array): GenericGraph {
+    const cacheEntity: { [uid: string]: EntityConcrete } = { ...graph.cacheEntity };
+    const nodes = graph.nodes.map((node, i) => {
+      const movedNode: NodeEntity = { ...node, x: x[i], y: y[i] };
+      cacheEntity[node.uid] = movedNode;
+      this.positions.set(node.uid, { x: x[i], y: y[i] });
+      return movedNode;
+    });
+    return { nodes, edges: graph.edges, cacheEntity };
+  }
+
+  /**
+   * Parser functionality
+   */
+  parseState(backendStructure: BackendState, annotation: UserAnnotation): GenericGraph {
+    const [vertices, graphEdges] = this.parseHeapData(backendStructure, annotation);
+    const nodes: NodeEntity[] = [];
+    const edges: EdgeEntity[] = [];
+    const cacheEntity: { [uid: string]: EntityConcrete } = {};
+
+    vertices.forEach((vertex) => {
+      const nodeEntity: NodeEntity = {
+        uid: vertex.uid,
+        type: EntityType.NODE,
+        label: vertex.label,
+        colorHex: '#FFFFFF',
+        size: DEFAULT_NODE_SIZE,
+        edgeUids: [],
+        x: 0,
+        y: 0,
+      };
+      nodes.push(nodeEntity);
+      cacheEntity[vertex.uid] = nodeEntity;
+    });
+
+    graphEdges.forEach(({ from, to }) => {
+      const uid = `${vertices[from].uid}-${vertices[to].uid}`;
+      if (cacheEntity[uid]) return;
+      const edgeEntity: EdgeEntity = {
+        uid,
+        type: EntityType.EDGE,
+        fromNodeUid: vertices[from].uid,
+        toNodeUid: vertices[to].uid,
+        label: '',
+        colorHex: '#FFFFFF',
+      };
+      edges.push(edgeEntity);
+      cacheEntity[uid] = edgeEntity;
+      nodes[from].edgeUids.push(uid);
+    });
+
+    const request: LayoutRequest = {
+      id: this.nextLayoutId,
+      uids: vertices.map((vertex) => vertex.uid),
+      edges: Int32Array.from(graphEdges.flatMap(({ from, to }) => [from, to])),
+    };
+    this.nextLayoutId += 1;
+
+    if (typeof Worker === 'undefined') {
+      const { x, y } = layoutFrom(this.positions, request);
+      return this.withPositions({ nodes, edges, cacheEntity }, x, y);
+    }
+
+    // Drawn where the vertices were until the worker has settled them
+    const x = new Float64Array(vertices.length);
+    const y = new Float64Array(vertices.length);
+    seedPositions(this.positions, request.uids, request.edges, x, y);
+    const graph = this.withPositions({ nodes, edges, cacheEntity }, x, y);
+    this.layoutInWorker(request, backendStructure, graph);
+    return graph;
+  }
+}
@@ -1,4 +1,8 @@
-import { UserAnnotation, DataStructureType, isLinkedListNode } from '../../../Types/annotationType';
+import {
+  UserAnnotation,
+  DataStructureType,
+  isMatrixVariable,
+} from '../../../Types/annotationType';
 import { Addr, BackendState } from '../../../Types/backendType';
 import { EntityType } from '../Entities/BaseEntity/baseEntity';
 import { EdgeEntity } from '../Entities/BaseEntity/edgeEntity';
@@ -6,8 +10,15 @@ import { NodeEntity, DEFAULT_NODE_SIZE } from '../Entities/BaseEntity/nodeEntity
 import { PointerEntity } from '../Entities/BaseEntity/pointerEntity';
 import { FrontendLinkedListGraph, EntityConcrete } from '../../../Types/frontendType';
 import { assertUnreachable } from '../Util/util';
+import {
+  HeapIndex,
+  heapIndexOf,
+  objectAt,
+  objectsOfType,
+  pointersTo,
+} from '../../../Store/heapIndex';
 import { Parser } from './parser';
-import { UnionFind } from './util/unionFind';
+import { adjacency, components, indexIds, layeredBands, rootedForest } from './util/layoutCore';
 
 type LinkedListNode = {
   uid: Addr;
@@ -16,174 +27,95 @@ type LinkedListNode = {
 };
 
 const LINKED_LIST_GAP = 200;
+// Each list, or set of lists sharing a tail, gets a band this high, this far below the last
+const LINKED_LIST_BAND = 900;
+const LINKED_LIST_BAND_GAP = 600;
 export class LinkedListParser implements Parser {
-  private convertToRootedTree(
-    linkedList: LinkedListNode[]
-  ): [LinkedListNode, Map<Addr, LinkedListNode[]>] {
-    let root: LinkedListNode = null!;
-    const prevNodeMap: Map<Addr, LinkedListNode[]> = new Map();
+  /**
+   * Lists run left to right into their tail, every node a gap left of its next. Nodes sharing a
+   * next split its share of the band between them.
+   */
+  private assignPositions(linkedList: LinkedListNode[]): Map<Addr, { x: number; y: number }> {
+    const ids = indexIds(linkedList.map((node) => node.uid));
+    const edges: number[] = [];
+    const tails: number[] = [];
     linkedList.forEach((node) => {
-      if (node.next !== '0x0') {
-        if (!prevNodeMap.has(node.next)) {
-          prevNodeMap.set(node.next, []);
-        }
-        prevNodeMap.get(node.next)!.push(node);
+      const next = ids.get(node.next);
+      if (next === undefined) {
+        tails.push(ids.get(node.uid)!);
       } else {
-        root = node;
+        edges.push(ids.get(node.uid)!, next);
       }
     });
-
-    linkedList.forEach((node) => {
-      if (node.next === '0x0') {
-        // @ts-ignore
-        node.next = null;
-      }
+    const edgeArray = Int32Array.from(edges);
+
+    // From each tail back along the nexts that lead to it, a cycle starting from any node on it
+    const n = ids.size;
+    const forest = rootedForest(n, adjacency(n, edgeArray, true), tails);
+    const { component } = components(n, edgeArray);
+    const band = layeredBands(forest);
+    const maxDepth = new Int32Array(forest.roots.length);
+    forest.depth.forEach((depth, i) => {
+      maxDepth[forest.tree[i]] = Math.max(maxDepth[forest.tree[i]], depth);
     });
 
-    const stack: LinkedListNode[] = [root];
-    while (stack.length > 0) {
-      const node = stack.pop()!;
-      if (prevNodeMap.has(node.uid)) {
-        const prevNodes = prevNodeMap.get(node.uid)!;
-        prevNodes.forEach((prevNode) => {
-          prevNode.next = node.uid; // Point the previous nodes to the current node
-          stack.push(prevNode);
-        });
-      }
-    }
-
-    return [root, prevNodeMap];
-  }
-
-  // Recursion algorithm
-  private assignPositionsRecursion(
-    currNode: LinkedListNode,
-    prevNodeMap: Map<Addr, LinkedListNode[]>,
-    cacheLinkedListNode: Map<Addr, LinkedListNode>,
-    posCache: Map<Addr, { x: number; y: number }>,
-    x: number,
-    yRange: [number, number]
-  ): {
-    x: number;
-    y: number;
-  } {
-    const prevNodes = prevNodeMap.get(currNode.uid);
-    // Base case: The currNode is the last node
-    if (!prevNodes) {
-      const currNodePosition = { x, y: (yRange[0] + 100) / 2 };
-      posCache.set(currNode.uid, currNodePosition);
-      return currNodePosition;
-    }
-
-    // Recursive case
-    const yRangePerNode = (yRange[1] - yRange[0]) / prevNodes.length;
-    let currY = yRange[0];
-    const positions: {
-      x: number;
-      y: number;
-    }[] = [];
-    prevNodes.forEach((prevNode) => {
-      positions.push(
-        this.assignPositionsRecursion(
-          prevNode,
-          prevNodeMap,
-          cacheLinkedListNode,
-          posCache,
-          x - LINKED_LIST_GAP,
-          [currY, currY + yRangePerNode]
-        )
-      );
-      currY += yRangePerNode;
-    });
-
-    // Choose the middle y value
-    const y = positions.reduce((a, b) => a + b.y, 0) / positions.length;
-    const currNodePosition = { x, y };
-    posCache.set(currNode.uid, currNodePosition);
-    return currNodePosition;
-  }
-
-  // TODO: Rewrite
-  private assignPositions(
-    currNode: LinkedListNode,
-    prevNodeMap: Map<Addr, LinkedListNode[]>,
-    cacheLinkedListNode: Map<Addr, LinkedListNode>,
-    horizontalDepth: number,
-    initialYRange: [number, number]
-  ): Map<Addr, { x: number; y: number }> {
-    const posCache: Map<Addr, { x: number; y: number }> = new Map();
-    this.assignPositionsRecursion(
-      currNode,
-      prevNodeMap,
-      cacheLinkedListNode,
-      posCache,
-      horizontalDepth * LINKED_LIST_GAP,
-      initialYRange
-    );
-    return posCache;
-  }
-
-  private findMaxDepth(
-    cacheLinkedListNode: Map<Addr, LinkedListNode[]>,
-    linkedList: LinkedListNode[]
-  ): number {
-    // Reverase cache linkedList as we want trakck back
-    const cacheLinkedListNodeReverse: Map<Addr, LinkedListNode[]> = new Map();
-    cacheLinkedListNode.forEach((nodes) => {
-      nodes.forEach((node) => {
-        if (!cacheLinkedListNodeReverse.has(node.uid)) {
-          cacheLinkedListNodeReverse.set(node.uid, []);
-        }
-        cacheLinkedListNodeReverse.get(node.uid)!.push(node);
+    const positions: Map<Addr, { x: number; y: number }> = new Map();
+    ids.forEach((i, uid) => {
+      positions.set(uid as Addr, {
+        x: (maxDepth[forest.tree[i]] + 2 - forest.depth[i]) * LINKED_LIST_GAP,
+        y: LINKED_LIST_BAND_GAP * component[i] + LINKED_LIST_BAND * band[i],
       });
     });
+    return positions;
+  }
 
-    // Utility function for DFS traversal
-    function dfs(node: LinkedListNode | null, visited: Set<Addr>): number {
-      if (!node) return 0; // base case: end of linked list
-      if (visited.has(node.uid)) return 0; // loop detected, end traversal
-
-      visited.add(node.uid);
-
-      const nextNodes = cacheLinkedListNodeReverse.get(node.next);
-      if (!nextNodes) return 1;
-
-      let maxDepth = 0;
-      nextNodes.forEach((nextNode: LinkedListNode) => {
-        maxDepth = Math.max(maxDepth, dfs(nextNode, new Set(visited)));
+  /**
+   * The nodes no other node of their type points to, which start their lists. A list held by a
+   * struct, or by a variable left unannotated, has no stack pointer to show where it starts.
+   */
+  private heads(heap: HeapIndex, annotation: UserAnnotation): Addr[] {
+    const heads: Addr[] = [];
+    Object.values(annotation.typeAnnotation).forEach((linkedListAnnotation) => {
+      if (linkedListAnnotation.type !== DataStructureType.LinkedList) return;
+      const { typeName } = linkedListAnnotation;
+      objectsOfType(heap, typeName).forEach(([uid]) => {
+        const fromNode = pointersTo(heap, uid).some((from) => {
+          const object = objectAt(heap, from);
+          return (
+            from !== uid &&
+            object !== undefined &&
+            'typeName' in object &&
+            object.typeName === typeName
+          );
+        });
+        if (!fromNode) heads.push(uid);
       });
-      return 1 + maxDepth;
-    }
-
-    let maximumDepth = 0;
-    linkedList.forEach((node) => {
-      maximumDepth = Math.max(maximumDepth, dfs(node, new Set()));
     });
-    return maximumDepth + 1;
+    return heads;
   }
 
   parseHeapData(backendStructure: BackendState, annotation: UserAnnotation): LinkedListNode[] {
     // Later need to add an additional step to parse user defined struct into generic struct
     const linkedList: LinkedListNode[] = [];
+    const heap = heapIndexOf(backendStructure);
 
     // === Get all linked list nodes from backend heap data
     Object.entries(annotation.typeAnnotation).forEach(([_, linkedListAnnotation]) => {
       switch (linkedListAnnotation.type) {
-        case DataStructureType.BinaryTree: {
+        case DataStructureType.BinaryTree:
+        case DataStructureType.Graph: {
           break;
         }
         case DataStructureType.LinkedList: {
-          Object.entries(backendStructure.heap_data).forEach(([uid, heapValue]) => {
-            if (isLinkedListNode(heapValue, linkedListAnnotation)) {
-              const linkedListNode: LinkedListNode = {
-                uid: uid as Addr,
-                // @ts-ignore
-                data: heapValue.value[linkedListAnnotation.value.name].value,
-                // @ts-ignore
-                next: heapValue.value[linkedListAnnotation.next.name].value,
-              };
-              linkedList.push(linkedListNode);
-            }
+          objectsOfType(heap, linkedListAnnotation.typeName).forEach(([uid, heapValue]) => {
+            const linkedListNode: LinkedListNode = {
+              uid,
+              // @ts-ignore
+              data: heapValue.value[linkedListAnnotation.value.name].value,
+              // @ts-ignore
+              next: heapValue.value[linkedListAnnotation.next.name].value,
+            };
+            linkedList.push(linkedListNode);
           });
           break;
         }
@@ -212,60 +144,8 @@ export class LinkedListParser implements Parser {
       cacheLinkedListNode.set(node.uid, node);
     });
 
-    const unionNodes = new Set<string>();
-    linkedList.forEach((node) => {
-      unionNodes.add(node.uid);
-      if (node.next !== '0x0') {
-        unionNodes.add(node.next);
-      }
-    });
-    const unionFind = new UnionFind(unionNodes);
-
-    // Combine
-    linkedList.forEach((node) => {
-      if (node.next !== '0x0') {
-        unionFind.union(node.uid, node.next);
-      }
-    });
-
-    const nodesPosition: Map<
-      Addr,
-      {
-        x: number;
-        y: number;
-      }
-    > = new Map();
     try {
-      const groups = unionFind.getGroups();
-      let idx = 0;
-
-      groups.forEach((group) => {
-        const linkedListGroupNodes: LinkedListNode[] = [];
-        group.forEach((uid) => {
-          const node = cacheLinkedListNode.get(uid as Addr);
-          if (node) linkedListGroupNodes.push(node);
-        });
-
-        if (linkedListGroupNodes.length === 0) {
-          return;
-        }
-
-        const [rootedTree, prevNodeMap] = this.convertToRootedTree(linkedListGroupNodes);
-        const maxDepth = this.findMaxDepth(prevNodeMap, linkedListGroupNodes);
-        const positions = this.assignPositions(
-          rootedTree,
-          prevNodeMap,
-          cacheLinkedListNode,
-          maxDepth,
-          [600 * idx, 900 + 600 * idx]
-        );
-
-        positions.forEach((pos, uid) => {
-          nodesPosition.set(uid, pos);
-        });
-
-        idx += 1;
-      });
+      const nodesPosition = this.assignPositions(linkedList);
 
       cacheLinkedListNode.forEach((node, uid) => {
         // Create NodeEntity from LinkedListNode
@@ -276,10 +156,8 @@ export class LinkedListParser implements Parser {
           colorHex: '#FFFFFF',
           size: DEFAULT_NODE_SIZE,
           edgeUids: [],
-          // @ts-ignore
-          x: nodesPosition.get(uid).x,
-          // @ts-ignore
-          y: nodesPosition.get(uid).y,
+          x: nodesPosition.get(uid)!.x,
+          y: nodesPosition.get(uid)!.y,
         };
         nodes.push(nodeEntity);
         cacheEntity[uid] = nodeEntity;
@@ -311,6 +189,7 @@ export class LinkedListParser implements Parser {
         if (stackAnnotation === undefined) return;
         if (!stackAnnotation[name]) return;
         if (stackAnnotation[name] === undefined || stackAnnotation[name] === null) return;
+        if (isMatrixVariable(stackAnnotation[name])) return;
 
         const prevPointer = pointers.find(
           (pointer) => pointer.attachedUid === cacheEntity[memoryValue.value as string].uid
@@ -331,6 +210,22 @@ export class LinkedListParser implements Parser {
         cacheEntity[annotationEntity.uid] = annotationEntity;
       });
 
+      // === Point out the heads no stack variable points to
+      this.heads(heapIndexOf(backendStructure), annotation).forEach((uid) => {
+        if (!cacheEntity[uid]) return;
+        if (pointers.some((pointer) => pointer.attachedUid === uid)) return;
+
+        const headEntity: PointerEntity = {
+          uid: `head-${uid}`,
+          type: EntityType.POINTER,
+          attachedUid: uid,
+          colorHex: '#FFFFFF',
+          label: 'head',
+        };
+        pointers.push(headEntity);
+        cacheEntity[headEntity.uid] = headEntity;
+      });
+
       return {
         nodes,
         edges,
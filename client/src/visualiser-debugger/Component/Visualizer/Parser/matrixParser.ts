@@ -0,0 +1,45 @@
+import { UserAnnotation, isMatrixVariable } from '../../../Types/annotationType';
+import { BackendState } from '../../../Types/backendType';
+import { FrontendMatrixState, Matrix } from '../../../Types/frontendType';
+import { heapIndexOf } from '../../../Store/heapIndex';
+import { Parser } from './parser';
+import { decodeMatrix, markChanges } from './util/matrix';
+
+/**
+ * Parses the stack variables annotated as matrices into grids of numbers, marking the cells that
+ * changed since the frame parsed before. Matrices are drawn on a canvas rather than as entities,
+ * so the graph part of the state is empty.
+ */
+export class MatrixParser implements Parser {
+  // The matrices of the last frame parsed, and of the one before it, by variable
+  private last: Map<string, Matrix> = new Map();
+
+  private beforeLast: Map<string, Matrix> = new Map();
+
+  private lastState: BackendState | null = null;
+
+  parseState(backendStructure: BackendState, annotation: UserAnnotation): FrontendMatrixState {
+    // Parsing a frame again, when the annotation changes, compares it with the same frame as before
+    if (backendStructure !== this.lastState) {
+      this.beforeLast = this.last;
+    }
+
+    const matrices: Matrix[] = [];
+    const stack = backendStructure.stack_data;
+    const heap = heapIndexOf(backendStructure);
+    Object.entries(annotation.stackAnnotation).forEach(([name, variableAnnotation]) => {
+      if (!isMatrixVariable(variableAnnotation) || !stack[name]) return;
+      const { columns } = variableAnnotation.matrix;
+      const rowLength = columns !== null ? Number(stack[columns]?.value) : null;
+      const matrix = decodeMatrix(name, stack[name], heap, rowLength);
+      if (matrix) {
+        markChanges(matrix, this.beforeLast.get(name));
+        matrices.push(matrix);
+      }
+    });
+
+    this.last = new Map(matrices.map((matrix) => [matrix.uid, matrix]));
+    this.lastState = backendStructure;
+    return { nodes: [], edges: [], cacheEntity: {}, matrices };
+  }
+}
@@ -1,6 +1,8 @@
 import { VisualizerType } from '../../../Types/visualizerType';
 // import { assertUnreachable } from '../Util/util';
+import { GraphParser } from './graphParser';
 import { LinkedListParser } from './linkedListParser';
+import { MatrixParser } from './matrixParser';
 import { Parser } from './parser';
 
 export function parserFactory(visualizerType: VisualizerType): Parser {
@@ -8,8 +10,13 @@ export function parserFactory(visualizerType: VisualizerType): Parser {
     case VisualizerType.LINKED_LIST: {
       return new LinkedListParser();
     }
+    case VisualizerType.GRAPH: {
+      return new GraphParser();
+    }
+    case VisualizerType.MATRIX: {
+      return new MatrixParser();
+    }
     case VisualizerType.BINARY_TREE:
-    case VisualizerType.GRAPH:
     case VisualizerType.ARRAY: {
       throw new Error('Not implemented');
     }
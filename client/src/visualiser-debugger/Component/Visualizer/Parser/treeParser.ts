@@ -1,12 +1,13 @@
-import { GlobalStateStore, useGlobalStore } from '../../../Store/globalStateStore';
-import { UserAnnotation, DataStructureType, isTreeNode } from '../../../Types/annotationType';
+import { UserAnnotation, DataStructureType } from '../../../Types/annotationType';
 import { Addr, BackendState } from '../../../Types/backendType';
 import { EntityType } from '../Entities/BaseEntity/baseEntity';
 import { EdgeEntity } from '../Entities/BaseEntity/edgeEntity';
 import { NodeEntity, DEFAULT_NODE_SIZE } from '../Entities/BaseEntity/nodeEntity';
 import { FrontendTreeGraph, EntityConcrete } from '../../../Types/frontendType';
 import { assertUnreachable } from '../Util/util';
+import { heapIndexOf, objectsOfType } from '../../../Store/heapIndex';
 import { Parser } from './parser';
+import { adjacency, indexIds, rootedForest, tidyTree } from './util/layoutCore';
 
 type TreeNode = {
   uid: Addr;
@@ -17,132 +18,61 @@ type TreeNode = {
 const TREE_GAP = 140;
 
 export class TreeParser implements Parser {
-  private assignPositionsRecursion(
-    currNode: TreeNode | null,
-    posCache: Map<Addr, { x: number; y: number }>,
-    nodeCache: Map<Addr, TreeNode>,
-    leftBoundary: number,
-    rightBoundary: number,
-    y: number
-  ): {
-    leftBoundary: number;
-    rightBoundary: number;
-    y: number;
-  } | null {
-    if (!currNode) return null;
-    let leftBoundaryRet = leftBoundary;
-    let rightBoundaryRet = leftBoundary;
-
-    let leftRange: { leftBoundary: number; rightBoundary: number; y: number } | null = null;
-    let rightRange: { leftBoundary: number; rightBoundary: number; y: number } | null = null;
-
-    if (currNode.left) {
-      const leftNode = nodeCache.get(currNode.left);
-      if (leftNode) {
-        leftRange = this.assignPositionsRecursion(
-          leftNode,
-          posCache,
-          nodeCache,
-          leftBoundary,
-          rightBoundary,
-          y + TREE_GAP * 1.4
-        );
-      }
-    }
-
-    // If there'e range in the left, we need to assign the current node on the right side of range
-    if (leftRange) {
-      posCache.set(currNode.uid, { x: leftRange.rightBoundary + TREE_GAP / 2, y });
-      leftBoundaryRet = leftRange.rightBoundary + TREE_GAP / 2;
-    } // We put the current node on the left boundry
-    else {
-      posCache.set(currNode.uid, { x: leftBoundary + TREE_GAP / 2, y });
-      leftBoundaryRet += TREE_GAP / 2;
-    }
-
-    if (currNode.right) {
-      const rightNode = nodeCache.get(currNode.right);
-      if (rightNode) {
-        rightRange = this.assignPositionsRecursion(
-          rightNode,
-          posCache,
-          nodeCache,
-          leftBoundary,
-          rightBoundary,
-          y + TREE_GAP * 1.4
-        );
-      }
-    }
-
-    // Now we merge range
-    leftBoundaryRet = posCache.get(currNode.uid)!.x - TREE_GAP / 2;
-    rightBoundaryRet = posCache.get(currNode.uid)!.x + TREE_GAP / 2;
-    if (leftRange) {
-      leftBoundaryRet = Math.min(leftRange.leftBoundary, leftBoundaryRet);
-      rightBoundaryRet = Math.max(leftRange.rightBoundary, rightBoundaryRet);
-    }
-    if (rightRange) {
-      leftBoundaryRet = Math.min(rightRange.leftBoundary, leftBoundaryRet);
-      rightBoundaryRet = Math.max(rightRange.rightBoundary, rightBoundaryRet);
-    }
-    // Pick the middle reassign currNode
-    if (currNode.left && currNode.right) {
-      const posLeft = posCache.get(currNode.left);
-      const posRight = posCache.get(currNode.right);
-
-      // TODO: could posLeft or posRight be null?
-      // @ts-ignore
-      posCache.set(currNode.uid, { x: (posLeft.x + posRight.x) / 2, y });
-    }
+  // Leaves a tree gap apart in the order they are reached, left before right, and each node
+  // centred over its children
+  private assignPositions(treeNodes: TreeNode[]): Map<Addr, { x: number; y: number }> {
+    const ids = indexIds(treeNodes.map((node) => node.uid));
+    const n = ids.size;
+    const edges: number[] = [];
+    const hasParent = new Uint8Array(n);
+    treeNodes.forEach((node) => {
+      [node.left, node.right].forEach((child) => {
+        const to = child ? ids.get(child) : undefined;
+        if (to !== undefined) {
+          edges.push(ids.get(node.uid)!, to);
+          hasParent[to] = 1;
+        }
+      });
+    });
 
-    return {
-      leftBoundary: leftBoundaryRet,
-      rightBoundary: rightBoundaryRet,
-      y,
-    };
-  }
+    const roots = [...ids.values()].filter((id) => !hasParent[id]);
+    const forest = rootedForest(n, adjacency(n, Int32Array.from(edges)), roots);
+    const slots = tidyTree(forest);
 
-  private assignPositions(
-    rootNode: TreeNode,
-    treeNodes: Map<Addr, TreeNode>,
-    globalState: GlobalStateStore
-  ): Map<Addr, { x: number; y: number }> {
     const posCache: Map<Addr, { x: number; y: number }> = new Map();
-    this.assignPositionsRecursion(
-      rootNode,
-      posCache,
-      treeNodes,
-      0,
-      globalState.uiState.visualizerDimension.width,
-      100
-    );
+    ids.forEach((id, uid) => {
+      posCache.set(uid as Addr, {
+        x: slots[id] * TREE_GAP + TREE_GAP / 2,
+        y: 100 + forest.depth[id] * TREE_GAP * 1.4,
+      });
+    });
     return posCache;
   }
 
   parseHeapData(backendStructure: BackendState, annotation: UserAnnotation): TreeNode[] {
     // Later need to add an additional step to parse user defined struct into generic struct
     const treeNodes: TreeNode[] = [];
+    const heap = heapIndexOf(backendStructure);
 
     // === Get all linked list nodes from backend heap data
     Object.entries(annotation.typeAnnotation).forEach(([_, binaryAnnotation]) => {
       switch (binaryAnnotation.type) {
         case DataStructureType.BinaryTree: {
-          Object.entries(backendStructure.heap_data).forEach(([uid, memoryValue]) => {
-            if (isTreeNode(memoryValue, binaryAnnotation)) {
-              treeNodes.push({
-                uid: uid as Addr,
-                // @ts-ignore
-                data: memoryValue[binaryAnnotation.value.name].value,
-                // @ts-ignore
-                left: memoryValue[binaryAnnotation.left.name].value,
-                // @ts-ignore
-                right: memoryValue[binaryAnnotation.right.name].value,
-              });
-            }
+          objectsOfType(heap, binaryAnnotation.typeName).forEach(([uid, memoryValue]) => {
+            treeNodes.push({
+              uid,
+              // @ts-ignore
+              data: memoryValue[binaryAnnotation.value.name].value,
+              // @ts-ignore
+              left: memoryValue[binaryAnnotation.left.name].value,
+              // @ts-ignore
+              right: memoryValue[binaryAnnotation.right.name].value,
+            });
           });
           break;
         }
-        case DataStructureType.LinkedList: {
+        case DataStructureType.LinkedList:
+        case DataStructureType.Graph: {
           break;
         }
         default: {
@@ -168,15 +98,9 @@ export class TreeParser implements Parser {
     const nodes: NodeEntity[] = [];
     const edges: EdgeEntity[] = [];
     const cacheEntity: { [uid: string]: EntityConcrete } = {};
-    const uiState = useGlobalStore.getState();
 
     const treeNodes: TreeNode[] = this.parseHeapData(backendStructure, editorAnnotation);
 
-    const treeNodesMap: Map<Addr, TreeNode> = new Map();
-    treeNodes.forEach((node) => {
-      treeNodesMap.set(node.uid, node);
-    });
-
     if (treeNodes.length === 0) {
       return {
         nodes,
@@ -186,8 +110,7 @@ export class TreeParser implements Parser {
       };
     }
 
-    const rootNode = treeNodes[0];
-    const positions = this.assignPositions(rootNode, treeNodesMap, uiState);
+    const positions = this.assignPositions(treeNodes);
     treeNodes.forEach((node) => {
       const nodeEntity: NodeEntity = {
         uid: node.uid,
@@ -196,11 +119,8 @@ export class TreeParser implements Parser {
         colorHex: '#FFFFFF',
         size: DEFAULT_NODE_SIZE,
         edgeUids: [],
-        // TODO: Could node be null?
-        // @ts-ignore
-        x: positions.get(node.uid).x,
-        // @ts-ignore
-        y: positions.get(node.uid).y,
+        x: positions.get(node.uid)!.x,
+        y: positions.get(node.uid)!.y,
       };
       nodes.push(nodeEntity);
       cacheEntity[node.uid] = nodeEntity;
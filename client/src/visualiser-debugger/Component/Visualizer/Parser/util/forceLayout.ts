@@ -0,0 +1,304 @@
+import { Coord } from '../../../../Types/geometryType';
+
+/**
+ * Force-directed layout of a graph: edges pull their ends together, every pair of vertices pushes
+ * apart. The pushing is approximated by Barnes–Hut, where a quadtree groups the vertices and a
+ * cell far enough away pushes as one body at its centre of mass, so a tick is O(n log n) rather
+ * than O(n^2) and graphs of thousands of vertices still settle between steps.
+ */
+
+export interface LayoutRequest {
+  id: number;
+  uids: string[];
+  // Pairs of indices into uids
+  edges: Int32Array;
+}
+
+export interface LayoutResult {
+  id: number;
+  x: Float64Array;
+  y: Float64Array;
+}
+
+// The length edges settle at
+export const EDGE_LENGTH = 150;
+// Where the layout is centred
+export const LAYOUT_CENTRE: Coord = { x: 600, y: 400 };
+// A cell pushes as one body when its size over its distance is below this
+const THETA = 0.8;
+// Cells stop splitting this deep, so vertices at the same spot share a leaf
+const MAX_DEPTH = 20;
+// Pull of every vertex towards the centre, which keeps components from drifting apart
+const GRAVITY = 0.05;
+const COOLING = 0.95;
+// Ticks for a layout from scratch, and for one mostly starting where the last one ended
+const COLD_TICKS = 300;
+const WARM_TICKS = 60;
+
+interface QuadTree {
+  // Per cell: its square bounds, and the number and centre of mass of the vertices in it
+  left: number[];
+  top: number[];
+  size: number[];
+  mass: number[];
+  massX: number[];
+  massY: number[];
+  // The first of the four children of a cell, -1 for leaves
+  firstChild: number[];
+  // The vertices in a leaf, as a list through nextBody
+  firstBody: number[];
+  nextBody: Int32Array;
+}
+
+const addCell = (tree: QuadTree, left: number, top: number, size: number): void => {
+  tree.left.push(left);
+  tree.top.push(top);
+  tree.size.push(size);
+  tree.mass.push(0);
+  tree.massX.push(0);
+  tree.massY.push(0);
+  tree.firstChild.push(-1);
+  tree.firstBody.push(-1);
+};
+
+const quadrant = (tree: QuadTree, cell: number, x: number, y: number): number => {
+  const half = tree.size[cell] / 2;
+  const right = x >= tree.left[cell] + half ? 1 : 0;
+  const bottom = y >= tree.top[cell] + half ? 2 : 0;
+  return tree.firstChild[cell] + right + bottom;
+};
+
+const split = (tree: QuadTree, cell: number): void => {
+  const half = tree.size[cell] / 2;
+  tree.firstChild[cell] = tree.left.length;
+  for (let q = 0; q < 4; q += 1) {
+    const left = tree.left[cell] + (q % 2) * half;
+    addCell(tree, left, tree.top[cell] + Math.floor(q / 2) * half, half);
+  }
+};
+
+const insert = (tree: QuadTree, x: Float64Array, y: Float64Array, body: number): void => {
+  let cell = 0;
+  let depth = 0;
+  while (tree.firstChild[cell] !== -1) {
+    cell = quadrant(tree, cell, x[body], y[body]);
+    depth += 1;
+  }
+  // Push the leaf's vertex down until the two are in cells of their own
+  while (tree.firstBody[cell] !== -1 && depth < MAX_DEPTH) {
+    const other = tree.firstBody[cell];
+    tree.firstBody[cell] = -1;
+    split(tree, cell);
+    tree.firstBody[quadrant(tree, cell, x[other], y[other])] = other;
+    cell = quadrant(tree, cell, x[body], y[body]);
+    depth += 1;
+  }
+  tree.nextBody[body] = tree.firstBody[cell];
+  tree.firstBody[cell] = body;
+};
+
+const buildQuadTree = (x: Float64Array, y: Float64Array): QuadTree => {
+  const tree: QuadTree = {
+    left: [],
+    top: [],
+    size: [],
+    mass: [],
+    massX: [],
+    massY: [],
+    firstChild: [],
+    firstBody: [],
+    nextBody: new Int32Array(x.length).fill(-1),
+  };
+  const minX = x.reduce((min, value) => Math.min(min, value), Infinity);
+  const minY = y.reduce((min, value) => Math.min(min, value), Infinity);
+  const maxX = x.reduce((max, value) => Math.max(max, value), -Infinity);
+  const maxY = y.reduce((max, value) => Math.max(max, value), -Infinity);
+  addCell(tree, minX, minY, Math.max(maxX - minX, maxY - minY) + 1);
+  for (let i = 0; i < x.length; i += 1) {
+    insert(tree, x, y, i);
+  }
+
+  // Children are added after their parents, so going backwards sums them first
+  for (let cell = tree.left.length - 1; cell >= 0; cell -= 1) {
+    let mass = 0;
+    let sumX = 0;
+    let sumY = 0;
+    if (tree.firstChild[cell] === -1) {
+      for (let body = tree.firstBody[cell]; body !== -1; body = tree.nextBody[body]) {
+        mass += 1;
+        sumX += x[body];
+        sumY += y[body];
+      }
+    } else {
+      for (let child = tree.firstChild[cell]; child < tree.firstChild[cell] + 4; child += 1) {
+        mass += tree.mass[child];
+        sumX += tree.massX[child] * tree.mass[child];
+        sumY += tree.massY[child] * tree.mass[child];
+      }
+    }
+    tree.mass[cell] = mass;
+    tree.massX[cell] = mass > 0 ? sumX / mass : 0;
+    tree.massY[cell] = mass > 0 ? sumY / mass : 0;
+  }
+  return tree;
+};
+
+// Adds the push of every other vertex on vertex i to its force
+const repel = (
+  tree: QuadTree,
+  x: Float64Array,
+  y: Float64Array,
+  i: number,
+  forceX: Float64Array,
+  forceY: Float64Array
+): void => {
+  const strength = EDGE_LENGTH * EDGE_LENGTH;
+  const push = (dx: number, dy: number, mass: number) => {
+    const distance2 = Math.max(dx * dx + dy * dy, 1);
+    forceX[i] += (dx * strength * mass) / distance2;
+    forceY[i] += (dy * strength * mass) / distance2;
+  };
+
+  const stack = [0];
+  while (stack.length > 0) {
+    const cell = stack.pop()!;
+    if (tree.mass[cell] > 0) {
+      const dx = x[i] - tree.massX[cell];
+      const dy = y[i] - tree.massY[cell];
+      const size = tree.size[cell];
+      const inside =
+        x[i] >= tree.left[cell] &&
+        x[i] < tree.left[cell] + size &&
+        y[i] >= tree.top[cell] &&
+        y[i] < tree.top[cell] + size;
+      if (tree.firstChild[cell] === -1) {
+        for (let body = tree.firstBody[cell]; body !== -1; body = tree.nextBody[body]) {
+          if (body !== i) {
+            // Vertices on top of each other are pushed apart in the order they come
+            const same = x[i] === x[body] && y[i] === y[body];
+            push(same ? i - body : x[i] - x[body], y[i] - y[body], 1);
+          }
+        }
+      } else if (!inside && size * size < THETA * THETA * (dx * dx + dy * dy)) {
+        push(dx, dy, tree.mass[cell]);
+      } else {
+        for (let child = tree.firstChild[cell]; child < tree.firstChild[cell] + 4; child += 1) {
+          stack.push(child);
+        }
+      }
+    }
+  }
+};
+
+/**
+ * Moves the vertices at (x, y) towards a layout with no vertex near another and edges near
+ * EDGE_LENGTH long, centred on LAYOUT_CENTRE. A warm layout starts from a settled one, so it
+ * takes fewer and smaller steps and the vertices stay close to where they were.
+ */
+export const forceLayout = (
+  x: Float64Array,
+  y: Float64Array,
+  edges: Int32Array,
+  warm: boolean
+): void => {
+  const n = x.length;
+  if (n === 0) return;
+  const forceX = new Float64Array(n);
+  const forceY = new Float64Array(n);
+  let temperature = warm ? EDGE_LENGTH / 4 : EDGE_LENGTH;
+  const ticks = warm ? WARM_TICKS : COLD_TICKS;
+
+  for (let tick = 0; tick < ticks; tick += 1) {
+    const tree = buildQuadTree(x, y);
+    const [centreX, centreY] = [tree.massX[0], tree.massY[0]];
+    for (let i = 0; i < n; i += 1) {
+      forceX[i] = GRAVITY * (centreX - x[i]);
+      forceY[i] = GRAVITY * (centreY - y[i]);
+      repel(tree, x, y, i, forceX, forceY);
+    }
+    for (let e = 0; e < edges.length; e += 2) {
+      const [from, to] = [edges[e], edges[e + 1]];
+      const dx = x[to] - x[from];
+      const dy = y[to] - y[from];
+      const pull = Math.sqrt(dx * dx + dy * dy) / EDGE_LENGTH;
+      forceX[from] += dx * pull;
+      forceY[from] += dy * pull;
+      forceX[to] -= dx * pull;
+      forceY[to] -= dy * pull;
+    }
+    // Each vertex moves along its force, but no further than the temperature
+    for (let i = 0; i < n; i += 1) {
+      const force = Math.sqrt(forceX[i] * forceX[i] + forceY[i] * forceY[i]);
+      if (force > 0) {
+        const step = Math.min(force, temperature) / force;
+        x[i] += forceX[i] * step;
+        y[i] += forceY[i] * step;
+      }
+    }
+    temperature *= COOLING;
+  }
+
+  const shiftX = LAYOUT_CENTRE.x - x.reduce((sum, value) => sum + value, 0) / n;
+  const shiftY = LAYOUT_CENTRE.y - y.reduce((sum, value) => sum + value, 0) / n;
+  for (let i = 0; i < n; i += 1) {
+    x[i] += shiftX;
+    y[i] += shiftY;
+  }
+};
+
+/**
+ * Where to start each vertex: where it was last, or else around the first neighbour that has a
+ * place, or else on a spiral around the centre. Returns how many vertices had a place already.
+ */
+export const seedPositions = (
+  positions: Map<string, Coord>,
+  uids: string[],
+  edges: Int32Array,
+  x: Float64Array,
+  y: Float64Array
+): number => {
+  const placed = uids.map((uid) => positions.has(uid));
+  const known = placed.filter(Boolean).length;
+  uids.forEach((uid, i) => {
+    const position = positions.get(uid);
+    if (position) {
+      [x[i], y[i]] = [position.x, position.y];
+    }
+  });
+
+  const neighbours = uids.map((): number[] => []);
+  for (let e = 0; e < edges.length; e += 2) {
+    neighbours[edges[e]].push(edges[e + 1]);
+    neighbours[edges[e + 1]].push(edges[e]);
+  }
+  // The golden angle spreads the vertices placed around one point evenly
+  const angle = Math.PI * (3 - Math.sqrt(5));
+  uids.forEach((_, i) => {
+    if (placed[i]) return;
+    const anchor = neighbours[i].find((j) => placed[j]);
+    if (anchor !== undefined) {
+      x[i] = x[anchor] + (EDGE_LENGTH / 2) * Math.cos(i * angle);
+      y[i] = y[anchor] + (EDGE_LENGTH / 2) * Math.sin(i * angle);
+    } else {
+      const radius = (EDGE_LENGTH / 2) * Math.sqrt(i + 1);
+      x[i] = LAYOUT_CENTRE.x + radius * Math.cos(i * angle);
+      y[i] = LAYOUT_CENTRE.y + radius * Math.sin(i * angle);
+    }
+    placed[i] = true;
+  });
+  return known;
+};
+
+// Lays out a request from scratch or from the positions of the last one, which it then replaces
+export const layoutFrom = (
+  positions: Map<string, Coord>,
+  { id, uids, edges }: LayoutRequest
+): LayoutResult => {
+  const x = new Float64Array(uids.length);
+  const y = new Float64Array(uids.length);
+  const known = seedPositions(positions, uids, edges, x, y);
+  forceLayout(x, y, edges, known * 2 >= uids.length && known > 0);
+  positions.clear();
+  uids.forEach((uid, i) => positions.set(uid, { x: x[i], y: y[i] }));
+  return { id, x, y };
+};
@@ -0,0 +1,11 @@
+import { Coord } from '../../../../Types/geometryType';
+import { LayoutRequest, layoutFrom } from './forceLayout';
+
+// Where each vertex settled in the last layout. Requests come one step after another, so each
+// starts from the one before it.
+const positions = new Map<string, Coord>();
+
+globalThis.addEventListener('message', (event: MessageEvent<LayoutRequest>) => {
+  const result = layoutFrom(positions, event.data);
+  globalThis.postMessage(result, { transfer: [result.x.buffer, result.y.buffer] });
+});
@@ -0,0 +1,255 @@
+/**
+ * Layout kernels shared by the parsers. They work on nodes numbered 0 to n - 1 and edges as
+ * (from, to) pairs in an Int32Array, so a parser maps its addresses to numbers once and everything
+ * after is flat typed arrays: no maps keyed by address strings, and no recursion, so lists and
+ * trees a hundred thousand nodes deep lay out in milliseconds instead of overflowing the stack.
+ */
+
+/**
+ * The edges out of every node: those of node i go to targets[offsets[i]] up to
+ * targets[offsets[i + 1]], in the order they were given
+ */
+export interface Adjacency {
+  offsets: Int32Array;
+  targets: Int32Array;
+}
+
+/**
+ * A spanning forest, found breadth first from its roots
+ */
+export interface RootedForest {
+  roots: Int32Array;
+  // -1 for roots
+  parent: Int32Array;
+  depth: Int32Array;
+  // Which of the roots each node is under, by its index in roots
+  tree: Int32Array;
+  children: Adjacency;
+  // Every node, each after its parent
+  order: Int32Array;
+}
+
+// Numbers each distinct uid in the order they come
+export const indexIds = (uids: Iterable<string>): Map<string, number> => {
+  const ids = new Map<string, number>();
+  [...uids].forEach((uid) => {
+    if (!ids.has(uid)) ids.set(uid, ids.size);
+  });
+  return ids;
+};
+
+export const adjacency = (n: number, edges: Int32Array, reversed = false): Adjacency => {
+  const [fromSide, toSide] = reversed ? [1, 0] : [0, 1];
+  const offsets = new Int32Array(n + 1);
+  for (let e = 0; e < edges.length; e += 2) {
+    offsets[edges[e + fromSide] + 1] += 1;
+  }
+  for (let i = 0; i < n; i += 1) {
+    offsets[i + 1] += offsets[i];
+  }
+  const filled = offsets.slice(0, n);
+  const targets = new Int32Array(edges.length / 2);
+  for (let e = 0; e < edges.length; e += 2) {
+    const from = edges[e + fromSide];
+    targets[filled[from]] = edges[e + toSide];
+    filled[from] += 1;
+  }
+  return { offsets, targets };
+};
+
+/**
+ * The connected components of the graph, ignoring direction, by union-find with union by size and
+ * path halving. Components are numbered in the order of their first node.
+ */
+export const components = (
+  n: number,
+  edges: Int32Array
+): { component: Int32Array; count: number } => {
+  const parent = new Int32Array(n);
+  const size = new Int32Array(n).fill(1);
+  for (let i = 0; i < n; i += 1) {
+    parent[i] = i;
+  }
+  const find = (node: number) => {
+    let i = node;
+    while (parent[i] !== i) {
+      parent[i] = parent[parent[i]];
+      i = parent[i];
+    }
+    return i;
+  };
+  for (let e = 0; e < edges.length; e += 2) {
+    let [a, b] = [find(edges[e]), find(edges[e + 1])];
+    if (a !== b) {
+      if (size[a] < size[b]) [a, b] = [b, a];
+      parent[b] = a;
+      size[a] += size[b];
+    }
+  }
+
+  const component = new Int32Array(n);
+  const label = new Int32Array(n).fill(-1);
+  let count = 0;
+  for (let i = 0; i < n; i += 1) {
+    const root = find(i);
+    if (label[root] === -1) {
+      label[root] = count;
+      count += 1;
+    }
+    component[i] = label[root];
+  }
+  return { component, count };
+};
+
+/**
+ * The forest reached breadth first from the roots along the adjacency. Nodes no root reaches,
+ * like those on a cycle, root trees of their own in the order of their numbers.
+ */
+export const rootedForest = (
+  n: number,
+  links: Adjacency,
+  roots: Iterable<number>
+): RootedForest => {
+  const parent = new Int32Array(n).fill(-1);
+  const depth = new Int32Array(n);
+  const tree = new Int32Array(n);
+  const order = new Int32Array(n);
+  const seen = new Uint8Array(n);
+  const rootList: number[] = [];
+  const childCount = new Int32Array(n + 1);
+  let head = 0;
+  let tail = 0;
+
+  const search = (root: number) => {
+    seen[root] = 1;
+    tree[root] = rootList.length;
+    rootList.push(root);
+    order[tail] = root;
+    tail += 1;
+    while (head < tail) {
+      const node = order[head];
+      head += 1;
+      for (let k = links.offsets[node]; k < links.offsets[node + 1]; k += 1) {
+        const next = links.targets[k];
+        if (!seen[next]) {
+          seen[next] = 1;
+          parent[next] = node;
+          depth[next] = depth[node] + 1;
+          tree[next] = tree[node];
+          childCount[node + 1] += 1;
+          order[tail] = next;
+          tail += 1;
+        }
+      }
+    }
+  };
+  [...roots].forEach((root) => {
+    if (!seen[root]) search(root);
+  });
+  for (let i = 0; i < n; i += 1) {
+    if (!seen[i]) search(i);
+  }
+
+  // The children in the order they were found, which is the order of the adjacency
+  for (let i = 0; i < n; i += 1) {
+    childCount[i + 1] += childCount[i];
+  }
+  const filled = childCount.slice(0, n);
+  const targets = new Int32Array(Math.max(n - rootList.length, 0));
+  order.forEach((node) => {
+    if (parent[node] !== -1) {
+      targets[filled[parent[node]]] = node;
+      filled[parent[node]] += 1;
+    }
+  });
+
+  return {
+    roots: Int32Array.from(rootList),
+    parent,
+    depth,
+    tree,
+    children: { offsets: childCount, targets },
+    order,
+  };
+};
+
+/**
+ * A tidy layout of the forest, in units of the gap between leaves: leaves go left to right in
+ * depth-first order, each parent centred over its first and last children, and trees side by side
+ * with a leaf's gap between them.
+ */
+export const tidyTree = (forest: RootedForest): Float64Array => {
+  const n = forest.parent.length;
+  const { offsets, targets } = forest.children;
+  const x = new Float64Array(n);
+  const preorder = new Int32Array(n);
+  let visited = 0;
+  let slot = 0;
+
+  forest.roots.forEach((root) => {
+    const stack = [root];
+    while (stack.length > 0) {
+      const node = stack.pop()!;
+      preorder[visited] = node;
+      visited += 1;
+      if (offsets[node] === offsets[node + 1]) {
+        x[node] = slot;
+        slot += 1;
+      }
+      for (let k = offsets[node + 1] - 1; k >= offsets[node]; k -= 1) {
+        stack.push(targets[k]);
+      }
+    }
+    slot += 1;
+  });
+
+  // Children come after their parents in preorder, so going backwards places them first
+  for (let i = n - 1; i >= 0; i -= 1) {
+    const node = preorder[i];
+    if (offsets[node] !== offsets[node + 1]) {
+      x[node] = (x[targets[offsets[node]]] + x[targets[offsets[node + 1] - 1]]) / 2;
+    }
+  }
+  return x;
+};
+
+/**
+ * A layered layout of the forest across its layers: each tree gets a band from 0 to 1, which each
+ * node splits evenly between its children. Leaves sit in the middle of their share and every
+ * other node level with the mean of its children.
+ */
+export const layeredBands = (forest: RootedForest): Float64Array => {
+  const n = forest.parent.length;
+  const { offsets, targets } = forest.children;
+  const low = new Float64Array(n);
+  const high = new Float64Array(n);
+  const position = new Float64Array(n);
+
+  forest.order.forEach((node) => {
+    if (forest.parent[node] === -1) {
+      [low[node], high[node]] = [0, 1];
+    }
+    const count = offsets[node + 1] - offsets[node];
+    const share = (high[node] - low[node]) / Math.max(count, 1);
+    for (let k = offsets[node]; k < offsets[node + 1]; k += 1) {
+      const child = targets[k];
+      low[child] = low[node] + share * (k - offsets[node]);
+      high[child] = low[child] + share;
+    }
+  });
+
+  for (let i = n - 1; i >= 0; i -= 1) {
+    const node = forest.order[i];
+    const count = offsets[node + 1] - offsets[node];
+    if (count === 0) {
+      position[node] = (low[node] + high[node]) / 2;
+    } else {
+      let sum = 0;
+      for (let k = offsets[node]; k < offsets[node + 1]; k += 1) {
+        sum += position[targets[k]];
+      }
+      position[node] = sum / count;
+    }
+  }
+  return position;
+};
@@ -0,0 +1,230 @@
+import { Addr, MemoryValue } from '../../../../Types/backendType';
+import { Matrix, MatrixSource } from '../../../../Types/frontendType';
+import { HeapIndex, objectAt } from '../../../../Store/heapIndex';
+import { PAGE_CELLS } from '../../../../Store/cellPageStore';
+
+/**
+ * Decoding of the ways C programs keep 2D arrays into row-major grids of numbers: arrays of arrays,
+ * arrays of pointers to rows, and flat arrays with a row length from elsewhere. Cells past the
+ * first page of an array, or in rows the debugger did not trace, are NaN until the pages in view
+ * are read, see missingPages and withPages.
+ */
+
+// Pages asked for at once, so that a huge matrix zoomed out is read as it is zoomed into
+const MAX_VIEW_PAGES = 256;
+
+// Ints and floats as they are, characters as their codes, anything else is not a number
+const toNumber = (cell: unknown): number => {
+  if (typeof cell === 'number') return cell;
+  if (typeof cell === 'string') {
+    if (cell.length === 1) return cell.charCodeAt(0);
+    const number = Number(cell);
+    return cell.trim() !== '' && !cell.startsWith('0x') ? number : NaN;
+  }
+  return NaN;
+};
+
+const cellsOf = (value: MemoryValue | undefined): unknown[] | null =>
+  value && Array.isArray(value.value) ? (value.value as unknown[]) : null;
+
+// The length of the rows of an array of arrays, from its element type, e.g. 'int [4]'
+const rowLength = (elementType: string | undefined): number | null => {
+  const match = elementType?.match(/\[(\d+)\]/);
+  return match ? Number(match[1]) : null;
+};
+
+const isAddr = (cell: unknown): cell is Addr => typeof cell === 'string' && cell.startsWith('0x');
+
+const grid = (
+  uid: string,
+  elementType: string,
+  rows: number,
+  columns: number,
+  source: MatrixSource
+): Matrix => ({
+  uid,
+  elementType,
+  rows,
+  columns,
+  cells: new Float64Array(rows * columns).fill(NaN),
+  changed: new Uint8Array(rows * columns),
+  source,
+});
+
+/**
+ * The matrix a variable holds or points to, null if it holds none. A flat array needs its row
+ * length as columns.
+ */
+export const decodeMatrix = (
+  uid: string,
+  value: MemoryValue,
+  heap: HeapIndex,
+  columns: number | null
+): Matrix | null => {
+  const pointee = isAddr(value.value) ? objectAt(heap, value.value) : undefined;
+  const array = cellsOf(value) ? value : pointee;
+  const cells = cellsOf(array);
+  if (!array || !cells) return null;
+  const length = array.length ?? cells.length;
+
+  // An array of arrays
+  if (cells.some(Array.isArray)) {
+    const width =
+      rowLength(array.elementType) ??
+      Math.max(0, ...cells.map((row) => (Array.isArray(row) ? row.length : 0)));
+    const elementType = array.elementType?.replace(/ ?\[\d+\]/, '') ?? '';
+    // The rows are contiguous, so a cell is read as one of a flat array
+    const matrix = grid(uid, elementType, length, width, {
+      layout: 'flat',
+      addr: array.addr,
+      length: length * width,
+      elementType,
+      sent: cells.map((row) => (Array.isArray(row) ? Math.min(row.length, width) : 0)),
+    });
+    cells.forEach((row, r) => {
+      (Array.isArray(row) ? row.slice(0, width) : []).forEach((cell, c) => {
+        matrix.cells[r * width + c] = toNumber(cell);
+      });
+    });
+    return matrix;
+  }
+
+  // An array of pointers to rows
+  if (cells.some(isAddr) && array.elementType?.endsWith('*')) {
+    const rows = cells.map((cell) => (isAddr(cell) ? objectAt(heap, cell) : undefined));
+    const width = Math.max(0, ...rows.map((row) => row?.length ?? cellsOf(row)?.length ?? 0));
+    if (width === 0) return null;
+    const elementType = rows.find((row) => row?.elementType)?.elementType ?? '';
+    const matrix = grid(uid, elementType, length, width, {
+      layout: 'rows',
+      addr: array.addr,
+      length,
+      elementType,
+      pointerType: array.elementType,
+      sent: rows.map((row) => cellsOf(row)?.length ?? 0),
+      rows: cells.map((cell) => (isAddr(cell) ? cell : undefined)),
+    });
+    rows.forEach((row, r) => {
+      (cellsOf(row) ?? []).forEach((cell, c) => {
+        matrix.cells[r * width + c] = toNumber(cell);
+      });
+    });
+    return matrix;
+  }
+
+  // A flat array, row after row
+  if (columns === null || !Number.isInteger(columns) || columns <= 0) return null;
+  const rows = Math.ceil(length / columns);
+  const matrix = grid(uid, array.elementType ?? '', rows, columns, {
+    layout: 'flat',
+    addr: array.addr,
+    length,
+    elementType: array.elementType ?? '',
+    sent: Array.from({ length: rows }, (_, r) =>
+      Math.max(0, Math.min(columns, cells.length - r * columns))
+    ),
+  });
+  cells.forEach((cell, i) => {
+    matrix.cells[i] = toNumber(cell);
+  });
+  return matrix;
+};
+
+// The pages read so far of the array at an address in the state shown, see cellPageStore
+export type PagesOf = (addr: Addr) => Record<number, unknown[]> | undefined;
+
+const pageCell = (pages: Record<number, unknown[]> | undefined, index: number): unknown => {
+  const start = index - (index % PAGE_CELLS);
+  return pages?.[start]?.[index - start];
+};
+
+// Where the cells of row r are, for rows: what its pointer holds, which may itself have been read
+const rowAddr = (source: MatrixSource, r: number, pagesOf: PagesOf): Addr | undefined => {
+  const pointer = source.rows?.[r] ?? pageCell(pagesOf(source.addr), r);
+  return isAddr(pointer) ? pointer : undefined;
+};
+
+export type CellPage = { addr: Addr; elementType: string; start: number; count: number };
+
+/**
+ * The pages holding cells in rows [top, bottom) and columns [left, right) that neither came with
+ * the state nor were read since, to ask the debugger for. A row past the first page of pointers to rows needs the page
+ * of pointers to be read first.
+ */
+export const missingPages = (
+  matrix: Matrix,
+  pagesOf: PagesOf,
+  [top, bottom]: [number, number],
+  [left, right]: [number, number]
+): CellPage[] => {
+  const { source, rows, columns } = matrix;
+  if (!source) return [];
+  const pages: Map<string, CellPage> = new Map();
+  // The pages of cells [first, end) of an array of length cells
+  const add = (addr: Addr, elementType: string, first: number, end: number, length: number) => {
+    const last = Math.min(end, length);
+    for (let start = first - (first % PAGE_CELLS); start < last; start += PAGE_CELLS) {
+      if (pages.size >= MAX_VIEW_PAGES) return;
+      if (!pagesOf(addr)?.[start]) {
+        const count = Math.min(PAGE_CELLS, length - start);
+        pages.set(`${addr}:${start}`, { addr, elementType, start, count });
+      }
+    }
+  };
+
+  const to = Math.min(right, columns);
+  for (let r = Math.max(top, 0); r < Math.min(bottom, rows); r += 1) {
+    // Rows start with the cells that came with the state
+    const from = Math.max(left, source.sent[r] ?? 0, 0);
+    if (from < to && source.layout === 'flat') {
+      add(source.addr, source.elementType, r * columns + from, r * columns + to, source.length);
+    } else if (from < to) {
+      const addr = rowAddr(source, r, pagesOf);
+      if (addr) {
+        add(addr, source.elementType, from, to, columns);
+      } else {
+        add(source.addr, source.pointerType ?? '', r, r + 1, source.length);
+      }
+    }
+  }
+  return Array.from(pages.values());
+};
+
+/**
+ * The matrix with the cells of the pages read so far filled in, or itself if none were
+ */
+export const withPages = (matrix: Matrix, pagesOf: PagesOf): Matrix => {
+  const { source, rows, columns } = matrix;
+  if (!source) return matrix;
+  const cells = Float64Array.from(matrix.cells);
+  let filled = false;
+  const fill = (offset: number, pages: Record<number, unknown[]> | undefined, end: number) => {
+    Object.entries(pages ?? {}).forEach(([start, page]) => {
+      page.forEach((cell, k) => {
+        if (Number(start) + k < end) {
+          cells[offset + Number(start) + k] = toNumber(cell);
+          filled = true;
+        }
+      });
+    });
+  };
+
+  if (source.layout === 'flat') {
+    fill(0, pagesOf(source.addr), Math.min(source.length, rows * columns));
+  } else {
+    for (let r = 0; r < rows; r += 1) {
+      const addr = rowAddr(source, r, pagesOf);
+      if (addr) fill(r * columns, pagesOf(addr), columns);
+    }
+  }
+  return filled ? { ...matrix, cells } : matrix;
+};
+
+// Marks the cells of a matrix that differ from those of the same shape in the frame before
+export const markChanges = (matrix: Matrix, before: Matrix | undefined): void => {
+  if (!before || before.rows !== matrix.rows || before.columns !== matrix.columns) return;
+  for (let i = 0; i < matrix.cells.length; i += 1) {
+    const [now, then] = [matrix.cells[i], before.cells[i]];
+    matrix.changed[i] = now !== then && !(Number.isNaN(now) && Number.isNaN(then)) ? 1 : 0;
+  }
+};
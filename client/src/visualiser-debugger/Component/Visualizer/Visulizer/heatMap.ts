@@ -0,0 +1,128 @@
+import { Matrix } from '../../../Types/frontendType';
+
+/**
+ * Drawing of matrices as heat maps. The colours are put into an image with one pixel per cell
+ * once per frame, which the canvas scales as the view zooms, so a 500x500 grid costs one
+ * drawImage. Only the cells in view get labels and change marks drawn one by one.
+ */
+
+export interface HeatMapView {
+  // Pixels per cell
+  scale: number;
+  // Where the top left corner of the first cell is on the canvas
+  left: number;
+  top: number;
+}
+
+export interface HeatMapImage {
+  image: HTMLCanvasElement;
+  min: number;
+  max: number;
+}
+
+// Cells at least this many pixels wide show their values
+export const LABEL_MIN_SCALE = 28;
+const CHANGED_COLOUR = '#FF5252';
+const UNKNOWN_COLOUR: [number, number, number] = [200, 200, 200];
+// Viridis, from the lowest value to the highest
+const COLOUR_STOPS: [number, number, number][] = [
+  [68, 1, 84],
+  [59, 82, 139],
+  [33, 145, 140],
+  [94, 201, 98],
+  [253, 231, 37],
+];
+
+const colourOf = (value: number, min: number, max: number): [number, number, number] => {
+  if (Number.isNaN(value)) return UNKNOWN_COLOUR;
+  const t = max > min ? ((value - min) / (max - min)) * (COLOUR_STOPS.length - 1) : 0;
+  const stop = Math.min(Math.floor(t), COLOUR_STOPS.length - 2);
+  const [from, to] = [COLOUR_STOPS[stop], COLOUR_STOPS[stop + 1]];
+  const mix = (c: number) => Math.round(from[c] + (to[c] - from[c]) * (t - stop));
+  return [mix(0), mix(1), mix(2)];
+};
+
+export const heatMapImage = (matrix: Matrix): HeatMapImage => {
+  let min = Infinity;
+  let max = -Infinity;
+  matrix.cells.forEach((value) => {
+    if (!Number.isNaN(value)) {
+      min = Math.min(min, value);
+      max = Math.max(max, value);
+    }
+  });
+
+  const image = document.createElement('canvas');
+  image.width = Math.max(matrix.columns, 1);
+  image.height = Math.max(matrix.rows, 1);
+  const context = image.getContext('2d')!;
+  const pixels = context.createImageData(image.width, image.height);
+  matrix.cells.forEach((value, i) => {
+    const [r, g, b] = colourOf(value, min, max);
+    pixels.data.set([r, g, b, 255], i * 4);
+  });
+  context.putImageData(pixels, 0, 0);
+  return { image, min, max };
+};
+
+const label = (matrix: Matrix, value: number): string => {
+  if (Number.isNaN(value)) return '?';
+  if (matrix.elementType === 'char') return String.fromCharCode(value);
+  return Number.isInteger(value) ? String(value) : value.toPrecision(3);
+};
+
+export const drawHeatMap = (
+  canvas: HTMLCanvasElement,
+  matrix: Matrix,
+  { image, min, max }: HeatMapImage,
+  { scale, left, top }: HeatMapView
+): void => {
+  const context = canvas.getContext('2d')!;
+  const { width, height } = canvas;
+  context.clearRect(0, 0, width, height);
+  context.imageSmoothingEnabled = false;
+  context.drawImage(image, left, top, matrix.columns * scale, matrix.rows * scale);
+
+  // The cells in view
+  const firstColumn = Math.max(0, Math.floor(-left / scale));
+  const lastColumn = Math.min(matrix.columns, Math.ceil((width - left) / scale));
+  const firstRow = Math.max(0, Math.floor(-top / scale));
+  const lastRow = Math.min(matrix.rows, Math.ceil((height - top) / scale));
+
+  // Changed cells are outlined, or filled when too small to outline
+  context.strokeStyle = CHANGED_COLOUR;
+  context.fillStyle = CHANGED_COLOUR;
+  context.lineWidth = Math.max(2, scale / 10);
+  const markSize = Math.max(scale, 2);
+  for (let row = firstRow; row < lastRow; row += 1) {
+    for (let column = firstColumn; column < lastColumn; column += 1) {
+      if (matrix.changed[row * matrix.columns + column]) {
+        const [x, y] = [left + column * scale, top + row * scale];
+        if (scale >= 6) {
+          context.strokeRect(x, y, scale, scale);
+        } else {
+          context.fillRect(x, y, markSize, markSize);
+        }
+      }
+    }
+  }
+
+  if (scale < LABEL_MIN_SCALE) return;
+  context.font = `${Math.min(scale / 3, 16)}px CodeText`;
+  context.textAlign = 'center';
+  context.textBaseline = 'middle';
+  for (let row = firstRow; row < lastRow; row += 1) {
+    for (let column = firstColumn; column < lastColumn; column += 1) {
+      const value = matrix.cells[row * matrix.columns + column];
+      const [r, g, b] = colourOf(value, min, max);
+      // Dark text on light cells and light text on dark ones
+      context.fillStyle = 0.299 * r + 0.587 * g + 0.114 * b > 140 ? '#000000' : '#FFFFFF';
+      context.fillText(
+        label(matrix, value),
+        left + (column + 0.5) * scale,
+        top + (row + 0.5) * scale,
+        scale
+      );
+    }
+  }
+};
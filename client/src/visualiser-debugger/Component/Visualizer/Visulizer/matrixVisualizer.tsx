@@ -0,0 +1,144 @@
+import React, { useEffect, useMemo, useRef, useState } from 'react';
+import useSocketClientStore from 'Services/socketClient';
+import { VisualizerComponent, VisualizerState } from './visualizer';
+import { FrontendMatrixState, Matrix } from '../../../Types/frontendType';
+import { Addr } from '../../../Types/backendType';
+import { pagesKey, useCellPageStore } from '../../../Store/cellPageStore';
+import { useFrontendStateStore } from '../../../Store/frontendStateStore';
+import { missingPages, withPages } from '../Parser/util/matrix';
+import { drawHeatMap, heatMapImage, HeatMapView } from './heatMap';
+
+// The largest a cell gets when a matrix is fitted to its canvas
+const MAX_FIT_SCALE = 60;
+const ZOOM_SPEED = 0.0015;
+
+// The view showing all of a matrix, centred
+const fitView = (matrix: Matrix, width: number, height: number): HeatMapView => {
+  const scale = Math.min(
+    width / Math.max(matrix.columns, 1),
+    height / Math.max(matrix.rows, 1),
+    MAX_FIT_SCALE
+  );
+  return {
+    scale,
+    left: (width - matrix.columns * scale) / 2,
+    top: (height - matrix.rows * scale) / 2,
+  };
+};
+
+// The rows or columns [first, end) of a matrix of `cells` of them, on a canvas `size` pixels long
+const inView = (offset: number, scale: number, size: number, cells: number): [number, number] => [
+  Math.max(0, Math.floor(-offset / scale)),
+  Math.min(cells, Math.ceil((size - offset) / scale)),
+];
+
+const MatrixCanvas = ({
+  matrix: parsed,
+  width,
+  height,
+}: {
+  matrix: Matrix;
+  width: number;
+  height: number;
+}) => {
+  const canvasRef = useRef<HTMLCanvasElement | null>(null);
+  const [view, setView] = useState<HeatMapView>(() => fitView(parsed, width, height));
+  const dragFrom = useRef<{ x: number; y: number } | null>(null);
+
+  // Cells past the first page of an array are read as they come into view, like ArrayCells does
+  const { socketClient } = useSocketClientStore();
+  const step = useFrontendStateStore((state) => state.currentIndex) + 1;
+  const offline = useFrontendStateStore((state) => state.offline);
+  const pages = useCellPageStore((state) => state.pages);
+  const pagesOf = (addr: Addr) => pages[pagesKey(step, addr)];
+  const matrix = useMemo(() => withPages(parsed, pagesOf), [parsed, pages, step]);
+  const image = useMemo(() => heatMapImage(matrix), [matrix]);
+
+  useEffect(() => {
+    if (offline) return;
+    const rows = inView(view.top, view.scale, height, matrix.rows);
+    const columns = inView(view.left, view.scale, width, matrix.columns);
+    const { requestPage } = useCellPageStore.getState();
+    missingPages(matrix, pagesOf, rows, columns).forEach((page) => {
+      if (requestPage(step, page.addr, page.start)) {
+        socketClient.serverAction.readRange({ step, ...page });
+      }
+    });
+  }, [matrix, view, width, height, step, offline]);
+
+  // A matrix of another shape starts fitted, one of the same shape keeps the view
+  useEffect(() => {
+    setView(fitView(matrix, width, height));
+  }, [matrix.rows, matrix.columns, width, height]);
+
+  useEffect(() => {
+    if (canvasRef.current) {
+      drawHeatMap(canvasRef.current, matrix, image, view);
+    }
+  }, [matrix, image, view]);
+
+  // Zooms about the pointer
+  const handleWheel = (event: React.WheelEvent<HTMLCanvasElement>) => {
+    const rect = event.currentTarget.getBoundingClientRect();
+    const [x, y] = [event.clientX - rect.left, event.clientY - rect.top];
+    const factor = Math.exp(-event.deltaY * ZOOM_SPEED);
+    setView((prev) => ({
+      scale: prev.scale * factor,
+      left: x - (x - prev.left) * factor,
+      top: y - (y - prev.top) * factor,
+    }));
+  };
+
+  const handlePointerMove = (event: React.PointerEvent<HTMLCanvasElement>) => {
+    if (!dragFrom.current) return;
+    const [dx, dy] = [event.clientX - dragFrom.current.x, event.clientY - dragFrom.current.y];
+    dragFrom.current = { x: event.clientX, y: event.clientY };
+    setView((prev) => ({ ...prev, left: prev.left + dx, top: prev.top + dy }));
+  };
+
+  const changed = matrix.changed.reduce((count, flag) => count + flag, 0);
+
+  return (
+    <div>
+      <div style={{ fontSize: '0.8rem', fontFamily: 'CodeText' }}>
+        {`${matrix.elementType} ${matrix.uid}[${matrix.rows}][${matrix.columns}]`}
+        {changed > 0 && `, ${changed} changed`}
+      </div>
+      <canvas
+        ref={canvasRef}
+        width={width}
+        height={height}
+        style={{ cursor: 'grab', touchAction: 'none' }}
+        onWheel={handleWheel}
+        onPointerDown={(event) => {
+          dragFrom.current = { x: event.clientX, y: event.clientY };
+          event.currentTarget.setPointerCapture(event.pointerId);
+        }}
+        onPointerMove={handlePointerMove}
+        onPointerUp={() => {
+          dragFrom.current = null;
+        }}
+        onDoubleClick={() => setView(fitView(matrix, width, height))}
+      />
+    </div>
+  );
+};
+
+/**
+ * Matrices as heat maps, one canvas each. Wheel to zoom, drag to pan and double click to fit;
+ * values show once cells are big enough to hold them.
+ */
+const MatrixVisualizer: VisualizerComponent = ({ graphState, dimension }: VisualizerState) => {
+  const { matrices = [] } = graphState as Partial<FrontendMatrixState>;
+  const height = Math.max(dimension.height / Math.max(matrices.length, 1) - 24, 100);
+
+  return (
+    <div style={{ overflow: 'auto', height: '100%' }}>
+      {matrices.map((matrix) => (
+        <MatrixCanvas key={matrix.uid} matrix={matrix} width={dimension.width} height={height} />
+      ))}
+    </div>
+  );
+};
+
+export default MatrixVisualizer;
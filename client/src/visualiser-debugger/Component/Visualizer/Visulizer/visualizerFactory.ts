@@ -1,15 +1,19 @@
 import { VisualizerType } from '../../../Types/visualizerType';
 // import { assertUnreachable } from '../Util/util';
 import LinkedList from './linkedListVisualizer';
+import MatrixVisualizer from './matrixVisualizer';
 import { VisualizerComponent } from './visualizer';
 
 export function visualizerFactory(visualizerType: VisualizerType): VisualizerComponent {
   switch (visualizerType) {
     case VisualizerType.LINKED_LIST:
-    case VisualizerType.BINARY_TREE: {
+    case VisualizerType.BINARY_TREE:
+    case VisualizerType.GRAPH: {
       return LinkedList;
     }
-    case VisualizerType.GRAPH:
+    case VisualizerType.MATRIX: {
+      return MatrixVisualizer;
+    }
     case VisualizerType.ARRAY: {
       throw new Error('Not implemented');
     }
@@ -17,6 +17,9 @@ import { useGlobalStore } from './Store/globalStateStore';
 import { useSocketCommunication } from '../Services/useSocketCommunication';
 import { useUserFsStateStore } from './Store/userFsStateStore';
 import { onboardingStore, handleJoyrideCallback, OPEN_FILE_STEP } from './Store/onboardingStore';
+import { DEFAULT_MESSAGE_DURATION, useToastStateStore } from './Store/toastStateStore';
+import { fetchTrace, playTrace } from './Trace/traceLibrary';
+import useSocketClientStore from '../Services/socketClient';
 
 const DevelopmentMode = () => {
   const inputElement = useRef<HTMLInputElement>(null);
@@ -42,6 +45,35 @@ const DevelopmentMode = () => {
     }
   }, [onboardingCurrFile]);
 
+  // Lecturers open ?present=<name>, students follow with ?lecture=<name>
+  useEffect(() => {
+    const params = new URLSearchParams(window.location.search);
+    const { serverAction } = useSocketClientStore.getState().socketClient;
+    const presenting = params.get('present');
+    const watching = params.get('lecture');
+    if (presenting) {
+      serverAction.startLecture(presenting);
+    } else if (watching) {
+      serverAction.joinLecture(watching);
+    }
+  }, []);
+
+  // Walkthroughs are shared as links with ?trace=<url of a trace file>
+  useEffect(() => {
+    const traceUrl = new URLSearchParams(window.location.search).get('trace');
+    if (!traceUrl) return;
+
+    fetchTrace(traceUrl)
+      .then(playTrace)
+      .catch((error: Error) =>
+        useToastStateStore.getState().setToastMessage({
+          content: `Failed to open trace: ${error.message}`,
+          colorTheme: 'error',
+          durationMs: DEFAULT_MESSAGE_DURATION,
+        })
+      );
+  }, []);
+
   const handleClickStart = (event: React.MouseEvent<HTMLElement>) => {
     event.preventDefault();
     resetRootPaths();
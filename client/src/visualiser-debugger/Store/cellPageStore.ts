@@ -0,0 +1,50 @@
+import { create } from 'zustand';
+import { Addr, CellRange } from '../Types/backendType';
+
+// Cells of an array or string the debugger sends at once, see readRange
+export const PAGE_CELLS = 200;
+
+// The pages of one array in one state, by their first cell
+type Pages = Record<number, unknown[]>;
+
+export const pagesKey = (step: number, addr: Addr) => `${step}:${addr}`;
+
+type State = {
+  pages: Record<string, Pages>;
+  // Pages asked for and not received yet, as `${pagesKey}:${start}`
+  pending: Record<string, true>;
+};
+
+type Action = {
+  // Whether the page still has to be asked for, marking it as asked for
+  requestPage: (step: number, addr: Addr, start: number) => boolean;
+  receiveRange: (step: number, range: CellRange) => void;
+  clearPages: () => void;
+};
+
+export const useCellPageStore = create<State & Action>((set, get) => ({
+  pages: {},
+  pending: {},
+  requestPage: (step, addr, start) => {
+    const key = pagesKey(step, addr);
+    const { pages, pending } = get();
+    if (pages[key]?.[start] || pending[`${key}:${start}`]) {
+      return false;
+    }
+    set({ pending: { ...pending, [`${key}:${start}`]: true } });
+    return true;
+  },
+  receiveRange: (step, range) => {
+    const key = pagesKey(step, range.addr);
+    const { pages, pending } = get();
+    const stillPending = { ...pending };
+    delete stillPending[`${key}:${range.start}`];
+    set({
+      pages: { ...pages, [key]: { ...pages[key], [range.start]: range.cells } },
+      pending: stillPending,
+    });
+  },
+  clearPages: () => {
+    set({ pages: {}, pending: {} });
+  },
+}));
@@ -3,7 +3,7 @@ import { FrontendState, INITIAL_GRAPH } from '../Types/frontendType';
 import { BackendState, INITIAL_BACKEND_STATE } from '../Types/backendType';
 
 // Map BackendState and FrontendState one to one?? Good design??
-type MappedState = {
+export type MappedState = {
   backendState: BackendState;
   frontendState: FrontendState;
 };
@@ -12,15 +12,21 @@ type State = {
   states: MappedState[];
   currentIndex: number;
   isActive: boolean;
+  // Playing back a trace file, there is no debug session to ask for more states
+  offline: boolean;
   currState: () => MappedState;
 };
 
 type Action = {
   appendFrontendNewState: (backendState: BackendState, newState: FrontendState) => void;
+  loadStates: (states: MappedState[]) => void;
+  replaceState: (index: number, backendState: BackendState, newState: FrontendState) => void;
   stepForward: () => void;
   stepBackward: () => void;
   jumpToState: (index: number) => void;
+  rewindTo: (step: number) => void;
   setActive: (active: boolean) => void;
+  setOffline: (offline: boolean) => void;
   clearFrontendState: () => void;
 };
 
@@ -30,6 +36,7 @@ export const useFrontendStateStore: UseBoundStore<StoreApi<State & Action>> = cr
   states: [],
   currentIndex: -1,
   isActive: false,
+  offline: false,
   currState: () => {
     if (useFrontendStateStore.getState().currentIndex === -1) {
       return {
@@ -66,6 +73,19 @@ export const useFrontendStateStore: UseBoundStore<StoreApi<State & Action>> = cr
       };
     });
   },
+  loadStates: (states: MappedState[]) => {
+    set({ states, currentIndex: -1 });
+  },
+  replaceState: (index: number, backendState: BackendState, newState: FrontendState) => {
+    set((state) => {
+      if (index < 0 || index >= state.states.length) {
+        return {};
+      }
+      const updatedStates = [...state.states];
+      updatedStates[index] = { backendState, frontendState: newState };
+      return { states: updatedStates };
+    });
+  },
   stepForward: () => {
     if (
       useFrontendStateStore.getState().currentIndex >=
@@ -91,10 +111,20 @@ export const useFrontendStateStore: UseBoundStore<StoreApi<State & Action>> = cr
     }
     set({ currentIndex: index });
   },
+  // The program was taken back to an earlier step, the states after it are gone
+  rewindTo: (step: number) => {
+    set((state) => ({
+      states: state.states.slice(0, step),
+      currentIndex: Math.min(state.currentIndex, step - 1),
+    }));
+  },
   setActive: (active: boolean) => {
     set({ isActive: active });
   },
+  setOffline: (offline: boolean) => {
+    set({ offline });
+  },
   clearFrontendState: () => {
-    set({ isActive: false, states: [], currentIndex: -1 });
+    set({ isActive: false, offline: false, states: [], currentIndex: -1 });
   },
 }));
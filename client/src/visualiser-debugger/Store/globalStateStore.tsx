@@ -7,6 +7,7 @@ import { visualizerFactory } from '../Component/Visualizer/Visulizer/visualizerF
 import { StackAnnotation, UserAnnotation } from '../Types/annotationType';
 import { BackendState, BackendTypeDeclaration, INITIAL_BACKEND_STATE } from '../Types/backendType';
 import { VisualizerType } from '../Types/visualizerType';
+import { heapIndexOf } from './heapIndex';
 
 export type UiState = {
   visualizerDimension: {
@@ -155,6 +156,8 @@ export const useGlobalStore: UseBoundStore<StoreApi<GlobalStateStore & GlobalSto
         );
       },
       updateNextFrame: (backendState: BackendState) => {
+        // Indexed as it arrives, so each parser parsing the frame finds its index built
+        heapIndexOf(backendState);
         set({ currFrame: backendState }, false, 'updateNextFrame');
       },
       clearTypeDeclarations: () => {
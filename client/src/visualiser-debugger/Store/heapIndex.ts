@@ -0,0 +1,96 @@
+import { Addr, BackendState, Heap, MemoryValue } from '../Types/backendType';
+
+/**
+ * The heap of a frame indexed once, when the frame arrives, for the parsers to query instead of
+ * each scanning every object for every annotation. Addresses are keyed as numbers so that the
+ * same address written with other leading zeros or letter case is the same key.
+ */
+export type HeapIndex = {
+  // Every object, by its address
+  byAddr: Map<number, MemoryValue>;
+  // The addresses of the objects of each type, in the order of the heap
+  byType: Map<string, Addr[]>;
+  // The addresses of the objects with a pointer to each object, by the address pointed to. Built
+  // by the first query, as it walks every value of the heap
+  pointedFrom?: Map<number, Addr[]>;
+};
+
+// Values of char pointers are followed by the string, e.g. '0x4052a0 "hello"'
+export const addrKey = (addr: string): number => Number.parseInt(addr.split(' ')[0], 16);
+
+const isAddrValue = (value: unknown): value is string =>
+  typeof value === 'string' && value.startsWith('0x');
+
+// Every address held anywhere in the value: in its fields, its cells and theirs
+const addrsIn = (value: MemoryValue): string[] => {
+  const addrs: string[] = [];
+  const stack: unknown[] = [value.value];
+  while (stack.length > 0) {
+    const curr = stack.pop();
+    if (isAddrValue(curr)) {
+      addrs.push(curr);
+    } else if (Array.isArray(curr)) {
+      curr.forEach((cell) => stack.push(cell));
+    } else if (typeof curr === 'object' && curr !== null) {
+      // A typed value names its type, a struct holds its fields by name, which may include value
+      const { type, typeName } = curr as { type?: unknown; typeName?: unknown };
+      const typed = 'value' in curr && [type, typeName].some((name) => typeof name === 'string');
+      stack.push(...(typed ? [curr.value] : Object.values(curr)));
+    }
+  }
+  return addrs;
+};
+
+// Only pointers into the heap, so null and stack pointers are left out
+const indexPointers = (index: HeapIndex): Map<number, Addr[]> => {
+  const pointedFrom: Map<number, Addr[]> = new Map();
+  index.byAddr.forEach((value) => {
+    new Set(addrsIn(value).map(addrKey)).forEach((to) => {
+      if (!index.byAddr.has(to)) return;
+      if (!pointedFrom.has(to)) pointedFrom.set(to, []);
+      pointedFrom.get(to)!.push(value.addr);
+    });
+  });
+  return pointedFrom;
+};
+
+export const indexHeap = (heap: Heap): HeapIndex => {
+  const byAddr: Map<number, MemoryValue> = new Map();
+  const byType: Map<string, Addr[]> = new Map();
+
+  (Object.entries(heap) as [Addr, MemoryValue][]).forEach(([addr, value]) => {
+    byAddr.set(addrKey(addr), value);
+    if ('typeName' in value) {
+      if (!byType.has(value.typeName)) byType.set(value.typeName, []);
+      byType.get(value.typeName)!.push(addr);
+    }
+  });
+
+  return { byAddr, byType };
+};
+
+// Indexes are kept for as long as their frames are, so parsing a frame again reuses its index
+const indexes: WeakMap<BackendState, HeapIndex> = new WeakMap();
+
+export const heapIndexOf = (state: BackendState): HeapIndex => {
+  let index = indexes.get(state);
+  if (!index) {
+    index = indexHeap(state.heap_data);
+    indexes.set(state, index);
+  }
+  return index;
+};
+
+export const objectAt = (index: HeapIndex, addr: string): MemoryValue | undefined =>
+  isAddrValue(addr) ? index.byAddr.get(addrKey(addr)) : undefined;
+
+// The objects of a type with their addresses, in the order of the heap
+export const objectsOfType = (index: HeapIndex, typeName: string): [Addr, MemoryValue][] =>
+  (index.byType.get(typeName) ?? []).map((addr) => [addr, index.byAddr.get(addrKey(addr))!]);
+
+// The objects with a pointer to the object at addr, in the order of the heap
+export const pointersTo = (index: HeapIndex, addr: string): Addr[] => {
+  if (!isAddrValue(addr)) return [];
+  if (!index.pointedFrom) index.pointedFrom = indexPointers(index);
+  return index.pointedFrom.get(addrKey(addr)) ?? [];
+};
@@ -0,0 +1,193 @@
+import {
+  Addr,
+  BackendState,
+  BackendTypeDeclaration,
+  Heap,
+  PointerTag,
+  Stack,
+} from '../Types/backendType';
+
+/**
+ * Reader for the seekable trace files written by debugger2/src/trace_file.py,
+ * the format is documented there.
+ *
+ * Only the header, string table and index are read up front, the state of a
+ * step is decoded from the keyframe before it and the deltas in between.
+ */
+
+const MAGIC = 'DSVT';
+const VERSION = 1;
+const FLAG_DEFLATE = 1;
+
+const HEADER_SIZE = 40;
+const INDEX_ENTRY_SIZE = 16;
+
+type Entries = [number, unknown][];
+type EncodedFrame = [number, number, number, Record<string, unknown>?];
+
+type Block = {
+  f?: EncodedFrame;
+  s?: Entries;
+  h?: Entries;
+  // Missing from files written before the debugger found heap blocks
+  b?: Entries;
+  p?: Entries;
+  S?: number[];
+  H?: number[];
+  B?: number[];
+  P?: number[];
+};
+
+type DecodedBlock = {
+  f: EncodedFrame;
+  s: Map<number, unknown>;
+  h: Map<number, unknown>;
+  b: Map<number, unknown>;
+  p: Map<number, unknown>;
+};
+
+const inflate = async (bytes: Uint8Array): Promise<Uint8Array> => {
+  const stream = new Blob([bytes]).stream().pipeThrough(new DecompressionStream('deflate'));
+  return new Uint8Array(await new Response(stream).arrayBuffer());
+};
+
+const applyDelta = (state: DecodedBlock, delta: Block): DecodedBlock => {
+  const result: DecodedBlock = {
+    f: delta.f ?? state.f,
+    s: new Map(state.s),
+    h: new Map(state.h),
+    b: new Map(state.b),
+    p: new Map(state.p),
+  };
+  delta.S?.forEach((key) => result.s.delete(key));
+  delta.H?.forEach((key) => result.h.delete(key));
+  delta.B?.forEach((key) => result.b.delete(key));
+  delta.P?.forEach((key) => result.p.delete(key));
+  delta.s?.forEach(([key, value]) => result.s.set(key, value));
+  delta.h?.forEach(([key, value]) => result.h.set(key, value));
+  delta.b?.forEach(([key, value]) => result.b.set(key, value));
+  delta.p?.forEach(([key, value]) => result.p.set(key, value));
+  return result;
+};
+
+export class TraceFile {
+  readonly stepCount: number;
+
+  readonly keyframeInterval: number;
+
+  private readonly view: DataView;
+
+  private readonly deflated: boolean;
+
+  private readonly strings: string[] = [];
+
+  private readonly typesOffset: number;
+
+  private readonly indexOffset: number;
+
+  // The last state decoded, so scrubbing forwards applies one delta per step
+  private last: { step: number; state: DecodedBlock } | null = null;
+
+  private readonly decoder = new TextDecoder();
+
+  constructor(buffer: ArrayBuffer) {
+    this.view = new DataView(buffer);
+    if (buffer.byteLength < HEADER_SIZE || this.text(0, 4) !== MAGIC) {
+      throw new Error('Not a trace file');
+    }
+    const version = this.view.getUint16(4, true);
+    if (version > VERSION) {
+      throw new Error(`Trace file version ${version} is newer than this visualiser`);
+    }
+
+    // eslint-disable-next-line no-bitwise
+    this.deflated = (this.view.getUint16(6, true) & FLAG_DEFLATE) !== 0;
+    this.stepCount = this.view.getUint32(8, true);
+    this.keyframeInterval = this.view.getUint32(12, true);
+    const stringsOffset = Number(this.view.getBigUint64(16, true));
+    this.typesOffset = Number(this.view.getBigUint64(24, true));
+    this.indexOffset = Number(this.view.getBigUint64(32, true));
+
+    const count = this.view.getUint32(stringsOffset, true);
+    let offset = stringsOffset + 4;
+    for (let i = 0; i < count; i += 1) {
+      const length = this.view.getUint32(offset, true);
+      this.strings.push(this.text(offset + 4, length));
+      offset += 4 + length;
+    }
+  }
+
+  async types(): Promise<BackendTypeDeclaration[]> {
+    const length = this.view.getUint32(this.typesOffset, true);
+    return this.load<BackendTypeDeclaration[]>(this.typesOffset + 4, length);
+  }
+
+  async state(step: number): Promise<BackendState> {
+    if (step < 0 || step >= this.stepCount) {
+      throw new RangeError(`No step ${step}, only 0 to ${this.stepCount - 1}`);
+    }
+
+    const keyframe = step - (step % this.keyframeInterval);
+    let start = keyframe;
+    let state: DecodedBlock;
+    if (this.last && this.last.step >= keyframe && this.last.step <= step) {
+      start = this.last.step;
+      state = this.last.state;
+    } else {
+      const block = await this.block(keyframe);
+      state = {
+        f: block.f as EncodedFrame,
+        s: new Map(block.s),
+        h: new Map(block.h),
+        b: new Map(block.b),
+        p: new Map(block.p),
+      };
+    }
+    for (let delta = start + 1; delta <= step; delta += 1) {
+      // eslint-disable-next-line no-await-in-loop
+      state = applyDelta(state, await this.block(delta));
+    }
+
+    this.last = { step, state };
+    return this.decode(state);
+  }
+
+  private decode(state: DecodedBlock): BackendState {
+    const [file, func, lineNum, other] = state.f;
+    const section = (entries: Map<number, unknown>) =>
+      Object.fromEntries([...entries].map(([key, value]) => [this.strings[key], value]));
+
+    return {
+      frame_info: {
+        file: this.strings[file],
+        function: this.strings[func],
+        line_num: lineNum,
+        line: '',
+        ...other,
+      },
+      stack_data: section(state.s) as Stack,
+      heap_data: section(state.h) as Heap,
+      ...(state.b.size > 0 && { heap_blocks: section(state.b) as Record<Addr, number> }),
+      ...(state.p.size > 0 && { pointers: section(state.p) as Record<Addr, PointerTag> }),
+    };
+  }
+
+  private async block(step: number): Promise<Block> {
+    const entry = this.indexOffset + step * INDEX_ENTRY_SIZE;
+    const offset = Number(this.view.getBigUint64(entry, true));
+    const length = this.view.getUint32(entry + 8, true);
+    return this.load<Block>(offset, length);
+  }
+
+  private async load<T>(offset: number, length: number): Promise<T> {
+    let bytes = new Uint8Array(this.view.buffer, offset, length);
+    if (this.deflated) {
+      bytes = await inflate(bytes);
+    }
+    return JSON.parse(this.decoder.decode(bytes)) as T;
+  }
+
+  private text(offset: number, length: number): string {
+    return this.decoder.decode(new Uint8Array(this.view.buffer, offset, length));
+  }
+}
@@ -0,0 +1,140 @@
+import { MappedState, useFrontendStateStore } from '../Store/frontendStateStore';
+import { useGlobalStore } from '../Store/globalStateStore';
+import { INITIAL_BACKEND_STATE } from '../Types/backendType';
+import { INITIAL_GRAPH } from '../Types/frontendType';
+import { TraceFile } from './traceFile';
+
+/**
+ * Trace files kept in IndexedDB, so a walkthrough that was opened once can be
+ * replayed without the debugger server.
+ */
+
+const DEBUGGER_URL = import.meta.env.VITE_DEBUGGER_URL || 'http://localhost:8000';
+const DB_NAME = 'visualiser-traces';
+// Version 1 kept bare buffers, without the ETag to revalidate them with
+const DB_VERSION = 2;
+const STORE_NAME = 'traces';
+
+type SavedTrace = {
+  etag: string | null;
+  buffer: ArrayBuffer;
+};
+
+const openDatabase = (): Promise<IDBDatabase> =>
+  new Promise((resolve, reject) => {
+    const request = indexedDB.open(DB_NAME, DB_VERSION);
+    request.onupgradeneeded = () => {
+      if (request.result.objectStoreNames.contains(STORE_NAME)) {
+        request.result.deleteObjectStore(STORE_NAME);
+      }
+      request.result.createObjectStore(STORE_NAME);
+    };
+    request.onsuccess = () => resolve(request.result);
+    request.onerror = () => reject(request.error);
+  });
+
+const transact = async <T>(
+  mode: IDBTransactionMode,
+  action: (store: IDBObjectStore) => IDBRequest<T>
+): Promise<T> => {
+  const db = await openDatabase();
+  return new Promise<T>((resolve, reject) => {
+    const request = action(db.transaction(STORE_NAME, mode).objectStore(STORE_NAME));
+    request.onsuccess = () => resolve(request.result);
+    request.onerror = () => reject(request.error);
+  }).finally(() => db.close());
+};
+
+const saveTrace = (url: string, trace: SavedTrace) =>
+  transact('readwrite', (store) => store.put(trace, url));
+
+const loadSavedTrace = (url: string) =>
+  transact<SavedTrace | undefined>('readonly', (store) => store.get(url));
+
+/**
+ * Paths such as /traces/<name> are relative to the debugger server. Traces are
+ * keyed by their full URL. The copy in IndexedDB is revalidated by its ETag, as
+ * a name can be saved over, and used as is when the server can't be reached.
+ */
+export const fetchTrace = async (url: string): Promise<TraceFile> => {
+  const fullUrl = new URL(url, DEBUGGER_URL).toString();
+  const saved = await loadSavedTrace(fullUrl);
+  let response: Response;
+  try {
+    response = await fetch(fullUrl, {
+      headers: saved?.etag ? { 'If-None-Match': saved.etag } : {},
+    });
+  } catch (error) {
+    if (saved) return new TraceFile(saved.buffer);
+    throw error;
+  }
+
+  if (saved && response.status === 304) {
+    return new TraceFile(saved.buffer);
+  }
+  if (!response.ok) {
+    throw new Error(`Failed to download trace: ${response.status} ${response.statusText}`);
+  }
+  const buffer = await response.arrayBuffer();
+  await saveTrace(fullUrl, { etag: response.headers.get('ETag'), buffer });
+  return new TraceFile(buffer);
+};
+
+// Steps of a trace not decoded yet
+const PENDING: MappedState = { backendState: INITIAL_BACKEND_STATE, frontendState: INITIAL_GRAPH };
+
+// The trace being played, and how to stop decoding its steps
+let playing: { trace: TraceFile; stop: () => void } | null = null;
+
+const decodeStep = async (trace: TraceFile, step: number) => {
+  const state = await trace.state(step);
+  if (playing?.trace !== trace) return state;
+  const { parser, userAnnotation } = useGlobalStore.getState().visualizer;
+  const frontendState = parser.parseState(state, userAnnotation);
+  useFrontendStateStore.getState().replaceState(step, state, frontendState);
+  return state;
+};
+
+/**
+ * Replace the current session with the steps of a trace, which can then be
+ * scrubbed with the timeline like a live session. Steps are only decoded once
+ * the timeline reaches them, each from the keyframe before it.
+ */
+export const playTrace = async (trace: TraceFile) => {
+  const globalStore = useGlobalStore.getState();
+  const frontendStore = useFrontendStateStore.getState();
+
+  playing?.stop();
+  globalStore.updateNextFrame(INITIAL_BACKEND_STATE);
+  frontendStore.clearFrontendState();
+  globalStore.clearTypeDeclarations();
+  (await trace.types()).forEach((type) => globalStore.updateTypeDeclaration(type));
+  if (trace.stepCount === 0) return;
+
+  frontendStore.loadStates(Array(trace.stepCount).fill(PENDING));
+  frontendStore.setOffline(true);
+  const decoding = new Set<number>();
+  const unsubscribe = useFrontendStateStore.subscribe(({ states, currentIndex, offline }) => {
+    if (!offline) {
+      // A live session replaced the trace
+      playing?.stop();
+    } else if (states[currentIndex] === PENDING && !decoding.has(currentIndex)) {
+      decoding.add(currentIndex);
+      decodeStep(trace, currentIndex).catch(console.error);
+    }
+  });
+  playing = {
+    trace,
+    stop: () => {
+      unsubscribe();
+      playing = null;
+    },
+  };
+
+  // The timeline re-parses the last frame when annotations change
+  const last = await decodeStep(trace, trace.stepCount - 1);
+  if (playing?.trace !== trace) return;
+  globalStore.updateNextFrame(last);
+  frontendStore.setActive(true);
+  frontendStore.jumpToState(0);
+};
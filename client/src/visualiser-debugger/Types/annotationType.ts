@@ -1,4 +1,4 @@
-import { StructType, Name, PointerType, MemoryValue, IntType, NativeTypeName } from './backendType';
+import { StructType, Name, PointerType, IntType, NativeTypeName } from './backendType';
 
 /**
  * TODO: This file needs a deep rework, it's not generic enough
@@ -6,6 +6,7 @@ import { StructType, Name, PointerType, MemoryValue, IntType, NativeTypeName } f
 export enum DataStructureType {
   LinkedList,
   BinaryTree,
+  Graph,
 }
 export interface DataStructureAnnotationBase {
   typeName: NativeTypeName;
@@ -50,7 +51,43 @@ export interface BinaryTreeAnnotation extends DataStructureAnnotationBase {
   };
 }
 
-export type DataStructureAnnotationConcrete = LinkedListAnnotation | BinaryTreeAnnotation;
+/**
+ * Mapping from an adjacency list graph to the user's own graph struct: a vertex count and a
+ * malloced array of list heads, one per vertex, whose list nodes are its edges
+ *
+ * Annotate on type definition, used for heap data.
+ */
+export interface GraphAnnotation extends DataStructureAnnotationBase {
+  typeName: StructType['typeName'];
+  type: DataStructureType.Graph;
+  vertexCount: {
+    typeName: NativeTypeName;
+    name: Name;
+  };
+  adjacencyLists: {
+    // Condition: Must be a pointer to pointers to the edge struct
+    typeName: PointerType['typeName'];
+    name: Name;
+  };
+  edge: {
+    typeName: StructType['typeName'];
+    // The vertex the edge leads to
+    vertex: {
+      typeName: NativeTypeName;
+      name: Name;
+    };
+    next: {
+      // Condition: Must be self-referencing
+      typeName: PointerType['typeName'];
+      name: Name;
+    };
+  };
+}
+
+export type DataStructureAnnotationConcrete =
+  | LinkedListAnnotation
+  | BinaryTreeAnnotation
+  | GraphAnnotation;
 
 /**
  * Local element annotation. Used for stack data.
@@ -72,7 +109,19 @@ export interface ArrayElementPointer extends LocalAnnotationBase {
    */
 }
 
-export type LocalAnnotationConcrete = ArrayElementPointer | LinkedListNodePointer;
+/**
+ * A 2D array, an array of pointers to rows, or a flat array with the length of its rows in
+ * another variable
+ */
+export interface MatrixVariable {
+  typeName: string;
+  matrix: {
+    // The int variable holding the row length of a flat array, null if the type tells it
+    columns: Name | null;
+  };
+}
+
+export type LocalAnnotationConcrete = ArrayElementPointer | LinkedListNodePointer | MatrixVariable;
 
 /**
  * Map from variable names to user annotations of that
@@ -86,21 +135,12 @@ export interface UserAnnotation {
   typeAnnotation: { [name: Name]: DataStructureAnnotationConcrete };
 }
 
-/**
- * Type guard to check if a memory value is a linked list node
- */
-export const isLinkedListNode = (
-  memoryValue: MemoryValue,
-  linkedListAnnotation: LinkedListAnnotation
-) => {
-  return 'typeName' in memoryValue && memoryValue.typeName === linkedListAnnotation.typeName;
-};
-
-export const isTreeNode = (
-  memoryValue: MemoryValue,
-  binaryTreeAnnotation: BinaryTreeAnnotation
-) => {
-  return 'typeName' in memoryValue && memoryValue.typeName === binaryTreeAnnotation.typeName;
+export const isMatrixVariable = (
+  localAnnotation: LocalAnnotationConcrete | null | undefined
+): localAnnotation is MatrixVariable => {
+  return (
+    typeof localAnnotation === 'object' && localAnnotation !== null && 'matrix' in localAnnotation
+  );
 };
 
 export enum FieldType {
@@ -136,11 +176,13 @@ export type PossibleStructAnnotation = {
 
 export enum BackendTypeRole {
   LinkedList = 'Linked List Node',
+  Graph = 'Graph',
   Empty = 'Not Visualized',
 }
 
 export enum StackVariableRole {
   LinkedListPointer = 'Linked List Node',
+  Matrix = 'Matrix',
   Empty = 'Not Visualized',
 }
 
@@ -155,3 +197,15 @@ export type PossibleLinkedListAnnotation = {
     typeName: PointerType['typeName'];
   }[];
 };
+
+export type PossibleGraphAnnotation = {
+  typeName: StructType['typeName'];
+  possibleCounts: {
+    name: Name;
+    typeName: NativeTypeName;
+  }[];
+  possibleLists: {
+    name: Name;
+    typeName: PointerType['typeName'];
+  }[];
+};
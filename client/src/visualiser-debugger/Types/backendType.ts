@@ -88,14 +88,27 @@ export type TypedValue =
   | SizetValue
   | ArrayValue;
 
-export type MemoryValue = TypedValue & { addr: Addr };
+export type MemoryValue = TypedValue & {
+  addr: Addr;
+  // The debugger stopped following this value's pointers, see expandObject
+  truncated?: boolean;
+  // Arrays and long strings are sent as their first page, see readRange
+  length?: number;
+  elementType?: string;
+};
 export type NativeType = TypedValue['type'];
 export type Value = TypedValue['value'];
 export type NativeTypeName = NativeType['typeName'];
 
 export type Stack = Record<Name, MemoryValue>;
+
 export type Heap = Record<Addr, MemoryValue>;
 
+/**
+ * What a pointer points to, see debugger2/src/debugger/address_space.py
+ */
+export type PointerTag = 'null' | 'heap' | 'dangling' | 'stack' | 'global' | 'invalid';
+
 export type BackendState = {
   frame_info: {
     file: string;
@@ -105,6 +118,49 @@ export type BackendState = {
   };
   stack_data: Stack;
   heap_data: Heap;
+  // Every live malloc block and its usable size, reachable or not
+  heap_blocks?: Record<Addr, number>;
+  // What each pointer in the state points to, by its value
+  pointers?: Record<Addr, PointerTag>;
+};
+
+/**
+ * Objects reachable from a truncated value, traced on request
+ */
+export type ObjectExpansion = {
+  step: number;
+  addr: Addr;
+  typeName: string;
+  heap_data: Heap;
+};
+
+/**
+ * Cells [start, start + count) of an array or string in the state after a step
+ */
+export type RangeRequest = {
+  step: number;
+  addr: Addr;
+  elementType: string;
+  start: number;
+  count: number;
+};
+
+export type CellRange = {
+  step: number;
+  addr: Addr;
+  start: number;
+  // Empty for a step the debugger can no longer read
+  cells: unknown[];
+};
+
+/**
+ * Stack variables and types the debugger traces first, and for a struct type the field counting
+ * the cells of each of its malloced array fields, which the heap alone can't tell
+ */
+export type AnnotatedRoots = {
+  variables: Name[];
+  types: string[];
+  lengths: { [typeName: string]: { [arrayField: Name]: Name } };
 };
 
 export type ProgramEnd = {
@@ -1,6 +1,7 @@
 import { EdgeEntity } from '../Component/Visualizer/Entities/BaseEntity/edgeEntity';
 import { NodeEntity } from '../Component/Visualizer/Entities/BaseEntity/nodeEntity';
 import { PointerEntity } from '../Component/Visualizer/Entities/BaseEntity/pointerEntity';
+import { Addr } from './backendType';
 
 export type EntityConcrete = NodeEntity | EdgeEntity | PointerEntity;
 
@@ -31,4 +32,43 @@ export interface FrontendTreeGraph extends GenericGraph {
   pointers: PointerEntity[];
 }
 
+/**
+ * A 2D array as a grid of numbers, drawn as a heat map
+ */
+export interface Matrix {
+  // The variable it is read from
+  uid: string;
+  elementType: string;
+  rows: number;
+  columns: number;
+  // Row-major, NaN for cells that are not numbers or were not sent
+  cells: Float64Array;
+  // 1 for cells different from the same matrix in the frame before
+  changed: Uint8Array;
+  source?: MatrixSource;
+}
+
+/**
+ * Where the cells of a matrix are in the program, to read those that did not come with the state
+ */
+export interface MatrixSource {
+  // Cell (r, c) is cell r * columns + c of the array at addr, or cell c of the row that cell r of
+  // the array at addr points to
+  layout: 'flat' | 'rows';
+  addr: Addr;
+  // The cells of the array at addr
+  length: number;
+  elementType: string;
+  // Of the array at addr, for rows
+  pointerType?: string;
+  // How many cells of each row came with the state
+  sent: number[];
+  // The pointers to rows that came with the state, for rows
+  rows?: (Addr | undefined)[];
+}
+
+export interface FrontendMatrixState extends GenericGraph {
+  matrices: Matrix[];
+}
+
 export type FrontendState = GenericGraph;
@@ -3,4 +3,5 @@ export enum VisualizerType {
   BINARY_TREE = 'BINARY_TREE',
   GRAPH = 'GRAPH',
   ARRAY = 'ARRAY',
+  MATRIX = 'MATRIX',
 }
@@ -4,6 +4,7 @@ import { Documentation } from 'visualiser-src/common/typedefs';
 import { injectIds } from 'visualiser-src/common/helpers';
 import GraphicalTreeTraversal from 'visualiser-src/binary-search-tree-visualiser/data-structure/GraphicalTreeTraversal';
 import BSTTraverseAnimationProducer from 'visualiser-src/binary-search-tree-visualiser/animation-producer/BSTTraverseAnimationProducer';
+import GraphicalBSTNode from 'visualiser-src/binary-search-tree-visualiser/data-structure/GraphicalBSTNode';
 import updateNodePositions from 'visualiser-src/binary-search-tree-visualiser/util/helpers';
 import AVLAnimationProducer from '../animation-producer/AVLAnimationProducer';
 import GraphicalAVLNode from './GraphicalAVLNode';
@@ -28,6 +29,14 @@ class GraphicalAVL extends GraphicalDataStructure {
       args: [],
       description: 'Executes a postorder traversal on the tree.',
     },
+    bulkInsert: {
+      args: ['values'],
+      description: 'Inserts all the values in the order given, animated as a single step.',
+    },
+    buildBalanced: {
+      args: ['values'],
+      description: 'Rebuilds the tree as balanced as possible, with the values added to it.',
+    },
   });
 
   public root: GraphicalAVLNode | null = null;
@@ -48,6 +57,86 @@ class GraphicalAVL extends GraphicalDataStructure {
     return animationProducer;
   }
 
+  public bulkInsert(values: number[]): AVLAnimationProducer {
+    const animationProducer = new AVLAnimationProducer();
+    const created = new Set<GraphicalBSTNode>();
+    values.forEach((value) => {
+      this.root = GraphicalAVL.insertValue(this.root, value, created);
+    });
+    // Laid out once, rather than after every insertion and rotation
+    updateNodePositions(this.root);
+    animationProducer.doAnimation(animationProducer.updateBuiltTree, this.root, created);
+    return animationProducer;
+  }
+
+  public buildBalanced(values: number[]): AVLAnimationProducer {
+    const animationProducer = new AVLAnimationProducer();
+    const created = new Set<GraphicalBSTNode>();
+    this.root = GraphicalTreeGenerate.buildBalanced(
+      this.root,
+      values,
+      GraphicalAVLNode.from,
+      created
+    );
+    GraphicalAVL.updateHeight(this.root);
+    updateNodePositions(this.root);
+    animationProducer.doAnimation(animationProducer.updateBuiltTree, this.root, created);
+    return animationProducer;
+  }
+
+  // AVL insertion into the model alone, returning the new root of the subtree
+  private static insertValue(
+    node: GraphicalAVLNode | null,
+    input: number,
+    created: Set<GraphicalBSTNode>
+  ): GraphicalAVLNode {
+    if (node === null) {
+      const newNode = GraphicalAVLNode.from(input);
+      created.add(newNode);
+      return newNode;
+    }
+    if (input < node.value) {
+      node.left = GraphicalAVL.insertValue(node.left, input, created);
+    } else if (input > node.value) {
+      node.right = GraphicalAVL.insertValue(node.right, input, created);
+    } else {
+      return node;
+    }
+
+    node.updateHeight();
+    if (node.balance > 1) {
+      if (input > node.left.value) {
+        node.left = GraphicalAVL.rotatedLeft(node.left);
+      }
+      return GraphicalAVL.rotatedRight(node);
+    }
+    if (node.balance < -1) {
+      if (input < node.right.value) {
+        node.right = GraphicalAVL.rotatedRight(node.right);
+      }
+      return GraphicalAVL.rotatedLeft(node);
+    }
+    return node;
+  }
+
+  private static rotatedLeft(node: GraphicalAVLNode): GraphicalAVLNode {
+    const newRoot = node.right;
+    node.right = newRoot.left;
+    newRoot.left = node;
+    node.updateHeight();
+    newRoot.updateHeight();
+    return newRoot;
+  }
+
+  private static rotatedRight(node: GraphicalAVLNode): GraphicalAVLNode {
+    const newRoot = node.left;
+    node.left = newRoot.right;
+    newRoot.right = node;
+    node.updateHeight();
+    newRoot.updateHeight();
+    return newRoot;
+  }
+
   public inorderTraversal(): BSTTraverseAnimationProducer {
     return GraphicalTreeTraversal.inorderTraversal(this.root);
   }
@@ -84,7 +173,12 @@ class GraphicalAVL extends GraphicalDataStructure {
       if (root.left == null) {
         root.left = GraphicalAVLNode.from(input);
         updateNodePositions(this.root);
-        animationProducer.doAnimationAndHighlight(3, animationProducer.createNode, root.left, true);
+        animationProducer.doAnimationAndHighlight(
+          3,
+          animationProducer.createNodeInTree,
+          this.root,
+          root.left
+        );
         animationProducer.doAnimation(animationProducer.unhighlightNode, root.left);
       } else if (!this.doInsert(root, root.left, true, input, animationProducer)) {
         return false;
@@ -103,9 +197,9 @@ class GraphicalAVL extends GraphicalDataStructure {
         updateNodePositions(this.root);
         animationProducer.doAnimationAndHighlight(
           3,
-          animationProducer.createNode,
-          root.right,
-          true
+          animationProducer.createNodeInTree,
+          this.root,
+          root.right
         );
         animationProducer.doAnimation(animationProducer.unhighlightNode, root.right);
       } else if (!this.doInsert(root, root.right, false, input, animationProducer)) {
@@ -202,7 +296,8 @@ class GraphicalAVL extends GraphicalDataStructure {
       parent.right = newRoot;
     }
     updateNodePositions(this.root);
-    animationProducer.doAnimation(animationProducer.updateAndUnhighlightBST, newRoot);
+    // The whole tree, as the rest of it can move to make room for the new subtree
+    animationProducer.doAnimation(animationProducer.updateAndUnhighlightBST, this.root);
   }
 
   private rotateRight(
@@ -251,7 +346,8 @@ class GraphicalAVL extends GraphicalDataStructure {
       parent.right = newRoot;
     }
     updateNodePositions(this.root);
-    animationProducer.doAnimation(animationProducer.updateAndUnhighlightBST, newRoot);
+    // The whole tree, as the rest of it can move to make room for the new subtree
+    animationProducer.doAnimation(animationProducer.updateAndUnhighlightBST, this.root);
   }
 
   public generate(): void {
@@ -259,6 +355,10 @@ class GraphicalAVL extends GraphicalDataStructure {
     GraphicalAVL.updateHeight(this.root);
   }
 
+  public render(): void {
+    GraphicalTreeGenerate.render(this.root);
+  }
+
   private static updateHeight(root: GraphicalAVLNode | null) {
     if (root == null) {
       return;
@@ -288,6 +388,7 @@ class GraphicalAVL extends GraphicalDataStructure {
 
   public load(data: number[]): void {
     this.root = GraphicalTreeGenerate.loadTree<GraphicalAVLNode>(GraphicalAVLNode.from, data);
+    GraphicalAVL.updateHeight(this.root);
   }
 }
 
@@ -1,8 +1,9 @@
 import { Line, Marker } from '@svgdotjs/svg.js';
-import { lineDiffY, canvasPadding } from '../../common/settings';
+import { lineDiffY } from '../../common/settings';
 import { getPointerStartEndCoordinates } from '../../common/helpers';
 import AnimationProducer from '../../common/AnimationProducer';
 import GraphicalBSTNode from '../data-structure/GraphicalBSTNode';
+import { getChildDiffX } from '../util/helpers';
 
 export default class BSTAnimationProducer extends AnimationProducer {
   public highlightNode(node: GraphicalBSTNode): void {
@@ -132,11 +133,7 @@ export default class BSTAnimationProducer extends AnimationProducer {
   // returns the difference in x coordinates with the node
   // and it's two child nodes
   public static getLineDiffX(node: GraphicalBSTNode): number {
-    const canvasWidth = document.getElementById('visualiser-container')!.offsetWidth;
-    const depth: number = (node.y - canvasPadding) / 75;
-    const baseDiff = canvasWidth / 4;
-
-    return baseDiff / 2 ** depth;
+    return getChildDiffX(node);
   }
 
   public unhighlightBST(root: GraphicalBSTNode): void {
@@ -29,6 +29,12 @@ export default class BSTInsertAnimationProducer extends BSTAnimationProducer {
     );
   }
 
+  // Creates a node where the layout put it, while the rest of the tree moves to make room
+  public createNodeInTree(root: GraphicalBSTNode, node: GraphicalBSTNode): void {
+    this.updateBST(root);
+    this.createNode(node, true);
+  }
+
   // draws a node on the draw canvas and shows the node
   public createNode(node: GraphicalBSTNode, highlight: boolean = false): void {
     // based on the depth of the node we are able to create left and right svg line targets
@@ -91,4 +97,28 @@ export default class BSTInsertAnimationProducer extends BSTAnimationProducer {
       );
     }
   }
+
+  // Animates a tree built or grown in one go as a single step: the created nodes fade in at
+  // their places while the others move to theirs
+  public updateBuiltTree(node: GraphicalBSTNode | null, created: Set<GraphicalBSTNode>): void {
+    if (node === null) {
+      return;
+    }
+
+    if (created.has(node)) {
+      this.createNode(node);
+    } else {
+      this.updateNode(node, node.x, node.y);
+      this.updateNodeLines(node);
+    }
+    this.addSequenceAnimation(
+      node.leftLineTarget.animate(400).attr({ opacity: node.left === null ? 0 : 1 })
+    );
+    this.addSequenceAnimation(
+      node.rightLineTarget.animate(400).attr({ opacity: node.right === null ? 0 : 1 })
+    );
+
+    this.updateBuiltTree(node.left, created);
+    this.updateBuiltTree(node.right, created);
+  }
 }
@@ -41,6 +41,14 @@ class GraphicalBST extends GraphicalDataStructure {
       args: [],
       description: 'Executes a postorder traversal on the tree.',
     },
+    bulkInsert: {
+      args: ['values'],
+      description: 'Inserts all the values in the order given, animated as a single step.',
+    },
+    buildBalanced: {
+      args: ['values'],
+      description: 'Rebuilds the tree as balanced as possible, with the values added to it.',
+    },
   });
 
   public root: GraphicalBSTNode | null = null;
@@ -60,6 +68,61 @@ class GraphicalBST extends GraphicalDataStructure {
     return animationProducer;
   }
 
+  public bulkInsert(values: number[]): BSTInsertAnimationProducer {
+    const animationProducer = new BSTInsertAnimationProducer();
+    const created = new Set<GraphicalBSTNode>();
+    values.forEach((value) => {
+      this.root = GraphicalBST.insertValue(this.root, value, created);
+    });
+    // Laid out once, rather than after every insertion
+    updateNodePositions(this.root);
+    animationProducer.doAnimation(animationProducer.updateBuiltTree, this.root, created);
+    return animationProducer;
+  }
+
+  public buildBalanced(values: number[]): BSTInsertAnimationProducer {
+    const animationProducer = new BSTInsertAnimationProducer();
+    const created = new Set<GraphicalBSTNode>();
+    this.root = GraphicalTreeGenerate.buildBalanced(
+      this.root,
+      values,
+      GraphicalBSTNode.from,
+      created
+    );
+    updateNodePositions(this.root);
+    animationProducer.doAnimation(animationProducer.updateBuiltTree, this.root, created);
+    return animationProducer;
+  }
+
+  // Inserts into the model alone, returning the new root
+  private static insertValue(
+    root: GraphicalBSTNode | null,
+    input: number,
+    created: Set<GraphicalBSTNode>
+  ): GraphicalBSTNode {
+    let parent: GraphicalBSTNode | null = null;
+    let curr: GraphicalBSTNode | null = root;
+    while (curr !== null) {
+      if (input === curr.value) {
+        return root as GraphicalBSTNode;
+      }
+      parent = curr;
+      curr = input < curr.value ? curr.left : curr.right;
+    }
+
+    const node = GraphicalBSTNode.from(input);
+    created.add(node);
+    if (parent === null) {
+      return node;
+    }
+    if (input < parent.value) {
+      parent.left = node;
+    } else {
+      parent.right = node;
+    }
+    return root as GraphicalBSTNode;
+  }
+
   public delete(input: number): BSTDeleteAnimationProducer {
     const animationProducer: BSTDeleteAnimationProducer = new BSTDeleteAnimationProducer();
     animationProducer.renderDeleteCode();
@@ -207,6 +270,10 @@ class GraphicalBST extends GraphicalDataStructure {
     this.root = GraphicalTreeGenerate.generate<GraphicalBSTNode>(GraphicalBSTNode.from);
   }
 
+  public render(): void {
+    GraphicalTreeGenerate.render(this.root);
+  }
+
   public inorderTraversal() {
     return GraphicalTreeTraversal.inorderTraversal(this.root);
   }
@@ -436,7 +503,12 @@ class GraphicalBST extends GraphicalDataStructure {
       if (root.left == null) {
         root.left = GraphicalBSTNode.from(input);
         updateNodePositions(this.root);
-        animationProducer.doAnimationAndHighlight(3, animationProducer.createNode, root.left, true);
+        animationProducer.doAnimationAndHighlight(
+          3,
+          animationProducer.createNodeInTree,
+          this.root,
+          root.left
+        );
       } else {
         this.doInsert(root.left, input, animationProducer);
       }
@@ -454,9 +526,9 @@ class GraphicalBST extends GraphicalDataStructure {
         updateNodePositions(this.root);
         animationProducer.doAnimationAndHighlight(
           3,
-          animationProducer.createNode,
-          root.right,
-          true
+          animationProducer.createNodeInTree,
+          this.root,
+          root.right
         );
       } else {
         this.doInsert(root.right, input, animationProducer);
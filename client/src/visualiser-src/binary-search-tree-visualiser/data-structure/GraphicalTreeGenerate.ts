@@ -1,6 +1,8 @@
 import { generateNumbers } from 'visualiser-src/common/RandomNumGenerator';
+import { getPointerStartEndCoordinates } from 'visualiser-src/common/helpers';
+import { lineDiffY } from 'visualiser-src/common/settings';
 import GraphicalBSTNode from './GraphicalBSTNode';
-import BSTCreateAnimationProducer from '../animation-producer/BSTCreateAnimationProducer';
+import BSTAnimationProducer from '../animation-producer/BSTAnimationProducer';
 import updateNodePositions from '../util/helpers';
 
 export default class GraphicalTreeGenerate {
@@ -27,16 +29,90 @@ export default class GraphicalTreeGenerate {
     return newNode;
   }
 
-  private static create<T extends GraphicalBSTNode>(root: T | null): void {
-    const producer = new BSTCreateAnimationProducer();
-    producer.createTree(root);
+  // Rebuilds a tree balanced with the given values added to it, reusing its nodes. Takes O(n)
+  // once the new values are sorted, and adds the nodes it creates to created.
+  public static buildBalanced<T extends GraphicalBSTNode>(
+    root: T | null,
+    values: number[],
+    createNode: (arg0: number) => T,
+    created: Set<GraphicalBSTNode>
+  ): T | null {
+    const nodes: T[] = [];
+    GraphicalTreeGenerate.collectInOrder(root, nodes);
+    const newValues = [...new Set(values)].sort((a, b) => a - b);
+
+    // Merge the new values into the tree's, which are in order already
+    const merged: T[] = [];
+    let i = 0;
+    newValues.forEach((value) => {
+      while (i < nodes.length && nodes[i].value < value) {
+        merged.push(nodes[i]);
+        i += 1;
+      }
+      if (i === nodes.length || nodes[i].value !== value) {
+        const node = createNode(value);
+        created.add(node);
+        merged.push(node);
+      }
+    });
+    merged.push(...nodes.slice(i));
+
+    return GraphicalTreeGenerate.linkBalanced(merged, 0, merged.length);
+  }
+
+  private static collectInOrder<T extends GraphicalBSTNode>(node: T | null, nodes: T[]): void {
+    if (node === null) {
+      return;
+    }
+    GraphicalTreeGenerate.collectInOrder(node.left as T | null, nodes);
+    nodes.push(node);
+    GraphicalTreeGenerate.collectInOrder(node.right as T | null, nodes);
+  }
+
+  // Like recurseArrInsert, for nodes that exist already
+  private static linkBalanced<T extends GraphicalBSTNode>(
+    nodes: T[],
+    start: number,
+    end: number
+  ): T | null {
+    if (end - start === 0) {
+      return null;
+    }
+    const mid = Math.floor((end + start) / 2);
+    const node = nodes[mid];
+    node.left = GraphicalTreeGenerate.linkBalanced(nodes, start, mid);
+    node.right = GraphicalTreeGenerate.linkBalanced(nodes, mid + 1, end);
+    return node;
+  }
+
+  // Draws a tree as it is, where BSTInsertAnimationProducer.createNode would animate each node to
+  public static render(root: GraphicalBSTNode | null): void {
+    updateNodePositions(root);
+    GraphicalTreeGenerate.renderRecursive(root);
+  }
+
+  private static renderRecursive(node: GraphicalBSTNode | null): void {
+    if (node === null) {
+      return;
+    }
+    const lineDiffX = BSTAnimationProducer.getLineDiffX(node);
+    node.leftLineTarget
+      .plot(getPointerStartEndCoordinates(node.x, node.y, node.x - lineDiffX, node.y + lineDiffY))
+      .opacity(node.left === null ? 0 : 1);
+    node.rightLineTarget
+      .plot(getPointerStartEndCoordinates(node.x, node.y, node.x + lineDiffX, node.y + lineDiffY))
+      .opacity(node.right === null ? 0 : 1);
+    node.nodeTarget.cx(node.x).cy(node.y).opacity(1);
+    node.textTarget.cx(node.x).cy(node.y).opacity(1);
+
+    GraphicalTreeGenerate.renderRecursive(node.left);
+    GraphicalTreeGenerate.renderRecursive(node.right);
   }
 
   public static generate<T extends GraphicalBSTNode>(createNode: (arg0: number) => T): T | null {
     const num = generateNumbers().sort((a, b) => a - b);
     const root = GraphicalTreeGenerate.recurseArrInsert(num, 0, num.length, createNode);
-    updateNodePositions(root);
-    GraphicalTreeGenerate.create(root);
+    GraphicalTreeGenerate.render(root);
     return root;
   }
 
@@ -47,9 +123,7 @@ export default class GraphicalTreeGenerate {
   ): T | null {
     const size = data.length;
     const root = GraphicalTreeGenerate.constructTreeUtil(createNode, data, 0, size - 1);
-
-    updateNodePositions(root);
-    GraphicalTreeGenerate.create(root);
+    GraphicalTreeGenerate.render(root);
     return root;
   }
 
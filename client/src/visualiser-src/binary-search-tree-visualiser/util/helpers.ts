@@ -1,31 +1,120 @@
+import { actualNodeDiameter } from '../../common/constants';
 import { lineDiffY, canvasPadding } from '../../common/settings';
 import GraphicalBSTNode from '../data-structure/GraphicalBSTNode';
 
-// Updates node positions of a tree
-const updateNodePositionsRecursive = (
-  node: GraphicalBSTNode | null,
-  low: number,
-  high: number,
-  mid: number,
-  y: number
-) => {
+// Closest the centres of two nodes on the same level can be
+const nodeSeparation = actualNodeDiameter + 20;
+
+// The layout of a subtree relative to its root, kept between layouts so only subtrees whose shape
+// changed are laid out again
+interface SubtreeLayout {
+  // Changes whenever the subtree is laid out again
+  version: number;
+  // The children it was laid out with, and the versions of their layouts
+  left: GraphicalBSTNode | null;
+  right: GraphicalBSTNode | null;
+  leftVersion: number;
+  rightVersion: number;
+  // How far either side of the node its children are
+  childDiffX: number;
+  // The leftmost and rightmost x at each depth of the subtree, the first being the node itself
+  leftContour: number[];
+  rightContour: number[];
+}
+
+const layouts = new WeakMap<GraphicalBSTNode, SubtreeLayout>();
+let nextVersion = 0;
+
+// Lays out a subtree the Reingold-Tilford way: its two subtrees side by side, as close as their
+// contours allow. Subtrees that kept their shape keep their layout.
+const layoutSubtree = (node: GraphicalBSTNode): SubtreeLayout => {
+  const left = node.left && layoutSubtree(node.left);
+  const right = node.right && layoutSubtree(node.right);
+  const cached = layouts.get(node);
+  if (
+    cached &&
+    cached.left === node.left &&
+    cached.right === node.right &&
+    cached.leftVersion === (left?.version ?? -1) &&
+    cached.rightVersion === (right?.version ?? -1)
+  ) {
+    return cached;
+  }
+
+  let childDiffX = nodeSeparation / 2;
+  if (left && right) {
+    // Where the two subtrees would overlap the most if both children were at the node
+    let overlap = 0;
+    const depth = Math.min(left.rightContour.length, right.leftContour.length);
+    for (let i = 0; i < depth; i += 1) {
+      overlap = Math.max(overlap, left.rightContour[i] - right.leftContour[i]);
+    }
+    childDiffX = Math.max(childDiffX, (overlap + nodeSeparation) / 2);
+  }
+
+  const leftContour = [0];
+  const rightContour = [0];
+  const depth = Math.max(left?.leftContour.length ?? 0, right?.leftContour.length ?? 0);
+  for (let i = 0; i < depth; i += 1) {
+    const lefts = [];
+    const rights = [];
+    if (left && i < left.leftContour.length) {
+      lefts.push(left.leftContour[i] - childDiffX);
+      rights.push(left.rightContour[i] - childDiffX);
+    }
+    if (right && i < right.leftContour.length) {
+      lefts.push(right.leftContour[i] + childDiffX);
+      rights.push(right.rightContour[i] + childDiffX);
+    }
+    leftContour.push(Math.min(...lefts));
+    rightContour.push(Math.max(...rights));
+  }
+
+  const layout = {
+    version: nextVersion,
+    left: node.left,
+    right: node.right,
+    leftVersion: left?.version ?? -1,
+    rightVersion: right?.version ?? -1,
+    childDiffX,
+    leftContour,
+    rightContour,
+  };
+  nextVersion += 1;
+  layouts.set(node, layout);
+  return layout;
+};
+
+const placeSubtree = (node: GraphicalBSTNode | null, x: number, y: number) => {
   if (node === null) {
     return;
   }
 
-  node.x = mid;
+  node.x = x;
   node.y = y;
 
-  updateNodePositionsRecursive(node.left, low, mid, (low + mid) / 2, y + lineDiffY);
-  updateNodePositionsRecursive(node.right, mid, high, (mid + high) / 2, y + lineDiffY);
+  const { childDiffX } = layouts.get(node)!;
+  placeSubtree(node.left, x - childDiffX, y + lineDiffY);
+  placeSubtree(node.right, x + childDiffX, y + lineDiffY);
 };
 
+// How far either side of a laid out node its children are, or would be
+export const getChildDiffX = (node: GraphicalBSTNode): number =>
+  layouts.get(node)?.childDiffX ?? nodeSeparation / 2;
+
+// Updates node positions of a tree. Nodes never overlap however deep the tree is, and only the
+// subtrees on the paths to changed nodes are laid out again.
 const updateNodePositions = (root: GraphicalBSTNode | null): void => {
-  const canvasWidth = document.getElementById('visualiser-container')?.offsetWidth;
-  const low: number = 0;
-  const high: number = Number(canvasWidth);
-  const mid: number = (low + high) / 2;
-  updateNodePositionsRecursive(root, low, high, mid, canvasPadding);
+  if (root === null) {
+    return;
+  }
+  const layout = layoutSubtree(root);
+
+  // Centred, unless that would put the left of the tree off the canvas
+  const canvasWidth = Number(document.getElementById('visualiser-container')?.offsetWidth);
+  const leftmost = Math.min(...layout.leftContour);
+  const rootX = Math.max(canvasWidth / 2, canvasPadding + actualNodeDiameter / 2 - leftmost);
+  placeSubtree(root, rootX, canvasPadding);
 };
 
 export default updateNodePositions;
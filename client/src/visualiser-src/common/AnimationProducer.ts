@@ -7,6 +7,10 @@ interface RunnerInfo {
   isTimestamped: boolean;
 }
 export default abstract class AnimationProducer {
+  // Set while operations run headless, when animation functions are skipped and the data
+  // structure is drawn once afterwards, see GraphicalDataStructure.runHeadless
+  private static headless: boolean = false;
+
   private _allRunners: RunnerInfo[] = [];
 
   // this is the current sequence of runners,
@@ -43,7 +47,17 @@ export default abstract class AnimationProducer {
     this._highlightedLines = value;
   }
 
+  public static runHeadless(operations: () => void): void {
+    AnimationProducer.headless = true;
+    try {
+      operations();
+    } finally {
+      AnimationProducer.headless = false;
+    }
+  }
+
   public renderCode(code: string): void {
+    if (AnimationProducer.headless) return;
     // clear the canvas
     SVG(CODE_CANVAS).clear();
     this.highlightedLines = [];
@@ -107,12 +121,14 @@ export default abstract class AnimationProducer {
     fn: any,
     ...args: any[]
   ): void {
+    if (AnimationProducer.headless) return;
     this.highlightCode(line);
     fn.apply(this, args);
     this.finishSequence(isTimestamped);
   }
 
   public doAnimation(fn: any, ...args: any[]): void {
+    if (AnimationProducer.headless) return;
     fn.apply(this, args);
 
     // make sure that the animation function finishes the sequence if it
@@ -121,6 +137,7 @@ export default abstract class AnimationProducer {
   }
 
   public doAnimationWithoutTimestamp(fn: any, ...args: any[]) {
+    if (AnimationProducer.headless) return;
     fn.apply(this, args);
     this.finishSequence(false);
   }
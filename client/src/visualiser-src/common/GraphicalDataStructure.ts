@@ -1,6 +1,7 @@
 import { SVG } from '@svgdotjs/svg.js';
 import { Documentation } from './typedefs';
 import { CODE_CANVAS, VISUALISER_CANVAS, CODE_CONTAINER } from './constants';
+import AnimationProducer from './AnimationProducer';
 
 abstract class GraphicalDataStructure {
   public constructor() {
@@ -17,6 +18,16 @@ abstract class GraphicalDataStructure {
 
   public abstract generate(): void;
 
+  // Draws the data structure as it is now, without animating
+  public abstract render(): void;
+
+  // Runs operations on the model alone and then draws the result once, for when only the end
+  // state is wanted. No runners are built, so this is instant even for large structures.
+  public runHeadless(operations: () => void): void {
+    AnimationProducer.runHeadless(operations);
+    this.render();
+  }
+
   // Return data of the data structure in the form of an array
   public get data(): number[] {
     return [1, 2, 3];
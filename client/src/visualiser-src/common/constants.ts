@@ -10,6 +10,8 @@ export const showLineNumbers = false;
 
 // Animation attributes
 export const defaultSpeed = 0.5;
+// Timestamped steps between the canvas snapshots of a timeline, see TimelineKeyframes
+export const keyframeSteps = 8;
 
 export const VISUALISER_CANVAS = '#visualiser-canvas';
 export const CODE_CANVAS = '#code-canvas';
@@ -55,3 +55,21 @@ export const isImplemented = (topicTitle: string): boolean =>
   Object.values(DataStructure).includes(topicTitle.toLowerCase() as DataStructure);
 
 export const getTopics = (): string[] => Object.values(DataStructure);
+
+/**
+ * The number of values in an ascending array that are at most value, found by binary search.
+ * The last of them is at the returned index - 1.
+ */
+export const bisectRight = (sorted: number[], value: number): number => {
+  let low = 0;
+  let high = sorted.length;
+  while (low < high) {
+    const mid = Math.floor((low + high) / 2);
+    if (sorted[mid] <= value) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+};
@@ -0,0 +1,126 @@
+import { Runner, Timeline } from '@svgdotjs/svg.js';
+import { bisectRight } from '../common/helpers';
+
+export interface ScheduledRunner {
+  runner: Runner;
+  start: number;
+}
+
+// The attributes of every animated element at one point of the timeline
+type Snapshot = [SVGElement, [string, string][]][];
+
+const capture = (nodes: SVGElement[]): Snapshot =>
+  nodes.map((node) => [
+    node,
+    node.getAttributeNames().map((name) => [name, node.getAttribute(name) as string]),
+  ]);
+
+const restore = (snapshot: Snapshot): void => {
+  snapshot.forEach(([node, attributes]) => {
+    const names = new Set(attributes.map(([name]) => name));
+    node
+      .getAttributeNames()
+      .filter((name) => !names.has(name))
+      .forEach((name) => node.removeAttribute(name));
+    attributes.forEach(([name, value]) => node.setAttribute(name, value));
+  });
+};
+
+/**
+ * Splits the timeline of an operation into segments at keyframes, which hold a snapshot of the
+ * canvas. Only the runners of the segment being played are scheduled on the svg.js timeline, the
+ * others are retired from it, so stepping and seeking cost the same however long the operation is:
+ * a seek finds its segment by binary search, restores its snapshot and replays at most one
+ * segment of runners.
+ */
+export default class TimelineKeyframes {
+  private timeline: Timeline;
+
+  // When each segment starts, the first at 0
+  private times: number[];
+
+  private segments: ScheduledRunner[][];
+
+  // The canvas at the start of each segment
+  private snapshots: Snapshot[] = [];
+
+  private current: number = -1;
+
+  public constructor(
+    timeline: Timeline,
+    times: number[],
+    runners: ScheduledRunner[],
+    duration: number
+  ) {
+    this.timeline = timeline;
+    this.times = times;
+    this.segments = times.map(() => []);
+    // A keyframe is never in the middle of a runner, as it comes after a whole sequence
+    runners.forEach((scheduled) => {
+      this.segments[this.segmentAt(scheduled.start)].push(scheduled);
+    });
+
+    // Play the segments through once, in order, for their snapshots
+    const nodes = [...new Set(runners.map(({ runner }) => runner.element().node))];
+    this.snapshots.push(capture(nodes));
+    this.segments.slice(0, -1).forEach((segment, i) => {
+      this.schedule(segment);
+      this.timeline.time(times[i + 1]);
+      segment.forEach(({ runner }) => runner.unschedule());
+      this.snapshots.push(capture(nodes));
+    });
+
+    // Keeps the timeline from finishing in the gaps between segments
+    this.timeline.schedule(new Runner(duration), 0, 'absolute');
+    this.enter(0);
+    this.timeline.time(0);
+  }
+
+  // Called whenever the timeline's time changes, before it steps its runners
+  public update(time: number): void {
+    const segment = this.segmentAt(time);
+    if (segment !== this.current) {
+      this.enter(segment, segment === this.current + 1);
+    }
+  }
+
+  public seek(time: number): void {
+    const segment = this.segmentAt(time);
+    if (segment !== this.current) {
+      this.enter(segment);
+      // So the timeline steps the new runners forwards from the keyframe
+      this.timeline.time(this.times[segment]);
+    }
+    this.timeline.time(time);
+  }
+
+  private segmentAt(time: number): number {
+    return Math.max(bisectRight(this.times, time) - 1, 0);
+  }
+
+  private enter(segment: number, finishing: boolean = false): void {
+    const outgoing = this.segments[this.current] ?? [];
+    if (finishing) {
+      // Playing on, so runners ending on the keyframe run their callbacks
+      outgoing.forEach(({ runner }) => runner.finish());
+    }
+    outgoing.forEach(({ runner }) => runner.unschedule());
+
+    // Resetting the runners of a segment played before changes the canvas, back to before each
+    // of them, so the snapshot is restored again after
+    const incoming = this.segments[segment];
+    restore(this.snapshots[segment]);
+    for (let i = incoming.length - 1; i >= 0; i -= 1) {
+      incoming[i].runner.reset();
+    }
+    restore(this.snapshots[segment]);
+    this.schedule(incoming);
+    this.current = segment;
+  }
+
+  private schedule(segment: ScheduledRunner[]): void {
+    segment.forEach(({ runner, start }) => {
+      this.timeline.schedule(runner, start, 'absolute');
+    });
+  }
+}
@@ -2,8 +2,10 @@ import { Timeline, Runner } from '@svgdotjs/svg.js';
 import GraphicalDataStructure from 'visualiser-src/common/GraphicalDataStructure';
 import GraphicalDataStructureFactory from 'visualiser-src/common/GraphicalDataStructureFactory';
 import { Documentation } from 'visualiser-src/common/typedefs';
-import { defaultSpeed } from '../common/constants';
+import { bisectRight } from 'visualiser-src/common/helpers';
+import { defaultSpeed, keyframeSteps } from '../common/constants';
 import AnimationProducer from '../common/AnimationProducer';
+import TimelineKeyframes, { ScheduledRunner } from './TimelineKeyframes';
 
 interface TimeEvent extends Event {
   detail?: number;
@@ -18,8 +20,11 @@ class VisualiserController {
 
   private timelineDuration: number = 0;
 
+  // Sorted, so the previous one is found by binary search
   private timestamps: number[] = [];
 
+  private keyframes: TimelineKeyframes | null = null;
+
   private speed: number = 1;
 
   private isStepMode: boolean = false;
@@ -59,10 +64,12 @@ class VisualiserController {
 
     if (animationProducer.allRunners.length === 0) return;
 
+    const scheduled: ScheduledRunner[] = [];
+    const keyframeTimes = [0];
     animationProducer.allRunners.forEach((runnerInfo) => {
       if (runnerInfo.runners.length === 0) return;
       runnerInfo.runners.forEach((runner) => {
-        this.currentTimeline.schedule(runner, this.timelineDuration + 25, 'absolute');
+        scheduled.push({ runner, start: this.timelineDuration + 25 });
       });
       const maxRunner = runnerInfo.runners.reduce(
         (prev: Runner, curr: Runner) => (prev.duration() < curr.duration() ? curr : prev),
@@ -76,15 +83,30 @@ class VisualiserController {
           }
         });
         this.timestamps.push(this.timelineDuration + 1);
+        if (this.timestamps.length % keyframeSteps === 0) {
+          keyframeTimes.push(this.timelineDuration + 1);
+        }
       }
     });
     this.timestamps.push(this.timelineDuration);
+    // The end comes before the last step's timestamp if that ends the operation
+    this.timestamps.sort((x, y) => x - y);
+    this.keyframes = new TimelineKeyframes(
+      this.currentTimeline,
+      keyframeTimes,
+      scheduled,
+      this.timelineDuration
+    );
     this.currentTimeline.play();
   }
 
   public resetTimeline(updateSlider: (val: number) => void) {
     this.currentTimeline = new Timeline().persist(true);
+    this.keyframes = null;
     this.currentTimeline.on('time', (evt: TimeEvent) => {
+      // Still being built, or seeking through the timeline to take its snapshots
+      if (!this.keyframes || evt.detail === undefined) return;
+      this.keyframes.update(evt.detail);
       // avoid division by 0
       if (this.timelineDuration !== 0 && evt.detail) {
         updateSlider((Math.min(evt.detail, this.timelineDuration) / this.timelineDuration) * 100);
@@ -107,7 +129,7 @@ class VisualiserController {
 
   public seekPercent(position: number): void {
     const timeSeek: number = (position * this.timelineDuration) / 100;
-    this.currentTimeline.time(timeSeek);
+    this.seek(timeSeek);
     if (this.isStepMode) {
       this.pause();
       this.isStepMode = false;
@@ -130,7 +152,7 @@ class VisualiserController {
   }
 
   public stepBackwards(): void {
-    this.currentTimeline.time(this.computePrevTimestamp());
+    this.seek(this.computePrevTimestamp());
   }
 
   public stepForwards(): void {
@@ -144,6 +166,7 @@ class VisualiserController {
     this.currentTimeline.finish();
     this.currentTimeline.time(0);
     this.currentTimeline = new Timeline().persist(true);
+    this.keyframes = null;
   }
 
   private getErrorMessageIfInvalidInput(command: string, args: string[]): string {
@@ -221,6 +244,7 @@ class VisualiserController {
     this.currentTimeline.finish();
     this.currentTimeline.time(0);
     this.currentTimeline = new Timeline().persist(true);
+    this.keyframes = null;
   }
 
   public generateDataStructure(): void {
@@ -228,16 +252,18 @@ class VisualiserController {
     this.dataStructure?.generate();
   }
 
-  private computePrevTimestamp(): number {
-    const sortedTimestamps = [...this.timestamps].sort((x, y) => y - x);
-    let prevTimestamp = 0;
-    for (let i = 0; i < this.timestamps.length; i += 1) {
-      if (sortedTimestamps[i] + 25 < this.currentTime) {
-        prevTimestamp = sortedTimestamps[i];
-        break;
-      }
+  private seek(time: number): void {
+    if (this.keyframes) {
+      this.keyframes.seek(time);
+    } else {
+      this.currentTimeline.time(time);
     }
-    return prevTimestamp;
+  }
+
+  private computePrevTimestamp(): number {
+    // The last timestamp at least a gap between sequences before now
+    const index = bisectRight(this.timestamps, this.currentTime - 25) - 1;
+    return index >= 0 ? this.timestamps[index] : 0;
   }
 
   private get currentTime() {
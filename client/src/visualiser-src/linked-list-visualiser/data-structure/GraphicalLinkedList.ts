@@ -2,19 +2,19 @@ import AnimationProducer from 'visualiser-src/common/AnimationProducer';
 import { SVG, Path, Svg } from '@svgdotjs/svg.js';
 import GraphicalDataStructure from 'visualiser-src/common/GraphicalDataStructure';
 import { Documentation } from 'visualiser-src/common/typedefs';
-import { VISUALISER_CANVAS } from 'visualiser-src/common/constants';
+import { actualNodeDiameter, VISUALISER_CANVAS } from 'visualiser-src/common/constants';
 import { injectIds } from 'visualiser-src/common/helpers';
 import { generateNumbers } from 'visualiser-src/common/RandomNumGenerator';
 import currTextPath from '../assets/currTextPath';
 import prevTextPath from '../assets/prevTextPath';
-import { CURRENT, PREV } from '../util/constants';
+import { CURRENT, nodePathWidth, PREV, topOffset } from '../util/constants';
+import { getPointerPath } from '../util/util';
 import GraphicalLinkedListNode from './GraphicalLinkedListNode';
 import LinkedListAppendAnimationProducer from '../animation-producer/LinkedListAppendAnimationProducer';
 import LinkedListDeleteAnimationProducer from '../animation-producer/LinkedListDeleteAnimationProducer';
 import LinkedListInsertAnimationProducer from '../animation-producer/LinkedListInsertAnimationProducer';
 import LinkedListSearchAnimationProducer from '../animation-producer/LinkedListSearchAnimationProducer';
 import LinkedListPrependAnimationProducer from '../animation-producer/LinkedListPrependAnimationProducer';
-import LinkedListAnimationProducer from '../animation-producer/LinkedListAnimationProducer';
 
 // An linked list data structure containing all linked list operations.
 // Every operation producers a LinkedListAnimationProducer, which an VisualiserController
@@ -55,21 +55,35 @@ export default class GraphicalLinkedList extends GraphicalDataStructure {
   }
 
   public load(data: number[]): void {
-    const numbers = data;
-    this.length = numbers.length;
-    const producer = new LinkedListAnimationProducer();
-    let currNode = null;
-    producer.initialiseHead(this.headPointer);
-    for (let i = 0; i < numbers.length; i += 1) {
-      const newNode = GraphicalLinkedListNode.from(numbers[i]);
-      producer.createNodeAt(i, newNode, i + 1);
-      if (currNode === null) {
-        this.head = newNode;
-      } else {
-        currNode.next = newNode;
-        producer.linkLastToNew(currNode);
-      }
-      currNode = newNode;
+    // Prepending from the back, as appending walks the list each time
+    this.runHeadless(() => {
+      [...data].reverse().forEach((value) => this.prepend(value));
+    });
+  }
+
+  // Lays the list out in a row, as resetPositioning animates it to
+  public render(): void {
+    this.headPointer
+      .plot(
+        getPointerPath(
+          actualNodeDiameter / 2,
+          topOffset,
+          nodePathWidth + actualNodeDiameter / 2,
+          topOffset
+        ) as any
+      )
+      .opacity(this.head === null ? 0 : 1);
+    let curr: GraphicalLinkedListNode | null = this.head;
+    let index = 0;
+    while (curr !== null) {
+      const cx = (index + 1) * nodePathWidth + actualNodeDiameter / 2;
+      curr.boxTarget.cx(cx).cy(topOffset).opacity(1);
+      curr.numberTarget.cx(cx).cy(topOffset).opacity(1);
+      curr.pointerTarget
+        .plot(getPointerPath(cx, topOffset, cx + nodePathWidth, topOffset) as any)
+        .opacity(curr.next === null ? 0 : 1);
+      index += 1;
+      curr = curr.next;
     }
   }
 
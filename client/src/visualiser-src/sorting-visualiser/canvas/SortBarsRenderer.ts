@@ -0,0 +1,147 @@
+import { opAt, SortOp, SortTrace } from '../trace/sortTrace';
+import { comparingColor, defaultColour, redColour, sortedColour } from '../util/constants';
+
+// What happened to the elements of a column in the last frame
+enum Mark {
+  None = 0,
+  Compared = 1,
+  Changed = 2,
+}
+
+const markColours = [defaultColour, comparingColor, redColour];
+
+/**
+ * Replays the trace of a sort as bars on a canvas, a number of operations each frame. Inputs
+ * wider than the canvas share a column of pixels between neighbouring elements, drawn as the
+ * largest of them, so a frame costs the same however many operations it replays.
+ */
+export default class SortBarsRenderer {
+  public opsPerFrame: number;
+
+  private canvas: HTMLCanvasElement;
+
+  private context: CanvasRenderingContext2D;
+
+  private trace: SortTrace;
+
+  private values: Int32Array;
+
+  private maxValue: number;
+
+  // The next operation to replay
+  private position: number = 0;
+
+  private marks: Uint8Array;
+
+  private heights: Float32Array;
+
+  private frame: number | null = null;
+
+  private onProgress: (position: number) => void;
+
+  public constructor(
+    canvas: HTMLCanvasElement,
+    values: Int32Array,
+    trace: SortTrace,
+    opsPerFrame: number,
+    onProgress: (position: number) => void
+  ) {
+    this.canvas = canvas;
+    this.context = canvas.getContext('2d')!;
+    this.trace = trace;
+    this.values = values.slice();
+    this.maxValue = values.reduce((max, value) => Math.max(max, value), 0);
+    this.opsPerFrame = opsPerFrame;
+    this.onProgress = onProgress;
+    const columns = Math.max(Math.min(values.length, canvas.width), 1);
+    this.marks = new Uint8Array(columns);
+    this.heights = new Float32Array(columns);
+    this.draw();
+  }
+
+  public get finished(): boolean {
+    return this.position === this.trace.length;
+  }
+
+  public play(): void {
+    if (this.frame === null && !this.finished) {
+      this.frame = requestAnimationFrame(this.step);
+    }
+  }
+
+  public pause(): void {
+    if (this.frame !== null) {
+      cancelAnimationFrame(this.frame);
+      this.frame = null;
+    }
+  }
+
+  // Skips to the end, which is the sorted input even if the trace stops short of it
+  public finish(): void {
+    this.pause();
+    this.position = this.trace.length;
+    this.values.set(this.trace.sorted);
+    this.marks.fill(Mark.None);
+    this.draw();
+    this.onProgress(this.position);
+  }
+
+  private step = (): void => {
+    this.marks.fill(Mark.None);
+    const end = Math.min(this.position + this.opsPerFrame, this.trace.length);
+    for (; this.position < end; this.position += 1) {
+      const [op, i, other] = opAt(this.trace, this.position);
+      if (op === SortOp.Compare) {
+        this.mark(i, Mark.Compared);
+        this.mark(other, Mark.Compared);
+      } else if (op === SortOp.Swap) {
+        [this.values[i], this.values[other]] = [this.values[other], this.values[i]];
+        this.mark(i, Mark.Changed);
+        this.mark(other, Mark.Changed);
+      } else {
+        this.values[i] = other;
+        this.mark(i, Mark.Changed);
+      }
+    }
+
+    if (this.finished) {
+      this.finish();
+      return;
+    }
+    this.draw();
+    this.onProgress(this.position);
+    this.frame = requestAnimationFrame(this.step);
+  };
+
+  private mark(index: number, mark: Mark): void {
+    const column = Math.floor((index * this.marks.length) / this.values.length);
+    this.marks[column] = Math.max(this.marks[column], mark);
+  }
+
+  private draw(): void {
+    const { width, height } = this.canvas;
+    const columns = this.marks.length;
+    const barWidth = width / columns;
+    this.context.clearRect(0, 0, width, height);
+
+    // The tallest element of each column, the ones an element is in being those mark uses
+    this.heights.fill(0);
+    this.values.forEach((value, index) => {
+      const column = Math.floor((index * columns) / this.values.length);
+      this.heights[column] = Math.max(this.heights[column], value + 1);
+    });
+
+    // A path per colour, as changing the fill for each bar is slow
+    markColours.forEach((colour, mark) => {
+      this.context.beginPath();
+      for (let column = 0; column < columns; column += 1) {
+        if (this.marks[column] === mark) {
+          const barHeight = (this.heights[column] / (this.maxValue + 1)) * height;
+          this.context.rect(column * barWidth, height - barHeight, barWidth, barHeight);
+        }
+      }
+      this.context.fillStyle = this.finished ? sortedColour : colour;
+      this.context.fill();
+    });
+  }
+}
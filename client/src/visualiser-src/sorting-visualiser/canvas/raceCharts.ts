@@ -0,0 +1,117 @@
+export interface RaceBar {
+  label: string;
+  value: number;
+  colour: string;
+}
+
+export interface GrowthSeries {
+  label: string;
+  colour: string;
+  // Input size and measurement, in order of size
+  points: [number, number][];
+}
+
+const font = '12px CodeText';
+const labelWidth = 90;
+const axisPadding = 30;
+
+/**
+ * The exponent k of the best fit of value = c * size^k, the slope of the points on a log-log
+ * plot: near 2 for a quadratic sort, a little over 1 for an n log n one. Null without two sizes.
+ */
+export const growthExponent = (points: [number, number][]): number | null => {
+  const logs = points
+    .filter(([, value]) => value > 0)
+    .map(([n, value]) => [Math.log(n), Math.log(value)]);
+  if (logs.length < 2) return null;
+  const meanX = logs.reduce((sum, [x]) => sum + x, 0) / logs.length;
+  const meanY = logs.reduce((sum, [, y]) => sum + y, 0) / logs.length;
+  const sxx = logs.reduce((sum, [x]) => sum + (x - meanX) ** 2, 0);
+  const sxy = logs.reduce((sum, [x, y]) => sum + (x - meanX) * (y - meanY), 0);
+  return sxx > 0 ? sxy / sxx : null;
+};
+
+// Horizontal bars on a log scale, as the slowest sort can do a million times what the fastest does
+export const drawRaceBars = (
+  canvas: HTMLCanvasElement,
+  bars: RaceBar[],
+  textColour: string
+): void => {
+  const context = canvas.getContext('2d')!;
+  const { width, height } = canvas;
+  context.clearRect(0, 0, width, height);
+  context.font = font;
+  context.textBaseline = 'middle';
+
+  const max = Math.log10(bars.reduce((prev, bar) => Math.max(prev, bar.value), 1) + 1);
+  const rowHeight = height / Math.max(bars.length, 1);
+  bars.forEach((bar, i) => {
+    const y = i * rowHeight;
+    const barWidth = ((width - 2 * labelWidth) * Math.log10(bar.value + 1)) / (max || 1);
+    context.fillStyle = bar.colour;
+    context.fillRect(labelWidth, y + rowHeight * 0.15, barWidth, rowHeight * 0.7);
+    context.fillStyle = textColour;
+    context.fillText(bar.label, 0, y + rowHeight / 2);
+    context.fillText(bar.value.toLocaleString(), labelWidth + barWidth + 5, y + rowHeight / 2);
+  });
+};
+
+// Each series against input size on log-log axes, labelled with its growth exponent
+export const drawGrowth = (
+  canvas: HTMLCanvasElement,
+  series: GrowthSeries[],
+  textColour: string
+): void => {
+  const context = canvas.getContext('2d')!;
+  const { width, height } = canvas;
+  context.clearRect(0, 0, width, height);
+  context.font = font;
+  context.textBaseline = 'middle';
+
+  const points = series.flatMap(({ points: seriesPoints }) => seriesPoints);
+  const logNs = points.map(([n]) => Math.log10(n));
+  const logValues = points.map(([, value]) => Math.log10(value + 1));
+  const minX = Math.min(...logNs);
+  const maxX = Math.max(...logNs);
+  const maxY = Math.max(...logValues, 1);
+  const plotWidth = width - axisPadding - labelWidth * 1.5;
+  const plotHeight = height - 2 * axisPadding;
+  const toX = (n: number) =>
+    axisPadding + (maxX > minX ? ((Math.log10(n) - minX) / (maxX - minX)) * plotWidth : 0);
+  const toY = (value: number) =>
+    height - axisPadding - (Math.log10(value + 1) / maxY) * plotHeight;
+
+  context.strokeStyle = textColour;
+  context.beginPath();
+  context.moveTo(axisPadding, axisPadding);
+  context.lineTo(axisPadding, height - axisPadding);
+  context.lineTo(axisPadding + plotWidth, height - axisPadding);
+  context.stroke();
+  context.fillStyle = textColour;
+  if (points.length > 0) {
+    const minLabel = `n = ${Math.round(10 ** minX).toLocaleString()}`;
+    const maxLabel = `n = ${Math.round(10 ** maxX).toLocaleString()}`;
+    const labelX = axisPadding + plotWidth - context.measureText(maxLabel).width;
+    context.fillText(minLabel, axisPadding, height - axisPadding / 2);
+    context.fillText(maxLabel, labelX, height - axisPadding / 2);
+  }
+
+  series.forEach(({ label, colour, points: seriesPoints }, i) => {
+    context.strokeStyle = colour;
+    context.fillStyle = colour;
+    context.beginPath();
+    seriesPoints.forEach(([n, value], j) => {
+      if (j === 0) {
+        context.moveTo(toX(n), toY(value));
+      } else {
+        context.lineTo(toX(n), toY(value));
+      }
+      context.fillRect(toX(n) - 2, toY(value) - 2, 4, 4);
+    });
+    context.stroke();
+
+    const exponent = growthExponent(seriesPoints);
+    const legend = exponent === null ? label : `${label} ~ n^${exponent.toFixed(2)}`;
+    context.fillText(legend, width - labelWidth * 1.5 + 5, axisPadding + i * 16);
+  });
+};
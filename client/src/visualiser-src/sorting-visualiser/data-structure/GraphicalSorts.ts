@@ -18,7 +18,9 @@ import {
   comparingColor,
   selectedColor,
   redColour,
+  textCy,
 } from '../util/constants';
+import { getCx, getX, getY } from '../util/helpers';
 
 export default class GraphicalSortList extends GraphicalDataStructure {
   public elementList: GraphicalSortsElement[] = [];
@@ -553,12 +555,22 @@ export default class GraphicalSortList extends GraphicalDataStructure {
   }
 
   public generate(): void {
-    const numbers = generateNumbers();
-    this.append(numbers);
+    this.load(generateNumbers());
   }
 
   public load(data: number[]): void {
-    console.log(data);
-    this.append(data);
+    this.elementList = [
+      ...this.elementList,
+      ...data.map((value) => GraphicalSortsElement.from(value)),
+    ];
+    this.render();
+  }
+
+  // Draws the blocks in list order, where SortsCreateAnimationProducer.addBlock fades them in
+  public render(): void {
+    this.elementList.forEach((element, index) => {
+      element.boxTarget.x(getX(index)).y(getY(element.data.value)).opacity(1);
+      element.numberTarget.cx(getCx(index)).cy(textCy).opacity(1);
+    });
   }
 }
@@ -0,0 +1,92 @@
+import { SortAlgorithm, SortObserver } from './sortTrace';
+
+export interface SortCounts {
+  comparisons: number;
+  swaps: number;
+  writes: number;
+  // Milliseconds since the sort started
+  time: number;
+}
+
+export interface SortCountRequest {
+  algorithm: SortAlgorithm;
+  values: Int32Array;
+  maxOps: number;
+}
+
+export interface SortCountReport {
+  counts: SortCounts;
+  done: boolean;
+  // Whether the sort was stopped at maxOps rather than run to the end
+  cutOff: boolean;
+}
+
+// How many operations go between looking at the clock
+const opsPerCheck = 2 ** 16;
+
+// Thrown out of a sort once it has done maxOps operations
+export const opsLimitReached = new Error('Sort operation limit reached');
+
+/**
+ * Counts the operations of a sort, reporting the counts so far at most every reportInterval
+ * milliseconds while it runs. Counting is cheap enough to leave the sort's wall time comparable
+ * between algorithms, as each pays the same per operation. A sort is stopped after maxOps
+ * operations, as a quadratic sort of a large input would run for hours.
+ */
+export default class SortCounter implements SortObserver {
+  public counts: SortCounts = { comparisons: 0, swaps: 0, writes: 0, time: 0 };
+
+  private ops: number = 0;
+
+  private start: number = performance.now();
+
+  private lastReport: number = this.start;
+
+  private reportInterval: number;
+
+  private maxOps: number;
+
+  private onReport: (counts: SortCounts) => void;
+
+  public constructor(
+    reportInterval: number,
+    maxOps: number,
+    onReport: (counts: SortCounts) => void
+  ) {
+    this.reportInterval = reportInterval;
+    this.maxOps = maxOps;
+    this.onReport = onReport;
+  }
+
+  public compare(): void {
+    this.counts.comparisons += 1;
+    this.tick();
+  }
+
+  public swap(): void {
+    this.counts.swaps += 1;
+    this.tick();
+  }
+
+  public write(): void {
+    this.counts.writes += 1;
+    this.tick();
+  }
+
+  // The final counts, once the sort is done
+  public finish(): SortCounts {
+    this.counts.time = performance.now() - this.start;
+    return { ...this.counts };
+  }
+
+  private tick(): void {
+    this.ops += 1;
+    if (this.ops >= this.maxOps) throw opsLimitReached;
+    if (this.ops % opsPerCheck !== 0) return;
+    const now = performance.now();
+    if (now - this.lastReport >= this.reportInterval) {
+      this.lastReport = now;
+      this.onReport(this.finish());
+    }
+  }
+}
@@ -0,0 +1,35 @@
+import { SortCounts, SortCountReport, SortCountRequest } from './SortCounter';
+
+export interface CountingSort {
+  // The final report, cut off if the sort reached maxOps
+  done: Promise<SortCountReport>;
+  // Stops the sort where it is, leaving done unsettled
+  cancel: () => void;
+}
+
+// Counts the operations of a sort in a worker of its own, calling onProgress as it runs
+const countInWorker = (
+  request: SortCountRequest,
+  onProgress: (counts: SortCounts) => void
+): CountingSort => {
+  const worker = new Worker(new URL('./sortCount.worker.ts', import.meta.url), {
+    type: 'module',
+  });
+  const done = new Promise<SortCountReport>((resolve, reject) => {
+    worker.onmessage = (event: MessageEvent<SortCountReport>) => {
+      onProgress(event.data.counts);
+      if (event.data.done) {
+        worker.terminate();
+        resolve(event.data);
+      }
+    };
+    worker.onerror = (event: ErrorEvent) => {
+      worker.terminate();
+      reject(new Error(event.message));
+    };
+  });
+  worker.postMessage(request);
+  return { done, cancel: () => worker.terminate() };
+};
+
+export default countInWorker;
@@ -0,0 +1,24 @@
+import { runSort } from './sortTrace';
+import SortCounter, { opsLimitReached, SortCountReport, SortCountRequest } from './SortCounter';
+
+// How often the counts of a sort still running are sent back, in milliseconds
+const reportInterval = 100;
+
+const report = (message: SortCountReport) => globalThis.postMessage(message);
+
+globalThis.addEventListener('message', (event: MessageEvent<SortCountRequest>) => {
+  const { algorithm, values, maxOps } = event.data;
+  const counter = new SortCounter(reportInterval, maxOps, (counts) =>
+    report({ counts, done: false, cutOff: false })
+  );
+  let cutOff = false;
+  try {
+    runSort(algorithm, values, counter);
+  } catch (error) {
+    if (error !== opsLimitReached) {
+      throw error;
+    }
+    cutOff = true;
+  }
+  report({ counts: counter.finish(), done: true, cutOff });
+});
@@ -0,0 +1,275 @@
+export type SortAlgorithm = 'bubble' | 'insertion' | 'selection' | 'merge' | 'quick';
+
+export const sortAlgorithms: SortAlgorithm[] = [
+  'bubble',
+  'insertion',
+  'selection',
+  'merge',
+  'quick',
+];
+
+export enum SortOp {
+  Compare = 0,
+  Swap = 1,
+  Write = 2,
+}
+
+// Told about every operation a sort does on its array, as it does it
+export interface SortObserver {
+  compare(i: number, j: number): void;
+  swap(i: number, j: number): void;
+  write(i: number, value: number): void;
+}
+
+/**
+ * The operations of a sort, two words each: the first holds the operation and the index it is on,
+ * the second the other index of a compare or swap, or the value of a write.
+ */
+export interface SortTrace {
+  algorithm: SortAlgorithm;
+  ops: Int32Array;
+  length: number;
+  // Whether the sort did more operations than were recorded
+  truncated: boolean;
+  sorted: Int32Array;
+}
+
+export interface SortTraceRequest {
+  algorithm: SortAlgorithm;
+  values: Int32Array;
+  maxOps: number;
+}
+
+export const opAt = (trace: SortTrace, index: number): [SortOp, number, number] => {
+  const head = trace.ops[2 * index];
+  return [head % 4, Math.floor(head / 4), trace.ops[2 * index + 1]];
+};
+
+export type InputPreset = 'random' | 'sorted' | 'reversed' | 'few unique';
+
+export const inputPresets: InputPreset[] = ['random', 'sorted', 'reversed', 'few unique'];
+
+export const makeInput = (preset: InputPreset, size: number): Int32Array => {
+  switch (preset) {
+    case 'sorted':
+      return Int32Array.from({ length: size }, (_, i) => i);
+    case 'reversed':
+      return Int32Array.from({ length: size }, (_, i) => size - 1 - i);
+    case 'few unique':
+      return Int32Array.from({ length: size }, () =>
+        Math.floor((Math.floor(Math.random() * 8) * size) / 8)
+      );
+    default:
+      return Int32Array.from({ length: size }, () => Math.floor(Math.random() * size));
+  }
+};
+
+// The same sorts as GraphicalSorts, without the animations
+
+const bubble = (values: Int32Array, observer: SortObserver): void => {
+  const len = values.length;
+  for (let i = 0; i < len; i += 1) {
+    let numSwaps = 0;
+    for (let j = 1; j < len - i; j += 1) {
+      observer.compare(j - 1, j);
+      if (values[j] < values[j - 1]) {
+        observer.swap(j - 1, j);
+        [values[j], values[j - 1]] = [values[j - 1], values[j]];
+        numSwaps += 1;
+      }
+    }
+    if (numSwaps === 0) {
+      return;
+    }
+  }
+};
+
+const insertion = (values: Int32Array, observer: SortObserver): void => {
+  for (let i = 1; i < values.length; i += 1) {
+    for (let j = i; j > 0; j -= 1) {
+      observer.compare(j - 1, j);
+      if (values[j] >= values[j - 1]) {
+        break;
+      }
+      observer.swap(j - 1, j);
+      [values[j], values[j - 1]] = [values[j - 1], values[j]];
+    }
+  }
+};
+
+const selection = (values: Int32Array, observer: SortObserver): void => {
+  for (let i = 0; i < values.length - 1; i += 1) {
+    let minIndex = i;
+    for (let j = i + 1; j < values.length; j += 1) {
+      observer.compare(j, minIndex);
+      if (values[j] < values[minIndex]) {
+        minIndex = j;
+      }
+    }
+    observer.swap(i, minIndex);
+    [values[i], values[minIndex]] = [values[minIndex], values[i]];
+  }
+};
+
+const mergeSort = (
+  values: Int32Array,
+  tmp: Int32Array,
+  low: number,
+  high: number,
+  observer: SortObserver
+): void => {
+  if (high <= low) {
+    return;
+  }
+  const mid = Math.floor((low + high) / 2);
+  mergeSort(values, tmp, low, mid, observer);
+  mergeSort(values, tmp, mid + 1, high, observer);
+
+  // Merged into tmp, where the indices of the compared elements are still their old ones
+  tmp.set(values.subarray(low, high + 1), low);
+  let pointerLeft = low;
+  let pointerRight = mid + 1;
+  for (let p = low; p <= high; p += 1) {
+    let takeRight = pointerLeft > mid;
+    if (!takeRight && pointerRight <= high) {
+      observer.compare(pointerLeft, pointerRight);
+      takeRight = tmp[pointerRight] < tmp[pointerLeft];
+    }
+    const value = takeRight ? tmp[pointerRight] : tmp[pointerLeft];
+    if (takeRight) {
+      pointerRight += 1;
+    } else {
+      pointerLeft += 1;
+    }
+    observer.write(p, value);
+    values[p] = value;
+  }
+};
+
+const merge = (values: Int32Array, observer: SortObserver): void => {
+  mergeSort(values, new Int32Array(values.length), 0, values.length - 1, observer);
+};
+
+const partition = (values: Int32Array, lo: number, hi: number, observer: SortObserver): number => {
+  const swap = (i: number, j: number) => {
+    observer.swap(i, j);
+    [values[i], values[j]] = [values[j], values[i]];
+  };
+
+  // The pivot is the first element, as in GraphicalSorts.partition
+  let i = lo;
+  let j = hi + 1;
+  for (;;) {
+    do {
+      i += 1;
+      observer.compare(i, lo);
+    } while (i < hi && values[i] < values[lo]);
+    do {
+      j -= 1;
+      observer.compare(lo, j);
+    } while (j > lo && values[lo] < values[j]);
+    if (i >= j) {
+      break;
+    }
+    swap(i, j);
+  }
+  swap(lo, j);
+  return j;
+};
+
+// Iterative, as the recursion on a sorted input is as deep as the input is long
+const quick = (values: Int32Array, observer: SortObserver): void => {
+  const ranges = [[0, values.length - 1]];
+  while (ranges.length > 0) {
+    const [lo, hi] = ranges.pop()!;
+    if (lo < hi) {
+      const pivot = partition(values, lo, hi, observer);
+      ranges.push([lo, pivot - 1], [pivot + 1, hi]);
+    }
+  }
+};
+
+const sorts: Record<SortAlgorithm, (values: Int32Array, observer: SortObserver) => void> = {
+  bubble,
+  insertion,
+  selection,
+  merge,
+  quick,
+};
+
+// Sorts the values in place
+export const runSort = (
+  algorithm: SortAlgorithm,
+  values: Int32Array,
+  observer: SortObserver
+): void => {
+  sorts[algorithm](values, observer);
+};
+
+// Thrown out of a sort once its trace is full
+const traceFull = new Error('Sort trace full');
+
+class SortTraceRecorder implements SortObserver {
+  public ops: Int32Array = new Int32Array(1024);
+
+  public length: number = 0;
+
+  private maxOps: number;
+
+  public constructor(maxOps: number) {
+    this.maxOps = maxOps;
+  }
+
+  public compare(i: number, j: number): void {
+    this.push(SortOp.Compare, i, j);
+  }
+
+  public swap(i: number, j: number): void {
+    this.push(SortOp.Swap, i, j);
+  }
+
+  public write(i: number, value: number): void {
+    this.push(SortOp.Write, i, value);
+  }
+
+  private push(op: SortOp, index: number, other: number): void {
+    if (this.length === this.maxOps) {
+      throw traceFull;
+    }
+    if (2 * this.length === this.ops.length) {
+      const ops = new Int32Array(Math.min(2 * this.ops.length, 2 * this.maxOps));
+      ops.set(this.ops);
+      this.ops = ops;
+    }
+    this.ops[2 * this.length] = index * 4 + op;
+    this.ops[2 * this.length + 1] = other;
+    this.length += 1;
+  }
+}
+
+/**
+ * Runs a sort on a copy of the values, recording up to maxOps of its operations. A sort that does
+ * more is stopped there rather than run to the end, as a quadratic sort of a large input can take
+ * billions of operations, and its result found with a plain sort.
+ */
+export const recordSort = ({ algorithm, values, maxOps }: SortTraceRequest): SortTrace => {
+  const recorder = new SortTraceRecorder(maxOps);
+  let sorted = values.slice();
+  let truncated = false;
+  try {
+    runSort(algorithm, sorted, recorder);
+  } catch (error) {
+    if (error !== traceFull) {
+      throw error;
+    }
+    truncated = true;
+    sorted = values.slice().sort();
+  }
+  return {
+    algorithm,
+    ops: recorder.ops.slice(0, 2 * recorder.length),
+    length: recorder.length,
+    truncated,
+    sorted,
+  };
+};
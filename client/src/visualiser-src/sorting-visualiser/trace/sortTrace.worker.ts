@@ -0,0 +1,7 @@
+import { recordSort, SortTraceRequest } from './sortTrace';
+
+// Records a sort off the main thread, handing its trace back without copying it
+globalThis.addEventListener('message', (event: MessageEvent<SortTraceRequest>) => {
+  const trace = recordSort(event.data);
+  globalThis.postMessage(trace, { transfer: [trace.ops.buffer, trace.sorted.buffer] });
+});
@@ -0,0 +1,20 @@
+import { SortTrace, SortTraceRequest } from './sortTrace';
+
+// Records a sort in a worker of its own, so several can be recorded at once
+const traceInWorker = (request: SortTraceRequest): Promise<SortTrace> =>
+  new Promise((resolve, reject) => {
+    const worker = new Worker(new URL('./sortTrace.worker.ts', import.meta.url), {
+      type: 'module',
+    });
+    worker.onmessage = (event: MessageEvent<SortTrace>) => {
+      worker.terminate();
+      resolve(event.data);
+    };
+    worker.onerror = (event: ErrorEvent) => {
+      worker.terminate();
+      reject(new Error(event.message));
+    };
+    worker.postMessage(request);
+  });
+
+export default traceInWorker;
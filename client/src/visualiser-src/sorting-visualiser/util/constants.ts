@@ -31,3 +31,14 @@ export const textAttributes = {
   'font-family': 'CodeText',
   opacity: 0,
 };
+
+// Sorting inputs too large to animate element by element, drawn on a canvas from a recorded trace
+export const largeSortMaxSize = 100000;
+export const maxTraceOps = 2 ** 22;
+export const defaultOpsPerFrame = 1000;
+
+// The colour of each algorithm in a race, in the order of sortAlgorithms
+export const raceColours = ['#E22B4F', '#FFBC53', '#33cccc', '#39AF8E', '#9B6BDF'];
+export const raceMaxSize = 1000000;
+// Operations a sort in a race does before it is stopped, a few seconds of counting
+export const raceMaxOps = 2 ** 28;
@@ -16,3 +16,12 @@ USER_PTYPE_PREPROCESSED = "ptype_output_preprocessed"
 
 # Amount of time to allow select.select() to wait for program stdout before timing out
 TIMEOUT_DURATION = 0.05
+
+# How often to check whether the program is blocked reading stdin while a step runs
+INPUT_POLL_INTERVAL = 0.02
+
+# Prefix of the named pipe that a user's stdin is relayed through, see src/utils.py
+STDIN_PIPE_PREFIX = "dsv_stdin_"
+
+# Cells of an array sent with each step; the client asks for the rest with readRange
+ARRAY_PAGE_CELLS = 200
@@ -1,11 +1,7 @@
 import gdb
 
 from src.gdb_scripts.custom_next import CustomNextCommand
-from src.gdb_scripts.parse_functions import (
-    get_type_decl_strs,
-    pycparser_parse_type_decls,
-    pycparser_parse_fn_decls,
-)
+from src.gdb_scripts.dwarf_types import parse_dwarf_decls
 from src.gdb_scripts.iomanager import IOManager
 from src.constants import CUSTOM_NEXT_COMMAND_NAME
 
@@ -25,15 +21,17 @@ class DebugSession:
         gdb.execute(f"file {program_name}")
 
         """
-        Necessary to store these three information here because the output
-        of the gdb instance for the command `info types` and `info functions -n`
-        is messed up after starting the debug session. So store this before
-        starting the debug session.
+        Read all user-defined types and functions from the DWARF debug info
+        of the binary in one pass, instead of parsing `info types` and
+        `info functions -n` with pycparser one declaration at a time.
+        CustomNextCommand needs these before the debug session starts to
+        break on every user-defined function.
         """
-        self.type_decl_strs = get_type_decl_strs()
-        self.parsed_type_decls = pycparser_parse_type_decls(
-            self.user_socket_id)
-        self.parsed_fn_decls = pycparser_parse_fn_decls(self.user_socket_id)
+        (
+            self.type_decl_strs,
+            self.parsed_type_decls,
+            self.parsed_fn_decls,
+        ) = parse_dwarf_decls(program_name, self.user_socket_id)
 
         self.io_manager = IOManager(user_socket_id=self.user_socket_id)
 
@@ -8,8 +8,9 @@ import re
 from pycparser import parse_file
 from src.gdb_scripts.MallocVisitor import MallocVisitor
 from src.gdb_scripts.parse_functions import get_type_name_of_stack_var
-from src.constants import USER_MALLOC_CALL_FILE_NAME, USER_MALLOC_CALL_PREPROCESSED
+from src.constants import USER_MALLOC_CALL_FILE_NAME, USER_MALLOC_CALL_PREPROCESSED, ARRAY_PAGE_CELLS
 from src.utils import create_abs_file_path
+from src.metrics import StepTimer, GDB_COMMAND, MEMORY_READ, PARSE
 
 from src.gdb_scripts.use_socketio_connection import useSocketIOConnection, enable_socketio_client_emit
 
@@ -20,6 +21,8 @@ abs_file_path = os.path.dirname(os.path.abspath(__file__))
 
 # use re.search with this, not match
 array_end = re.compile("\[\d+\]$", re.DOTALL)
+# The outermost dimension of an array type, e.g. the [3] of "int [3][4]"
+array_dim = re.compile(r"\[(\d+)\]")
 re_pointer_type = re.compile(r"([a-zA-Z_][a-zA-Z0-9_\s]*\*+)")
 
 ## Match pointer values printed out by gdb `print` command.
@@ -46,6 +49,7 @@ class CustomNextCommand(gdb.Command):
         self.parsed_type_decls = parsed_type_decls
         self.parsed_fn_decls = parsed_fn_decls
         self.heap_data = {}
+        self.timer = StepTimer()
         self.break_on_all_user_defined_functions()
         
         # Send start_data across socket
@@ -98,23 +102,25 @@ class CustomNextCommand(gdb.Command):
         with open(create_abs_file_path(USER_MALLOC_CALL_FILE_NAME), "w") as f:
             f.write(c_code_for_preprocessing)
 
-        subprocess.run(f"gcc -E {create_abs_file_path(USER_MALLOC_CALL_FILE_NAME)} > {create_abs_file_path(USER_MALLOC_CALL_PREPROCESSED)}",
-                       shell=True)
         try:
-            # Parse the preprocessed C code into an AST
-            # `cpp_args=r'-Iutils/fake_libc_include'` enables `#include` for parsing
-            line_ast = parse_file(create_abs_file_path(USER_MALLOC_CALL_PREPROCESSED), use_cpp=True,
-                                  cpp_args=r'-Iutils/fake_libc_include')
-            # print(line_ast)
+            with self.timer.span(PARSE, line=line_str):
+                subprocess.run(f"gcc -E {create_abs_file_path(USER_MALLOC_CALL_FILE_NAME)} > {create_abs_file_path(USER_MALLOC_CALL_PREPROCESSED)}",
+                               shell=True)
 
-            # Create a MallocVisitor instance
-            malloc_visitor = MallocVisitor()
+                # Parse the preprocessed C code into an AST
+                # `cpp_args=r'-Iutils/fake_libc_include'` enables `#include` for parsing
+                line_ast = parse_file(create_abs_file_path(USER_MALLOC_CALL_PREPROCESSED), use_cpp=True,
+                                      cpp_args=r'-Iutils/fake_libc_include')
+                # print(line_ast)
 
-            # Set the current node to the root of the AST
-            malloc_visitor.current_node = line_ast
+                # Create a MallocVisitor instance
+                malloc_visitor = MallocVisitor()
 
-            # Visit the AST to check for malloc calls
-            malloc_visitor.visit(line_ast)
+                # Set the current node to the root of the AST
+                malloc_visitor.current_node = line_ast
+
+                # Visit the AST to check for malloc calls
+                malloc_visitor.visit(line_ast)
 
             if heap_memory_value := process_malloc_call(malloc_visitor, self.parsed_type_decls):
                 heap_memory_addr = heap_memory_value["addr"]
@@ -135,7 +141,12 @@ class CustomNextCommand(gdb.Command):
         ## TODO: What about if malloc was present, doesnt it also get executed
         ## so we should bypass gdb next cmd here?
         if not variable_freed:
-            gdb.execute('next')
+            # gdb.execute only returns once the line has run, so a line that
+            # reads stdin is watched while it runs for the user to be prompted
+            pid = gdb.selected_inferior().pid
+            with self.timer.span(GDB_COMMAND, command="next"), \
+                    self.io_manager.watch_for_input(pid, lambda: request_user_input(self.user_socket_id)):
+                gdb.execute('next')
 
         # Immediately after executing next, check if the program has exited by evaluating $_exitcode
         if check_program_has_terminated():
@@ -145,25 +156,17 @@ class CustomNextCommand(gdb.Command):
             send_backend_data_to_server(self.user_socket_id, backend_data=exit_data)
             return
 
-        # TODO: Immediately after executing next, we need to check whether the program
-        # is waiting for stdin. If it is, then we need to send a signal to the
-        # server to tell the client to prompt the user for input.
-        if self.io_manager.check_is_waiting_for_input():
-            print("Program is waiting for input")
-            request_user_input(self.user_socket_id)
-            # print("Early exit from custom next")
-            # return
-
-        # == Get stack data after executing next command
-        stack_data = get_stack_data(self.parsed_type_decls)
-
-        # === Up date existing tracked heap data
-        # Make sure this is done AFTER executing the next command, so that the heap is actually updated
-        #TODO: account for address of the malloc'd part set changing (e.g. head = NULL)
-        #TODO: consider making updates happen only-as-they-happen (i.e. instead of changing a whole structure/field)?
-        #   an interesting way this could be done is by having stored struct/array attributes be pointers/objects based on memory address (or maybe just store the
-        #   memory address itself), then just update the object at the memory address and don't worry about anything else
-        self.heap_data = update_heap_data(self.heap_data, self.parsed_type_decls)
+        with self.timer.span(MEMORY_READ):
+            # == Get stack data after executing next command
+            stack_data = get_stack_data(self.parsed_type_decls)
+
+            # === Up date existing tracked heap data
+            # Make sure this is done AFTER executing the next command, so that the heap is actually updated
+            #TODO: account for address of the malloc'd part set changing (e.g. head = NULL)
+            #TODO: consider making updates happen only-as-they-happen (i.e. instead of changing a whole structure/field)?
+            #   an interesting way this could be done is by having stored struct/array attributes be pointers/objects based on memory address (or maybe just store the
+            #   memory address itself), then just update the object at the memory address and don't worry about anything else
+            self.heap_data = update_heap_data(self.heap_data, self.parsed_type_decls)
     
         backend_data = {
             "frame_info": frame_info,
@@ -175,11 +178,28 @@ class CustomNextCommand(gdb.Command):
         pprint(backend_data)
 
         send_backend_data_to_server(
-            self.user_socket_id, backend_data=backend_data)
+            self.user_socket_id, backend_data=backend_data, timings=self.timer.pop_spans())
 
         print(f"\n=== Finished running update_backend_state in gdb instance\n\n")
         return backend_data
 
+    def send_range(self, addr: str, element_type: str, start: int, count: int, step: int):
+        '''
+        Send cells [start, start + count) of the array of element_type at addr,
+        for an array the client only has the first page of. Run by the server on
+        a readRange event for the current step, which the client files the
+        cells under:
+
+        (gdb) python debug_session.custom_next_command.send_range("0x7ffe10", "int", 200, 200, 3)
+        '''
+        cells = read_array_range(addr, element_type, start, count)
+        send_range_to_server(self.user_socket_id, {
+            "step": step,
+            "addr": addr,
+            "start": start,
+            "cells": cells,
+        })
+
     def break_on_all_user_defined_functions(self):
         '''
         Break on all user-defined functions in the program so that the custom next command will step into it.
@@ -189,9 +209,10 @@ class CustomNextCommand(gdb.Command):
 
 
 @useSocketIOConnection
-def send_backend_data_to_server(user_socket_id: str = None, backend_data: dict = {}, sio=None):
+def send_backend_data_to_server(user_socket_id: str = None, backend_data: dict = {}, timings: list = None, sio=None):
     '''
     Args:
+        - timings: spans recorded by StepTimer during this step, see src/metrics.py
         - backend_data: dict containing data for the current stack frame and 
             also the heap, in the following format:
             {
@@ -224,13 +245,24 @@ def send_backend_data_to_server(user_socket_id: str = None, backend_data: dict =
         print(
             f"Sending backend_data to server, for user with socket_id {user_socket_id}")
         sio.emit("updatedBackendState",
-                 (user_socket_id, backend_data))
+                 (user_socket_id, backend_data, timings or []))
 
         enable_socketio_client_emit()
 
     else:
         print("No user_socket_id provided, so not sending backend_data to server")
 
+@useSocketIOConnection
+def send_range_to_server(user_socket_id: str = None, cell_range: dict = {}, sio=None):
+    if user_socket_id is not None:
+        print(f"Sending cells of {cell_range['addr']} to server, for user with socket_id {user_socket_id}")
+        sio.emit("sentRange", (user_socket_id, cell_range))
+
+        enable_socketio_client_emit()
+
+    else:
+        print("No user_socket_id provided, so not sending range to server")
+
 ## TODO: Create thread with socket recv loop to
 ## listen continuously to incoming socket data from debugger server.
 
@@ -239,7 +271,7 @@ def request_user_input(user_socket_id: str = None, sio=None):
     if user_socket_id is not None:
         print(
             f"Signalling to debugger server to request user for input, for user with socket_id {user_socket_id}")
-        sio.emit("requestUserInput",
+        sio.emit("programWaitingForInput",
                  (user_socket_id, ))
 
         enable_socketio_client_emit()
@@ -256,36 +288,54 @@ def remove_non_standard_characters(input_str):
     return clean_str
 
 
-def split_gdb_examine(gdb_examine_data, cellSize):
+def pointer_to(element_type):
     '''
-    Expects gdb_examine_data to be in the format of the x/<number of bytes>ub command: 
-    0x5555555592a0:	1	0	0	0	2	0	0	0
-    0x5555555592a8:	3	0   0   0
+    C spelling of a pointer to element_type, which for a row of a 2-D array
+    needs parentheses: "int" -> "int *", "int [4]" -> "int (*)[4]"
+    '''
+    if "[" in element_type:
+        base, dims = element_type.split("[", 1)
+        return f"{base.strip()} (*)[{dims}"
+    return f"{element_type} *"
 
-    x/ub gets numbers as unsigned ([0, 255) range), x/b gets them as signed ([-128, 127) range). The former is best to simplify integer reconstruction via bit shifting
 
-    See debugger/src/samples/heap_array_test.c for more info on how this works
-    Also see for format options to this x command: https://visualgdb.com/gdbreference/commands/x
+def cell_value(value):
+    '''
+    Convert a gdb.Value cell to what the client draws: chars as characters,
+    pointers as hex strings, rows of a 2-D array as lists
     '''
+    value_type = value.type.strip_typedefs()
+    if value_type.code == gdb.TYPE_CODE_ARRAY:
+        low, high = value_type.range()
+        return [cell_value(value[i]) for i in range(low, high + 1)]
+    if value_type.code == gdb.TYPE_CODE_PTR:
+        return hex(int(value))
+    if value_type.code == gdb.TYPE_CODE_FLT:
+        return float(value)
+    if value_type.code == gdb.TYPE_CODE_CHAR or value_type.name in ("char", "signed char", "unsigned char"):
+        return chr(int(value) % 256)
+    if value_type.code in (gdb.TYPE_CODE_INT, gdb.TYPE_CODE_BOOL, gdb.TYPE_CODE_ENUM):
+        return int(value)
+    return str(value)
+
+
+def read_array_range(addr, element_type, start, count):
+    '''
+    Read cells [start, start + count) of an array, at most ARRAY_PAGE_CELLS of
+    them, so that a huge array costs one page per step instead of all of it.
+    Callers clamp count to the array's length so a short array isn't read
+    past its end.
 
-    print(f"{gdb_examine_data=}")
-    result = []
-    count = 0
-    for line in gdb_examine_data.splitlines():
-        print(f"{line=}")
-        for number in line.split(":", 1)[1].split():
-            print(f"{number=}")
-            # gdb returns each number byte as a signed value (i.e. in the range [-128, 127] instead of [0, 255])
-            # negative numbers break when byte values are bit shifted and added together
-            number = int(number)
-            if count == 0:
-                result.append(number)
-            else:
-                result[-1] += number << (count * 8) # 8 is number of bits in a byte
-            count += 1
-            if count == cellSize:
-                count = 0
-    return result
+    gdb reads the cells in one go and formats them by type, so negative and
+    floating point numbers and the rows of 2-D arrays come out as in `print`.
+    '''
+    count = max(0, min(count, ARRAY_PAGE_CELLS))
+    if count == 0:
+        return []
+    first = gdb.parse_and_eval(f"({pointer_to(element_type)}) {addr}") + start
+    cells = first.cast(first.type.target().array(count - 1).pointer()).dereference()
+    cells.fetch_lazy()
+    return cell_value(cells)
 
 
 def create_struct_value(parsed_type_decls, struct_fields_str, struct_name):
@@ -469,6 +519,8 @@ def process_malloc_call(malloc_visitor: MallocVisitor, parsed_type_decls: any):
                     "cellSize": str(cellSize),
                     "size": bytes,
                     "nCells": str(int(bytes) // cellSize),
+                    "length": int(bytes) // cellSize,
+                    "elementType": array_type,
                     "array": [], # TODO: how is array updated?
                     "addr": address
                 }
@@ -534,9 +586,16 @@ def get_stack_data(parsed_type_decls: any):
 
         # === Extract value
         if array_end.search(type_name):
-            arr = [ eval(el.split()[0]) for el in value_str.strip("{}").split(",") ] # eval should be safe cause only interacting with gdb :P
-            stack_memory_value["nCells"] = len(arr)
+            # Only the first page is read, the client asks for the rest with readRange
+            match = array_dim.search(type_name)
+            element_type = (type_name[:match.start()] + type_name[match.end():]).strip()
+            n_cells = int(match.group(1))
+            arr = read_array_range(address, element_type, 0, min(n_cells, ARRAY_PAGE_CELLS))
+            stack_memory_value["nCells"] = n_cells
+            stack_memory_value["length"] = n_cells
+            stack_memory_value["elementType"] = element_type
             stack_memory_value["array"] = arr
+            value = arr
 
         elif type_name.startswith("struct") and not type_name.endswith("*"):
             value_str = value_str.strip().strip("{}").strip()
@@ -579,21 +638,14 @@ def update_heap_data(old_heap_data, parsed_type_decls):
     new_heap_data = {}
     for addr, heap_memory_value in old_heap_data.items(): #TODO: we're only updating the value attribute lmao, example code for array present
         if "array" in heap_memory_value: # don't really like this, maybe should keep boolean attribute
-            gdb_examine_data = gdb.execute(
-                    f'x/{heap_memory_value["size"]}ub {addr}', to_string=True)
-            print(f"{gdb_examine_data=}")
-
-            array_numbers = split_gdb_examine(
-                gdb_examine_data,
-                int(heap_memory_value["cellSize"]),
-            ) #TODO: splitting into big numbers is sketchy, we should have some standardised class thingo to setup the data (based on whether it's a list, struct etc.). create_struct_value partially does this
-
-            if heap_memory_value["typeName"] == "char":
-                heap_memory_value["array"] = [chr(x) for x in array_numbers]
-            elif heap_memory_value["typeName"][-1] == '*':
-                heap_memory_value["array"] = [hex(x) for x in array_numbers]
-            else:
-                heap_memory_value["array"] = array_numbers
+            # Only the first page is read, the client asks for the rest with readRange
+            #TODO: splitting into big numbers is sketchy, we should have some standardised class thingo to setup the data (based on whether it's a list, struct etc.). create_struct_value partially does this
+            heap_memory_value["array"] = read_array_range(
+                addr,
+                heap_memory_value["typeName"],
+                0,
+                min(int(heap_memory_value["nCells"]), ARRAY_PAGE_CELLS),
+            )
 
             new_heap_data[addr] = heap_memory_value
 
@@ -0,0 +1,422 @@
+"""
+Extract user-defined types and functions straight from the DWARF debug info
+of the compiled binary, in a single pass over the ELF file.
+
+This replaces scraping `info types` / `info functions -n` and then running
+`gcc -E` + pycparser once per declaration (see parse_functions.py), which
+costs a fork per type at the start of every debug session.
+
+Usage:
+
+```python
+type_decl_strs, types, functions = parse_dwarf_decls("/app/code/<sid>/main")
+```
+
+The returned values have the same shape as the results of
+`get_type_decl_strs()`, `pycparser_parse_type_decls()` and
+`pycparser_parse_fn_decls()` respectively, with layout information added:
+
+    struct entries:     "size", and per field "offset", "size" and
+                        "pointee" (type name pointed to, if a pointer)
+    typedef entries:    "size"
+    function entries:   params keep their names from the source
+
+Unlike the pycparser functions, this can run before or after the program
+has been started in gdb since it never asks gdb for anything.
+"""
+import os
+from pprint import pprint
+from elftools.elf.elffile import ELFFile
+
+from src.gdb_scripts.use_socketio_connection import useSocketIOConnection, enable_socketio_client_emit
+
+# DWARF tags that wrap another type without changing its layout
+CV_QUALIFIER_TAGS = {
+    "DW_TAG_const_type",
+    "DW_TAG_volatile_type",
+    "DW_TAG_restrict_type",
+    "DW_TAG_atomic_type",
+}
+
+TAG_KEYWORDS = {
+    "DW_TAG_structure_type": "struct",
+    "DW_TAG_union_type": "union",
+    "DW_TAG_enumeration_type": "enum",
+}
+
+# DWARF expression opcode used by old compilers for DW_AT_data_member_location
+DW_OP_plus_uconst = 0x23
+
+
+@useSocketIOConnection
+def parse_dwarf_decls(program_name: str, user_socket_id: str = None, sio=None):
+    '''
+    Read every struct, typedef and function declared with a line number in
+    `program_name` and send each one to the debugger server, exactly like
+    pycparser_parse_type_decls() and pycparser_parse_fn_decls() do.
+
+    Returns (type_decl_strs, types, functions).
+    '''
+    print(f"\n=== Reading DWARF debug info of {program_name}\n\n")
+
+    type_decl_strs, types, functions = read_dwarf_decls(program_name)
+
+    if user_socket_id is not None:
+        print("Sending DWARF type and function declarations -> server -> FE client...")
+        for result in types:
+            sio.emit("createdTypeDeclaration", (user_socket_id, result))
+        for result in functions.values():
+            sio.emit("createdFunctionDeclaration", (user_socket_id, result))
+        enable_socketio_client_emit()
+
+    print(f"\n=== Finished running parse_dwarf_decls in gdb instance\n\n")
+
+    return type_decl_strs, types, functions
+
+
+def read_dwarf_decls(program_name: str):
+    '''
+    Same as parse_dwarf_decls() but without any socket communication.
+    '''
+    type_decl_strs: list[str] = []
+    types: dict[str, dict] = {}
+    functions: dict[str, dict] = {}
+
+    with open(program_name, "rb") as f:
+        elf = ELFFile(f)
+        if not elf.has_dwarf_info():
+            raise Exception(
+                f"{program_name} has no DWARF debug info, compile it with -g")
+
+        dwarf = elf.get_dwarf_info()
+        for cu in dwarf.iter_CUs():
+            file_names = get_cu_file_names(dwarf, cu)
+            for die in cu.get_top_DIE().iter_children():
+                if "DW_AT_decl_line" not in die.attributes:
+                    # Base types and compiler generated types, `info types`
+                    # doesn't list these either
+                    continue
+                if "DW_AT_declaration" in die.attributes:
+                    # Forward declaration, the definition is elsewhere
+                    continue
+
+                file = file_names.get(attr(die, "DW_AT_decl_file"))
+                line_num = attr(die, "DW_AT_decl_line")
+
+                if die.tag == "DW_TAG_structure_type" and "DW_AT_name" in die.attributes:
+                    result = construct_struct_info(die, file, line_num)
+                elif die.tag == "DW_TAG_typedef":
+                    result = construct_typedef_info(die, file, line_num)
+                elif die.tag == "DW_TAG_subprogram":
+                    if "DW_AT_low_pc" in die.attributes or "DW_AT_ranges" in die.attributes:
+                        result = construct_fn_info(die, file, line_num)
+                        functions.setdefault(result["name"], result)
+                    continue
+                else:
+                    continue
+
+                # Headers included by several translation units produce the
+                # same type once per unit
+                if result["typeName"] not in types:
+                    types[result["typeName"]] = result
+                    type_decl_strs.append(result["original_line"])
+
+    print("\nUser-defined type declaration strings:")
+    pprint(type_decl_strs)
+
+    return type_decl_strs, list(types.values()), functions
+
+
+def construct_struct_info(die, file: str, line_num: int) -> dict:
+    '''
+    Example for `struct node { int data; struct node *next; };` on x86-64:
+    {
+        "typeName": "struct node",
+        "file": "linkedlist/linkedlist.h",
+        "line_num": 14,
+        "original_line": "struct node;",
+        "size": 16,
+        "fields": [
+            {"name": "data", "typeName": "int", "offset": 0, "size": 4, "pointee": None},
+            {"name": "next", "typeName": "struct node*", "offset": 8, "size": 8, "pointee": "struct node"},
+        ]
+    }
+    '''
+    type_name = get_type_name(die)
+    fields = []
+    for member in die.iter_children():
+        if member.tag != "DW_TAG_member":
+            continue
+        member_type = type_of(member)
+        fields.append({
+            "name": attr(member, "DW_AT_name"),
+            "typeName": get_type_name(member_type),
+            "offset": get_member_offset(member),
+            "size": get_type_size(member_type),
+            "pointee": get_pointee_name(member_type),
+        })
+
+    return {
+        "typeName": type_name,
+        "file": file,
+        "line_num": line_num,
+        "original_line": f"{type_name};",
+        "size": attr(die, "DW_AT_byte_size"),
+        "fields": fields,
+    }
+
+
+def construct_typedef_info(die, file: str, line_num: int) -> dict:
+    '''
+    Example for `typedef struct list List;`:
+    {
+        "typeName": "List",
+        "file": "linkedlist/linkedlist.h",
+        "line_num": 17,
+        "original_line": "typedef struct list List;",
+        "size": 16,
+        "type": {"typeName": "struct list"}
+    }
+
+    The typedef of an anonymous struct keeps its body, e.g.
+    "typedef struct { int x; int y; } Point;", with "type" {"typeName": "struct"}
+    '''
+    name = attr(die, "DW_AT_name")
+    target = type_of(die)
+    return {
+        "typeName": name,
+        "file": file,
+        "line_num": line_num,
+        "original_line": f"typedef {get_declaration(target, name)};",
+        "size": get_type_size(target),
+        "type": {"typeName": get_type_name(target)},
+    }
+
+
+def construct_fn_info(die, file: str, line_num: int) -> dict:
+    '''
+    Same format as ParseFuncDeclVisitor.constructInfo(), e.g.
+    {
+        "name": "append",
+        "file": "linkedlist/linkedlist.c",
+        "line_num": 21,
+        "original_line": "void append(struct list *l, int val);",
+        "return_type": "void",
+        "params": [
+            {"name": "l", "typeName": "struct list*"},
+            {"name": "val", "typeName": "int"},
+        ]
+    }
+    '''
+    name = attr(die, "DW_AT_name")
+    return_type = type_of(die)
+
+    params = []
+    for param in die.iter_children():
+        if param.tag != "DW_TAG_formal_parameter":
+            continue
+        params.append({
+            "name": attr(param, "DW_AT_name"),
+            "typeName": get_type_name(type_of(param)),
+        })
+
+    params_str = ", ".join(
+        get_declaration(type_of(param), attr(param, "DW_AT_name") or "")
+        for param in die.iter_children()
+        if param.tag == "DW_TAG_formal_parameter"
+    )
+    if not params_str and attr(die, "DW_AT_prototyped"):
+        params_str = "void"
+
+    return {
+        "name": name,
+        "file": file,
+        "line_num": line_num,
+        "original_line": f"{get_declaration(return_type, f'{name}({params_str})')};",
+        "return_type": get_type_name(return_type),
+        "params": params,
+    }
+
+
+def get_type_name(die) -> str:
+    '''
+    Type names in the same format as the pycparser visitors and
+    get_type_name() in parse_functions.py, e.g. "struct node*", "int[]", "List".
+    Qualifiers such as const are dropped.
+    '''
+    if die is None:
+        return "void"
+    if die.tag in CV_QUALIFIER_TAGS:
+        return get_type_name(type_of(die))
+    if die.tag == "DW_TAG_pointer_type":
+        return f"{get_type_name(type_of(die))}*"
+    if die.tag == "DW_TAG_array_type":
+        return f"{get_type_name(type_of(die))}[]"
+    if die.tag == "DW_TAG_subroutine_type":
+        return f"{get_type_name(type_of(die))}()"
+    if die.tag in TAG_KEYWORDS:
+        name = attr(die, "DW_AT_name")
+        return f"{TAG_KEYWORDS[die.tag]} {name}" if name else TAG_KEYWORDS[die.tag]
+    return attr(die, "DW_AT_name") or "void"
+
+
+def get_declaration(die, declarator: str) -> str:
+    '''
+    Build a C declaration of `declarator` with the given type, e.g.
+    get_declaration(<int[4]>, "arr") == "int arr[4]"
+    get_declaration(<void (*)(int)>, "cb") == "void (*cb)(int)"
+    '''
+    while die is not None and die.tag in CV_QUALIFIER_TAGS:
+        die = type_of(die)
+
+    if die is None:
+        return f"void {declarator}".strip()
+    if die.tag == "DW_TAG_pointer_type":
+        target = type_of(die)
+        if target is not None and target.tag in ("DW_TAG_array_type", "DW_TAG_subroutine_type"):
+            return get_declaration(target, f"(*{declarator})")
+        return get_declaration(target, f"*{declarator}")
+    if die.tag == "DW_TAG_array_type":
+        dims = "".join(f"[{n if n is not None else ''}]" for n in get_array_dims(die))
+        return get_declaration(type_of(die), f"{declarator}{dims}")
+    if die.tag == "DW_TAG_subroutine_type":
+        params = ", ".join(
+            get_type_name(type_of(param))
+            for param in die.iter_children()
+            if param.tag == "DW_TAG_formal_parameter"
+        )
+        return get_declaration(type_of(die), f"{declarator}({params})")
+    if die.tag in TAG_KEYWORDS and "DW_AT_name" not in die.attributes:
+        # Anonymous types have no name to refer to them by, only their body
+        return f"{get_anonymous_body(die)} {declarator}".strip()
+    return f"{get_type_name(die)} {declarator}".strip()
+
+
+def get_anonymous_body(die) -> str:
+    '''
+    The definition of an anonymous struct, union or enum, e.g.
+    "struct { Point corner; unsigned int flags : 3; }" or "enum { CIRCLE = 0 }"
+    '''
+    keyword = TAG_KEYWORDS[die.tag]
+    if die.tag == "DW_TAG_enumeration_type":
+        enumerators = ", ".join(
+            f"{attr(child, 'DW_AT_name')} = {attr(child, 'DW_AT_const_value')}"
+            for child in die.iter_children()
+            if child.tag == "DW_TAG_enumerator"
+        )
+        return f"{keyword} {{ {enumerators} }}"
+
+    members = []
+    for member in die.iter_children():
+        if member.tag != "DW_TAG_member":
+            continue
+        declaration = get_declaration(type_of(member), attr(member, "DW_AT_name") or "")
+        if (bit_size := attr(member, "DW_AT_bit_size")) is not None:
+            declaration += f" : {bit_size}"
+        members.append(f"{declaration};")
+    return f"{keyword} {{ {' '.join(members)} }}"
+
+
+def get_type_size(die) -> int | None:
+    while die is not None and "DW_AT_byte_size" not in die.attributes:
+        if die.tag == "DW_TAG_array_type":
+            elem_size = get_type_size(type_of(die))
+            count = 1
+            for n in get_array_dims(die):
+                if n is None:
+                    return None
+                count *= n
+            return elem_size * count if elem_size is not None else None
+        if die.tag == "DW_TAG_pointer_type":
+            return die.cu["address_size"]
+        die = type_of(die)
+    return attr(die, "DW_AT_byte_size") if die is not None else None
+
+
+def get_pointee_name(die) -> str | None:
+    while die is not None and (die.tag in CV_QUALIFIER_TAGS or die.tag == "DW_TAG_typedef"):
+        die = type_of(die)
+    if die is None or die.tag != "DW_TAG_pointer_type":
+        return None
+    return get_type_name(type_of(die))
+
+
+def get_array_dims(die) -> list[int | None]:
+    dims = []
+    for subrange in die.iter_children():
+        if subrange.tag != "DW_TAG_subrange_type":
+            continue
+        if (count := attr(subrange, "DW_AT_count")) is not None:
+            dims.append(count)
+        elif isinstance(upper := attr(subrange, "DW_AT_upper_bound"), int):
+            dims.append(upper + 1)
+        else:
+            # Flexible array member or VLA
+            dims.append(None)
+    return dims
+
+
+def get_member_offset(die) -> int | None:
+    location = attr(die, "DW_AT_data_member_location")
+    if isinstance(location, int):
+        return location
+    if location is None:
+        # Bit-field members, or the first member of a union
+        return (attr(die, "DW_AT_data_bit_offset") or 0) // 8
+
+    # DWARF 2 encodes the offset as an expression: DW_OP_plus_uconst <uleb128>
+    if location and location[0] == DW_OP_plus_uconst:
+        offset, shift = 0, 0
+        for byte in location[1:]:
+            offset |= (byte & 0x7f) << shift
+            shift += 7
+            if not byte & 0x80:
+                break
+        return offset
+    return None
+
+
+def get_cu_file_names(dwarf, cu) -> dict[int, str]:
+    '''
+    Map DW_AT_decl_file indices of a compilation unit to file names, in the
+    same form `info types` shows them (e.g. "linkedlist/linkedlist.h").
+    '''
+    lineprog = dwarf.line_program_for_CU(cu)
+    if lineprog is None:
+        return {}
+
+    version = lineprog.header["version"]
+    dirs = [d.decode() if isinstance(d, bytes) else d
+            for d in lineprog.header["include_directory"]]
+
+    file_names = {}
+    for i, entry in enumerate(lineprog.header["file_entry"]):
+        name = entry.name.decode() if isinstance(entry.name, bytes) else entry.name
+        # Before DWARF 5, file and directory indices are 1-based and directory 0
+        # is the compilation directory
+        dir_index = entry.dir_index if version >= 5 else entry.dir_index - 1
+        if entry.dir_index > 0 and not os.path.isabs(name) and 0 <= dir_index < len(dirs):
+            name = os.path.join(dirs[dir_index], name)
+        file_names[i if version >= 5 else i + 1] = name
+
+    return file_names
+
+
+def type_of(die):
+    if "DW_AT_type" not in die.attributes:
+        return None
+    return die.get_DIE_from_attribute("DW_AT_type")
+
+
+def attr(die, name: str):
+    if name not in die.attributes:
+        return None
+    value = die.attributes[name].value
+    return value.decode() if isinstance(value, bytes) else value
+
+
+if __name__ == '__main__':
+    # For testing purposes, outside of gdb:
+    # $ cd debugger && python3 -m src.gdb_scripts.dwarf_types src/samples/linkedlist/main3
+    import sys
+    pprint(read_dwarf_decls(sys.argv[1]))
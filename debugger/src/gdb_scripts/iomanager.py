@@ -1,10 +1,15 @@
+import atexit
+from contextlib import contextmanager
 import os
 import pty
 import select
-from typing import Optional
+import threading
+from typing import Callable, Optional
 import gdb
 
-from src.constants import TIMEOUT_DURATION
+from src.constants import INPUT_POLL_INTERVAL
+from src.stdin_wait import waiting_for_input
+from src.utils import get_stdin_pipe_path
 from src.gdb_scripts.use_socketio_connection import useSocketIOConnection, enable_socketio_client_emit
 
 
@@ -38,29 +43,70 @@ class IOManager:
         # (e.g. /dev/pts/X)
         gdb.execute(f"tty {os.ttyname(slave_fd)}")
 
+        # gdb does not read commands while a step runs, so stdin from the
+        # server comes through a named pipe instead, see server.send_stdin
+        self.stdin_pipe_path = None
+        if user_socket_id is not None:
+            self.stdin_pipe_path = get_stdin_pipe_path(user_socket_id)
+            if not os.path.exists(self.stdin_pipe_path):
+                os.mkfifo(self.stdin_pipe_path)
+                atexit.register(os.unlink, self.stdin_pipe_path)
+            threading.Thread(target=self.relay_stdin, daemon=True).start()
+
     def read(self) -> Optional[str]:
-        (data_to_read, _, _) = select.select(
-            [self.master_fd], [], [], TIMEOUT_DURATION)
+        '''
+        Read what the program printed during the last step. The program is
+        stopped by then, so its output is already buffered and there is no
+        need to wait for it.
+        '''
+        (data_to_read, _, _) = select.select([self.master_fd], [], [], 0)
         if data_to_read:
             return os.read(self.master_fd, self.max_read_bytes).decode()
         else:
             return None
 
-    def check_is_waiting_for_input(self) -> bool:
+    def check_is_waiting_for_input(self, pid: int) -> bool:
         '''
-        Check whether the program stdin is waiting for user input.
-        Note: This attempt does not work. It always returns True even when the program is not waiting for input, because the program is always waiting for input to be buffered.
+        Check whether the running program is blocked reading stdin.
         '''
-        (_, data_to_write, _) = select.select(
-            [], [self.master_fd], [], TIMEOUT_DURATION)
-        print(
-            "=======================================\n=================================\n")
-        print(f"{data_to_write=}")
-        return bool(data_to_write)
+        return waiting_for_input(pid)
+
+    @contextmanager
+    def watch_for_input(self, pid: int, on_waiting: Callable[[], None]):
+        '''
+        While the body runs (e.g. `gdb.execute("next")`), call on_waiting
+        each time the program blocks reading stdin. Steps that don't read
+        stdin finish without waiting on the watcher.
+        '''
+        finished = threading.Event()
+
+        def watch():
+            waiting = False
+            while not finished.wait(INPUT_POLL_INTERVAL):
+                blocked = self.check_is_waiting_for_input(pid)
+                if blocked and not waiting:
+                    on_waiting()
+                waiting = blocked
+
+        threading.Thread(target=watch, daemon=True).start()
+        try:
+            yield
+        finally:
+            finished.set()
 
     def write(self, data: str):
         os.write(self.master_fd, data.encode())
 
+    def relay_stdin(self):
+        '''
+        Copy everything written to the stdin pipe to the program. Opening the
+        pipe blocks until the server opens it to write.
+        '''
+        while True:
+            with open(self.stdin_pipe_path, "rb", buffering=0) as pipe:
+                while data := pipe.read(self.max_read_bytes):
+                    os.write(self.master_fd, data)
+
     def read_and_send(self):
         output = self.read()
         sendProgramOutputToServer(
@@ -0,0 +1,80 @@
+"""
+Tests for dwarf_types.py against samples/dwarf_types.c, compiled the way
+server.py compiles user code. Run outside of gdb, from debugger/:
+
+$ python3 -m pytest src/gdb_scripts/test_dwarf_types.py
+"""
+import subprocess
+from pathlib import Path
+
+import pytest
+
+from src.gdb_scripts.dwarf_types import read_dwarf_decls
+
+samples = Path(__file__).parent.parent / "samples"
+
+
+@pytest.fixture(scope="module")
+def decls(tmp_path_factory):
+    exe = tmp_path_factory.mktemp("dwarf") / "dwarf_types"
+    subprocess.run(
+        ["gcc", "-ggdb", samples / "dwarf_types.c", "-o", exe], check=True
+    )
+    type_decl_strs, types, functions = read_dwarf_decls(str(exe))
+    return type_decl_strs, {t["typeName"]: t for t in types}, functions
+
+
+def test_struct(decls):
+    _, types, _ = decls
+    node = types["struct node"]
+    assert node["original_line"] == "struct node;"
+    assert node["size"] == 16
+    assert node["fields"] == [
+        {"name": "data", "typeName": "int", "offset": 0, "size": 4, "pointee": None},
+        {"name": "next", "typeName": "struct node*", "offset": 8, "size": 8,
+         "pointee": "struct node"},
+    ]
+
+
+def test_typedefs(decls):
+    _, types, _ = decls
+    assert types["Node"]["original_line"] == "typedef struct node Node;"
+    assert types["Node"]["type"] == {"typeName": "struct node"}
+    assert types["Node"]["size"] == 16
+    assert types["Shape"]["original_line"] == "typedef struct shape *Shape;"
+    assert types["Shape"]["size"] == 8
+
+
+def test_anonymous_struct_typedef(decls):
+    type_decl_strs, types, _ = decls
+    point = types["Point"]
+    # The body, not a made up `struct Point` tag
+    assert point["original_line"] == "typedef struct { int x; int y; } Point;"
+    assert point["type"] == {"typeName": "struct"}
+    assert point["size"] == 8
+    assert point["original_line"] in type_decl_strs
+    # Anonymous types are only declared through their typedefs and fields
+    assert "struct" not in types
+
+
+def test_nested_anonymous_members(decls):
+    _, types, _ = decls
+    shape = types["struct shape"]
+    assert shape["size"] == 32
+    name, box, kind = shape["fields"]
+    assert (name["typeName"], name["offset"], name["size"]) == ("char[]", 0, 16)
+    assert (box["typeName"], box["offset"], box["size"]) == ("struct", 16, 12)
+    assert (kind["typeName"], kind["offset"], kind["size"]) == ("enum", 28, 4)
+
+
+def test_functions(decls):
+    _, _, functions = decls
+    assert functions["area"]["original_line"] == "int area(Shape shape, int (*scale)(int));"
+    assert functions["area"]["params"] == [
+        {"name": "shape", "typeName": "Shape"},
+        {"name": "scale", "typeName": "int()*"},
+    ]
+    assert functions["twice"]["original_line"] == "int twice(int n);"
+    assert functions["main"]["original_line"] == "int main(void);"
+    # Declared in headers, defined in libc
+    assert "malloc" not in functions
@@ -0,0 +1,140 @@
+"""
+Per-phase timings of debug steps, for finding regressions and sizing hardware.
+
+Used from two places:
+    - the gdb instance (gdb_scripts/custom_next.py) times the phases of a
+      custom_next step and sends the spans along with the backend state
+    - the debugger server (server.py) times compiling, serialising and
+      emitting backend states, collects the spans from the gdb instances and
+      serves them over local HTTP:
+        GET /metrics        Prometheus text format histograms
+        GET /trace/<sid>    Chrome trace JSON (chrome://tracing) of a session
+
+The phases and buckets are debugger2's, see phases.py.
+"""
+
+import json
+import os
+import time
+from bisect import bisect_left
+from collections import OrderedDict, defaultdict, deque
+from contextlib import contextmanager
+
+from src.phases import BUCKETS, HEADER, MAX_TRACE_EVENTS, MAX_TRACED_SESSIONS, PHASES, histogram_lines
+from src.phases import COMPILE, GDB_COMMAND, MEMORY_READ, PARSE, SERIALISE, EMIT, STEP  # noqa: F401
+
+
+class StepTimer:
+    '''
+    Collects spans in the gdb instance. Spans use wall clock time in
+    microseconds so the server can merge them with its own.
+
+    Usage:
+    ```
+        timer = StepTimer()
+        with timer.span(GDB_COMMAND, command="next"):
+            gdb.execute("next")
+        spans = timer.pop_spans()
+    ```
+    '''
+
+    def __init__(self):
+        self.spans = []
+
+    @contextmanager
+    def span(self, phase: str, **args):
+        start = time.time()
+        try:
+            yield
+        finally:
+            self.spans.append({
+                "phase": phase,
+                "start": start * 1e6,
+                "duration": (time.time() - start) * 1e6,
+                "pid": os.getpid(),
+                "args": args,
+            })
+
+    def pop_spans(self) -> list:
+        spans, self.spans = self.spans, []
+        return spans
+
+
+class Metrics:
+    def __init__(self):
+        # phase -> [bucket counts..., +Inf count], sum, count
+        self.buckets = defaultdict(lambda: [0] * (len(BUCKETS) + 1))
+        self.sums = defaultdict(float)
+        self.counts = defaultdict(int)
+        self.traces = OrderedDict()
+
+    @contextmanager
+    def span(self, phase: str, session_id: str = None, **args):
+        start = time.time()
+        try:
+            yield
+        finally:
+            self.record(session_id, {
+                "phase": phase,
+                "start": start * 1e6,
+                "duration": (time.time() - start) * 1e6,
+                "args": args,
+            })
+
+    def record(self, session_id: str, span: dict):
+        '''
+        `span` is in the format produced by StepTimer.
+        '''
+        phase = span["phase"]
+        seconds = span["duration"] / 1e6
+        self.buckets[phase][bisect_left(BUCKETS, seconds)] += 1
+        self.sums[phase] += seconds
+        self.counts[phase] += 1
+
+        if session_id is None:
+            return
+        if session_id not in self.traces:
+            self.traces[session_id] = deque(maxlen=MAX_TRACE_EVENTS)
+            if len(self.traces) > MAX_TRACED_SESSIONS:
+                self.traces.popitem(last=False)
+        self.traces[session_id].append({
+            "name": phase,
+            "cat": "debugger",
+            "ph": "X",
+            "ts": span["start"],
+            "dur": span["duration"],
+            "pid": span.get("pid", os.getpid()),
+            "tid": PHASES.index(phase) if phase in PHASES else -1,
+            "args": span.get("args", {}),
+        })
+
+    def chrome_trace(self, session_id: str) -> dict:
+        return {
+            "traceEvents": list(self.traces.get(session_id, [])),
+            "displayTimeUnit": "ms",
+            "otherData": {"session": session_id},
+        }
+
+    def prometheus(self) -> str:
+        lines = list(HEADER)
+        for phase in sorted(self.buckets):
+            lines += histogram_lines(phase, self.buckets[phase], self.sums[phase], self.counts[phase])
+        return "\n".join(lines) + "\n"
+
+    def wsgi_app(self, environ, start_response):
+        '''
+        Plain WSGI app serving /metrics and /trace/<sid>, to localhost only.
+        '''
+        path = environ.get("PATH_INFO", "")
+        if environ.get("REMOTE_ADDR") not in ("127.0.0.1", "::1"):
+            status, content_type, body = "403 Forbidden", "text/plain", "Forbidden"
+        elif path == "/metrics":
+            status, content_type, body = "200 OK", "text/plain; version=0.0.4", self.prometheus()
+        elif path.startswith("/trace/"):
+            status, content_type = "200 OK", "application/json"
+            body = json.dumps(self.chrome_trace(path[len("/trace/"):]))
+        else:
+            status, content_type, body = "404 Not Found", "text/plain", "Not Found"
+
+        start_response(status, [("Content-Type", content_type)])
+        return [body.encode()]
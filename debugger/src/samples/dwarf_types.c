@@ -0,0 +1,47 @@
+#include <stdlib.h>
+
+// Declarations of every kind read from DWARF by gdb_scripts/dwarf_types.py,
+// see test_dwarf_types.py
+
+struct node {
+    int data;
+    struct node *next;
+};
+
+typedef struct node Node;
+
+typedef struct {
+    int x;
+    int y;
+} Point;
+
+struct shape {
+    char name[16];
+    struct {
+        Point corner;
+        unsigned flags : 3;
+    } box;
+    enum { CIRCLE, SQUARE = 4 } kind;
+};
+
+typedef struct shape *Shape;
+
+int area(Shape shape, int (*scale)(int)) {
+    return scale(shape->box.corner.x * shape->box.corner.y);
+}
+
+static int twice(int n) {
+    return 2 * n;
+}
+
+int main(void) {
+    Node *head = malloc(sizeof(Node));
+    head->data = 1;
+    head->next = NULL;
+
+    struct shape square = {"square", {{2, 3}, 1}, SQUARE};
+    int result = area(&square, twice);
+
+    free(head);
+    return result == 12 ? 0 : 1;
+}
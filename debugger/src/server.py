@@ -5,7 +5,9 @@ clients as well as gdb instance clients.
 Must run in /debugger/src directory (because the gdb commands will source a python file by relative path e.g. ./gdb_scripts/custom_next.py)
 """
 
+import json
 import os
+import re
 import shutil
 from pprint import pprint
 import socketio
@@ -21,7 +23,8 @@ from constants import (
     DEBUG_SESSION_VAR_NAME,
     TIMEOUT_DURATION,
 )
-from utils import make_non_blocking, get_gdb_script, get_subprocess_output
+from utils import make_non_blocking, get_gdb_script, get_subprocess_output, get_stdin_pipe_path
+from metrics import Metrics, COMPILE, SERIALISE, EMIT, STEP
 
 # Parent directory of this python script e.g. "/user/.../debugger/src"
 # In the docker container this will be "/app/src"
@@ -42,6 +45,18 @@ procs = {
 """
 procs = {}
 
+"""
+Map from a FE client socket_id to the number of states sent to it, which is
+the step its gdb instance is stopped at and the only one readRange can read
+"""
+steps = {}
+
+"""
+Step phase timings of all sessions, served at /metrics and /trace/<socket_id>
+to localhost. See src/metrics.py
+"""
+metrics = Metrics()
+
 io = socketio.Server(cors_allowed_origins="*")
 
 
@@ -138,9 +153,10 @@ def mainDebug(socket_id: str, code: str) -> None:
     with open(os.path.join(new_code_dir, "main.c"), "w", encoding="utf-8") as f:
         f.write(code)
 
-    compilation_process = subprocess.run(
-        ["gcc", "-ggdb", "main.c", "-o", "main"], capture_output=True, cwd=new_code_dir
-    )
+    with metrics.span(COMPILE, socket_id):
+        compilation_process = subprocess.run(
+            ["gcc", "-ggdb", "main.c", "-o", "main"], capture_output=True, cwd=new_code_dir
+        )
 
     if compilation_process.stderr:
         io.emit("compileError", compilation_process.stderr.decode())
@@ -171,6 +187,7 @@ def mainDebug(socket_id: str, code: str) -> None:
         make_non_blocking(proc.stderr)
 
     procs[socket_id] = proc
+    steps[socket_id] = 0
 
     for line in map(lambda line: line.strip(), gdb_script.strip().split("\n")):
         proc.stdin.write(line + "\n")
@@ -192,17 +209,18 @@ def executeNext(socket_id: str) -> None:
     print(f"Found subprocess for FE client socket_id {socket_id}:")
     print(proc)
 
-    print(f"\n=== Sending '{CUSTOM_NEXT_COMMAND_NAME}' command to gdb instance {proc.pid}")
-    proc.stdin.write(f"{CUSTOM_NEXT_COMMAND_NAME}\n")
-    proc.stdin.flush()
-    get_subprocess_output(proc, TIMEOUT_DURATION)
+    with metrics.span(STEP, socket_id):
+        print(f"\n=== Sending '{CUSTOM_NEXT_COMMAND_NAME}' command to gdb instance {proc.pid}")
+        proc.stdin.write(f"{CUSTOM_NEXT_COMMAND_NAME}\n")
+        proc.stdin.flush()
+        get_subprocess_output(proc, TIMEOUT_DURATION)
 
-    # Reading new output from the program relies on the fact that next was
-    # executed just before. This is expected to happen in the call to the custom
-    # next command above.
-    proc.stdin.write(f"python {DEBUG_SESSION_VAR_NAME}.io_manager.read_and_send()\n")
-    proc.stdin.flush()
-    get_subprocess_output(proc, TIMEOUT_DURATION)
+        # Reading new output from the program relies on the fact that next was
+        # executed just before. This is expected to happen in the call to the custom
+        # next command above.
+        proc.stdin.write(f"python {DEBUG_SESSION_VAR_NAME}.io_manager.read_and_send()\n")
+        proc.stdin.flush()
+        get_subprocess_output(proc, TIMEOUT_DURATION)
 
     io.emit("executeNext", f"Finished executeNext event on server-side")
 
@@ -251,6 +269,39 @@ def SIGINT(socket_id: str) -> None:
     io.emit("acknowledgedSIGINT")
 
 
+@io.event
+def readRange(socket_id: str, request: dict) -> None:
+    """
+    Read more cells of an array the client was only sent the first page of.
+    Only the current step can be read, the gdb instance sends them back with
+    a sentRange event. Earlier steps get an empty page, so the client stops
+    waiting for them.
+    """
+
+    proc: subprocess.Popen = procs[socket_id]
+    if proc is None:
+        raise Exception(f"readRange: No subprocess found for user with socket_id {socket_id}")
+
+    # The request is written into a gdb python command, so only plain values get through
+    addr = request["addr"]
+    element_type = request["elementType"]
+    if not re.fullmatch(r"0x[0-9a-fA-F]+", addr) or not re.fullmatch(r"[\w *]+", element_type):
+        print(f"readRange: ignoring malformed request {request}")
+        return
+    start, count = int(request["start"]), int(request["count"])
+    step = int(request.get("step", steps.get(socket_id, 0)))
+    if step != steps.get(socket_id, 0):
+        print(f"readRange: step {step} is no longer in gdb instance {proc.pid}")
+        io.emit("readRange", {"step": step, "addr": addr, "start": start, "cells": []}, room=socket_id)
+        return
+
+    print(f"Reading {count} cells of {element_type} at {addr} from {start} in gdb instance {proc.pid}")
+    proc.stdin.write(
+        f"python {DEBUG_SESSION_VAR_NAME}.custom_next_command.send_range({addr!r}, {element_type!r}, {start}, {count}, {step})\n")
+    proc.stdin.flush()
+    get_subprocess_output(proc, TIMEOUT_DURATION)
+
+
 @io.event
 def send_stdin(socket_id: str, data: str):
     """
@@ -266,8 +317,17 @@ def send_stdin(socket_id: str, data: str):
 
     print(f"Sending stdin to gdb instance {proc.pid}:")
     print(data)
-    proc.stdin.write(f'python {DEBUG_SESSION_VAR_NAME}.io_manager.write("{data}\\n")\n')
-    proc.stdin.flush()
+    try:
+        # Relayed by the gdb instance's IOManager, even while a step that is
+        # blocked reading stdin keeps gdb from reading commands
+        pipe_fd = os.open(get_stdin_pipe_path(socket_id), os.O_WRONLY | os.O_NONBLOCK)
+    except OSError:
+        # No IOManager relaying the pipe (e.g. a legacy gdb script)
+        proc.stdin.write(f'python {DEBUG_SESSION_VAR_NAME}.io_manager.write("{data}\\n")\n')
+        proc.stdin.flush()
+        return
+    with os.fdopen(pipe_fd, "w") as pipe:
+        pipe.write(f"{data}\n")
 
 
 @io.event
@@ -300,20 +360,40 @@ def createdTypeDeclaration(socket_id: str, user_socket_id, type) -> None:
 def requestUserInput(socket_id: str, user_socket_id) -> None:
     print(f"Event requestUserInput received from gdb instance with socket_id {socket_id}:")
     print(f"Requesting user input from FE user {user_socket_id}:")
-    io.emit("requestUserInput", room=user_socket_id)
+    io.emit("programWaitingForInput", room=user_socket_id)
 
 
 @io.event
-def updatedBackendState(socket_id: str, user_socket_id, backend_data) -> None:
+def updatedBackendState(socket_id: str, user_socket_id, backend_data, timings=None) -> None:
     """
     Event to send the current backend state (including stack and heap data) to
     the specified frontend client.
-    Should be emitted by a gdb instance while running a `custom_next` custom command.
+    Should be emitted by a gdb instance while running a `custom_next` custom command,
+    along with the timings of the step's phases in the gdb instance.
     """
     print(f"Event updatedBackendState received from gdb instance with socket_id {socket_id}:")
+    for span in timings or []:
+        metrics.record(user_socket_id, span)
+
     print(f"Sending backend state to client {user_socket_id}:")
     pprint(backend_data)
-    io.emit("sendBackendStateToUser", backend_data, room=user_socket_id)
+    # Serialised apart from emitting, like debugger2 does, so both backends
+    # report the same phases at /metrics
+    with metrics.span(SERIALISE, user_socket_id):
+        backend_data = json.loads(json.dumps(backend_data))
+    if not backend_data.get("exited"):
+        steps[user_socket_id] = steps.get(user_socket_id, 0) + 1
+    with metrics.span(EMIT, user_socket_id):
+        io.emit("sendBackendStateToUser", backend_data, room=user_socket_id)
+
+
+@io.event
+def sentRange(socket_id: str, user_socket_id: str, cell_range: dict) -> None:
+    """
+    Cells read by a gdb instance for a readRange event, sent on to the client
+    """
+    print(f"Event sentRange received from gdb instance with socket_id {socket_id}:")
+    io.emit("readRange", cell_range, room=user_socket_id)
 
 
 @io.event
@@ -328,6 +408,6 @@ def produced_stdout_output(socket_id: str, user_socket_id: str, data: str):
 
 
 print("Starting server...")
-app = socketio.WSGIApp(io)
+app = socketio.WSGIApp(io, wsgi_app=metrics.wsgi_app)
 eventlet.wsgi.server(eventlet.listen(("", 8000)), app)
 # Server start will block python script until server terminated
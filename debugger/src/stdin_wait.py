@@ -0,0 +1,58 @@
+from platform import machine
+
+"""
+Whether a running process is blocked reading its stdin, for both backends.
+Each backend is built on its own, so debugger/src/stdin_wait.py is a copy
+for the legacy gdb scripts, kept identical by debugger/src/test_shared.py.
+Only the standard library, so it runs in gdb's Python too.
+"""
+
+# Syscalls that read fd 0 when their first argument is 0, by architecture
+READ_SYSCALLS = {
+    "x86_64": {0, 17, 19},  # read, pread64, readv
+    "aarch64": {63, 65, 67},  # read, readv, pread64
+}
+# Kernel functions a process sleeps in while reading a tty or pipe
+READ_WCHANS = {"wait_woken", "n_tty_read", "pipe_read", "anon_pipe_read"}
+
+
+def waiting_for_input(pid: int) -> bool:
+    """
+    Whether a running process is blocked reading its stdin, from the
+    syscall it is in or, if that is not readable, what it is sleeping on
+    """
+
+    try:
+        with open(f"/proc/{pid}/syscall") as file:
+            return _reads_stdin(file.read(), machine())
+    except OSError:
+        pass
+    try:
+        with open(f"/proc/{pid}/wchan") as file:
+            return file.read().strip() in READ_WCHANS
+    except OSError:
+        return False
+
+
+def _reads_stdin(syscall: str, arch: str) -> bool:
+    """
+    Parse /proc/<pid>/syscall: the syscall number and its arguments, or
+    "running", or -1 when the process is not in a syscall
+
+    >>> _reads_stdin("0 0x0 0x55e2a0 0x400 0x0 0x0 0x0 0x7ffd", "x86_64")
+    True
+    >>> _reads_stdin("63 0x0 0x55e2a0 0x400 0x0 0x0 0x0 0x7ffd", "aarch64")
+    True
+    >>> _reads_stdin("0 0x3 0x55e2a0 0x400 0x0 0x0 0x0 0x7ffd", "x86_64")
+    False
+    >>> _reads_stdin("230 0x0 0x0 0x7ffd 0x7ffd 0x0 0x0 0x7ffd", "x86_64")
+    False
+    >>> _reads_stdin("running", "x86_64"), _reads_stdin("-1 0x7ffd", "x86_64")
+    (False, False)
+    """
+
+    number, *args = syscall.split()
+    if not number.isdigit() or not args:
+        return False
+    reads = READ_SYSCALLS.get(arch, {0})
+    return int(number) in reads and int(args[0], 16) == 0
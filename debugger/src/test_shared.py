@@ -0,0 +1,18 @@
+"""
+Modules copied from debugger2, since each backend's Docker image is built
+from its own directory. Run from debugger/:
+
+$ python3 -m pytest src/test_shared.py
+"""
+from pathlib import Path
+
+import pytest
+
+here = Path(__file__).parent
+debugger2 = here.parent.parent / "debugger2/src/debugger"
+
+
+@pytest.mark.skipif(not debugger2.exists(), reason="debugger2 is not checked out")
+@pytest.mark.parametrize("name", ["stdin_wait.py", "phases.py"])
+def test_copy_is_identical(name):
+    assert (here / name).read_text() == (debugger2 / name).read_text()
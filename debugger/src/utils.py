@@ -2,6 +2,7 @@ import fcntl
 import os
 import select
 import subprocess
+import tempfile
 import time
 from typing import IO
 
@@ -9,6 +10,7 @@ from src.constants import (
     CUSTOM_NEXT_COMMAND_NAME,
     CUSTOM_NEXT_SCRIPT_NAME,
     DEBUG_SESSION_VAR_NAME,
+    STDIN_PIPE_PREFIX,
 )
 
 
@@ -70,18 +72,6 @@ def get_gdb_script(
         # source /app/src/gdb_scripts/DebugSession.py
         # python debug_session = DebugSession("78fdAsD32", "main")
 
-        "default_manual_start": f"""
-        source {abs_file_path}/gdb_scripts/DebugSession.py
-        python {DEBUG_SESSION_VAR_NAME} = DebugSession("{socket_id}", "{program_name}")
-        python {DEBUG_SESSION_VAR_NAME}.type_decl_strs = get_type_decl_strs()
-        python {DEBUG_SESSION_VAR_NAME}.parsed_type_decls = pycparser_parse_type_decls({DEBUG_SESSION_VAR_NAME}.user_socket_id)
-        python {DEBUG_SESSION_VAR_NAME}.parsed_fn_decls = pycparser_parse_fn_decls({DEBUG_SESSION_VAR_NAME}.user_socket_id)
-        python {DEBUG_SESSION_VAR_NAME}.custom_next_command = CustomNextCommand(CUSTOM_NEXT_COMMAND_NAME, {DEBUG_SESSION_VAR_NAME}.user_socket_id, {DEBUG_SESSION_VAR_NAME})
-        python {DEBUG_SESSION_VAR_NAME}.io_manager = IOManager(user_socket_id=python {DEBUG_SESSION_VAR_NAME}.user_socket_id)
-        start
-        call setbuf(stdout, NULL)
-        """,
-
         "default_legacy": f"""
         set python print-stack full
         set pagination off
@@ -193,6 +183,15 @@ def create_abs_file_path(file_name: str):
     return os.path.dirname(os.path.abspath(__file__)) + "/" + file_name
 
 
+def get_stdin_pipe_path(user_socket_id: str) -> str:
+    """
+    Named pipe that the server writes a user's stdin to. The gdb instance relays
+    it to the program, so the input gets through even while gdb is busy running
+    a step that is blocked reading stdin.
+    """
+    return os.path.join(tempfile.gettempdir(), f"{STDIN_PIPE_PREFIX}{user_socket_id}")
+
+
 def create_ll_script(abs_file_path, line_numbers, program_name):
     gdb_script = (
         f"""
@@ -0,0 +1,207 @@
+"""
+End-to-end step latency benchmark for serve.py
+
+Replays `mainDebug` and then `executeNext` events for every sample program,
+exactly like the frontend, and reports per sample:
+    - time to first step (mainDebug sent -> first backend state received)
+    - p50 / p95 / p99 step latency (executeNext sent -> backend state received)
+    - bytes the server sent per step
+    - RSS of the server and its gdb processes
+
+Usage (from debugger2/src):
+    python3 benchmark.py --output baseline.json
+    python3 benchmark.py --baseline baseline.json   # exits 1 on regression
+    python3 benchmark.py --url http://localhost:8000 --pid <server pid>
+
+The server started here runs with TRACE_CACHE=0, since sessions of the same
+program are otherwise replayed from the trace cache after the first one and
+never start gdb. Pass --trace-cache to measure with it. A --url server has to
+be started with TRACE_CACHE=0 for the same reason, or only its first run
+measures the debugger.
+"""
+
+from argparse import ArgumentParser
+from asyncio import create_subprocess_exec
+from asyncio import open_connection
+from asyncio import run
+from asyncio import sleep
+from pathlib import Path
+from time import perf_counter
+import json
+import os
+import socket
+import sys
+
+from headless import HeadlessClient, samples, rss_bytes, percentile
+
+here = Path(__file__).parent
+
+METRICS = (
+    "time_to_first_step",
+    "p50",
+    "p95",
+    "p99",
+    "mean_bytes_per_step",
+    "rss_bytes",
+)
+
+
+async def bench_sample(
+    url: str, code: str, steps: int, step_timeout: float, pid: int | None
+) -> dict:
+    client = await HeadlessClient().connect(url)
+    try:
+        start = perf_counter()
+        await client.emit("mainDebug", code)
+        event = await client.wait_for("mainDebug", "compileError")
+        if event.name == "compileError":
+            return {"error": event.args[0]}
+
+        latencies = list[float]()
+        sizes = list[int]()
+        first_step = None
+        for _ in range(steps):
+            sent_at = perf_counter()
+            sent_bytes = client.bytes_received
+            await client.emit("executeNext")
+            try:
+                event = await client.wait_for(
+                    "sendBackendStateToUser", seconds=step_timeout
+                )
+            except TimeoutError:
+                # The program has finished, serve.py doesn't tell us
+                break
+            first_step = first_step or event.received_at
+            latencies.append(event.received_at - sent_at)
+            sizes.append(event.bytes_received - sent_bytes)
+
+        return {
+            "steps": len(latencies),
+            "time_to_first_step": first_step and first_step - start,
+            "p50": percentile(latencies, 50),
+            "p95": percentile(latencies, 95),
+            "p99": percentile(latencies, 99),
+            "mean_bytes_per_step": sum(sizes) / len(sizes) if sizes else None,
+            "max_bytes_per_step": max(sizes, default=None),
+            "rss_bytes": rss_bytes(pid) if pid else None,
+            "session": client.sid,
+        }
+    finally:
+        await client.close()
+
+
+async def start_server(trace_cache: bool = False) -> tuple[str, any]:
+    with socket.socket() as s:
+        s.bind(("127.0.0.1", 0))
+        port = s.getsockname()[1]
+
+    process = await create_subprocess_exec(
+        sys.executable,
+        "-m",
+        "uvicorn",
+        "serve:app",
+        "--port",
+        str(port),
+        "--log-level",
+        "error",
+        cwd=here,
+        env=os.environ | {"TRACE_CACHE": "1" if trace_cache else "0"},
+    )
+    for _ in range(100):
+        try:
+            _, writer = await open_connection("127.0.0.1", port)
+            writer.close()
+            break
+        except OSError:
+            await sleep(0.1)
+    return f"http://127.0.0.1:{port}", process
+
+
+def compare(baseline: dict, results: dict, tolerance: float) -> bool:
+    """Print the change of each metric, return whether any regressed"""
+
+    regressed = False
+    for name, result in results["samples"].items():
+        before = baseline["samples"].get(name)
+        if before is None or "error" in before or "error" in result:
+            continue
+        for metric in METRICS:
+            old, new = before.get(metric), result.get(metric)
+            if not old or new is None:
+                continue
+            change = (new - old) / old
+            flag = ""
+            if change > tolerance:
+                flag = "  <-- REGRESSION"
+                regressed = True
+            print(f"{name:20} {metric:20} {old:12.4g} -> {new:12.4g} "
+                  f"({change:+.1%}){flag}")
+    return regressed
+
+
+def report(results: dict) -> None:
+    print(f"{'sample':20} {'steps':>5} {'ttfs':>8} {'p50':>8} {'p95':>8} "
+          f"{'p99':>8} {'B/step':>9} {'rss MB':>8}")
+    for name, r in results["samples"].items():
+        if "error" in r:
+            print(f"{name:20} compile error")
+            continue
+
+        def ms(x):
+            return f"{x * 1e3:8.1f}" if x is not None else f"{'-':>8}"
+
+        size = r["mean_bytes_per_step"]
+        rss = r["rss_bytes"]
+        print(
+            f"{name:20} {r['steps']:5} {ms(r['time_to_first_step'])} "
+            f"{ms(r['p50'])} {ms(r['p95'])} {ms(r['p99'])} "
+            f"{size if size is not None else 0:9.0f} "
+            f"{rss / 2**20 if rss else 0:8.1f}"
+        )
+
+
+async def main() -> int:
+    parser = ArgumentParser(description=__doc__.split("\n")[1])
+    parser.add_argument("--url", help="benchmark a running server instead")
+    parser.add_argument("--pid", type=int, help="pid of the --url server")
+    parser.add_argument("--steps", type=int, default=25)
+    parser.add_argument("--step-timeout", type=float, default=5.0)
+    parser.add_argument("--samples", nargs="*", help="default: all")
+    parser.add_argument("--output", type=Path, help="write results as JSON")
+    parser.add_argument("--baseline", type=Path, help="JSON to compare with")
+    parser.add_argument("--tolerance", type=float, default=0.2)
+    parser.add_argument("--trace-cache", action="store_true",
+                        help="replay repeated sessions, see serve.py")
+    args = parser.parse_args()
+
+    server = None
+    url, pid = args.url, args.pid
+    if url is None:
+        url, server = await start_server(args.trace_cache)
+        pid = server.pid
+
+    sources = samples()
+    names = args.samples or list(sources)
+    results = {"url": url, "steps": args.steps, "samples": {}}
+    try:
+        for name in names:
+            results["samples"][name] = await bench_sample(
+                url, sources[name], args.steps, args.step_timeout, pid
+            )
+    finally:
+        if server is not None:
+            server.terminate()
+            await server.wait()
+
+    report(results)
+    if args.output:
+        args.output.write_text(json.dumps(results, indent=2))
+    if args.baseline:
+        baseline = json.loads(args.baseline.read_text())
+        if compare(baseline, results, args.tolerance):
+            return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(run(main()))
@@ -0,0 +1,88 @@
+from bisect import bisect_right
+
+"""
+What a pointer points to, from the mappings of the inferior's address space
+and the blocks live in its heap
+"""
+
+NULL = "null"
+HEAP = "heap"  # a live block, or anywhere in an mmapped one
+DANGLING = "dangling"  # the heap, but not a live block
+STACK = "stack"
+GLOBAL = "global"  # globals, string literals and code of any object file
+INVALID = "invalid"  # not mapped
+
+# Kind of mapping whose addresses are classified by the live blocks
+HEAP_REGION = "heap region"
+
+
+class AddressSpace:
+    """
+    The mappings of /proc/<pid>/maps sorted by address, so classifying a
+    pointer is a binary search into them and then into the live blocks
+
+    >>> space = AddressSpace(
+    ...     "555555554000-555555556000 r-xp 00000000 08:01 42 /tmp/main\\n"
+    ...     "555555556000-555555557000 rw-p 00002000 08:01 42 /tmp/main\\n"
+    ...     "555555557000-555555558000 rw-p 00000000 00:00 0\\n"
+    ...     "555555559000-55555557a000 rw-p 00000000 00:00 0  [heap]\\n"
+    ...     "7ffff7a00000-7ffff7b00000 rw-p 00000000 00:00 0\\n"
+    ...     "7ffff7d80000-7ffff7da8000 r--p 00000000 08:01 7 /lib/libc.so.6\\n"
+    ...     "7ffffffde000-7ffffffff000 rw-p 00000000 00:00 0  [stack]\\n",
+    ...     {0x5555555592A0: 24, 0x5555555592C0: 100},
+    ... )
+    >>> [space.classify(a) for a in (0x5555555592A0, 0x5555555592B7)]
+    ['heap', 'heap']
+    >>> [space.classify(a) for a in (0x5555555592B8, 0x555555559400)]
+    ['dangling', 'dangling']
+    >>> [space.classify(a) for a in (0x555555556010, 0x555555557010)]
+    ['global', 'global']
+    >>> [space.classify(a) for a in (0x7FFFF7A00010, 0x7FFFFFFFE1C4)]
+    ['heap', 'stack']
+    >>> [space.classify(a) for a in (0, 0x10, 0x555555558010)]
+    ['null', 'invalid', 'invalid']
+    """
+
+    def __init__(self, maps: str, blocks: dict[int, int]) -> None:
+        # /proc/<pid>/maps lists the mappings sorted already
+        self.starts = list[int]()
+        self.ends = list[int]()
+        self.kinds = list[str]()
+        for line in maps.splitlines():
+            fields = line.split(maxsplit=5)
+            if len(fields) < 5:
+                continue
+            start, end = (int(a, 16) for a in fields[0].split("-"))
+            path = fields[5].strip() if len(fields) > 5 else ""
+            kind = self._kind(start, path)
+            self.starts.append(start)
+            self.ends.append(end)
+            self.kinds.append(kind)
+
+        self.blocks = blocks
+        self.block_starts = sorted(blocks)
+        self.block_ends = [a + blocks[a] for a in self.block_starts]
+
+    def _kind(self, start: int, path: str) -> str:
+        if path == "[heap]":
+            return HEAP_REGION
+        if path.startswith("[stack"):
+            return STACK
+        if path:
+            return GLOBAL
+        if self.ends and self.ends[-1] == start and self.kinds[-1] == GLOBAL:
+            return GLOBAL  # the .bss after an object file's .data
+        return HEAP  # malloc mmaps blocks too large for the heap
+
+    def classify(self, addr: int) -> str:
+        if addr == 0:
+            return NULL
+        i = bisect_right(self.starts, addr) - 1
+        if i < 0 or addr >= self.ends[i]:
+            return INVALID
+        if self.kinds[i] != HEAP_REGION:
+            return self.kinds[i]
+        j = bisect_right(self.block_starts, addr) - 1
+        if j >= 0 and addr < self.block_ends[j]:
+            return HEAP
+        return DANGLING
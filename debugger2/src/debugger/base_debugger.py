@@ -1,16 +1,21 @@
 from asyncio import create_subprocess_exec
 from asyncio import create_task
-from asyncio import Queue
+from asyncio import gather
+from asyncio import get_running_loop
 from asyncio import to_thread
 from asyncio import Event
+from asyncio import Future
 from asyncio import iscoroutinefunction
 from asyncio.subprocess import PIPE
 from collections import deque
 from contextlib import suppress
+from itertools import count
 from pathlib import Path
+from re import fullmatch
 import os
 
 from . import mion
+from .metrics import metrics, GDB_COMMAND
 
 
 class BaseDebugger:
@@ -38,7 +43,8 @@ class BaseDebugger:
             stdout=PIPE,
         )
 
-        self.result_queue = Queue[tuple[str, dict]]()
+        self.tokens = count(1)
+        self.pending = dict[int, Future[tuple[str, dict]]]()
         self.stream_queue = deque[str](maxlen=0)
         create_task(self._stdout_dispatch())
         create_task(self._inferior_dispatch())
@@ -53,37 +59,61 @@ class BaseDebugger:
         await self.process.stdin.drain()
         await self.process.wait()
 
-        self.result_queue.shutdown()
-        await self.result_queue.join()
+        for future in self.pending.values():
+            future.cancel()
+        self.pending.clear()
 
         os.close(self.fd_master)
         os.close(self.fd_slave)
         await self._inferior_dispatch_done.wait()
 
     async def run_command(self, command: str):
-        self.process.stdin.write(f"{command}\n".encode())
-        await self.process.stdin.drain()
-
-        subkind, result = await self.result_queue.get()
-        self.result_queue.task_done()
-        if subkind == mion.RESULT_ERROR:
-            raise ValueError(result["msg"])
-        assert subkind in mion.RESULT_CLASS
+        (result,) = await self.batch(command)
         return result
 
+    async def batch(self, *commands: str) -> list:
+        """
+        Send all commands to GDB back to back and wait for their results,
+        which are returned in the same order as the commands. GDB still runs
+        them one after the other, so later commands see the effects of
+        earlier ones (e.g. -stack-select-frame).
+
+        Raises the error of the first failing command, after all of them
+        have finished.
+        """
+
+        futures = list[Future[tuple[str, dict]]]()
+        lines = list[str]()
+        for command in commands:
+            token = next(self.tokens)
+            futures.append(get_running_loop().create_future())
+            self.pending[token] = futures[-1]
+            lines.append(f"{token}{command}\n")
+
+        with metrics.span(GDB_COMMAND, commands=commands):
+            # A single write keeps concurrent batches from interleaving
+            self.process.stdin.write("".join(lines).encode())
+            await self.process.stdin.drain()
+            responses = await gather(*futures)
+
+        results = list()
+        error = None
+        for subkind, result in responses:
+            if subkind == mion.RESULT_ERROR:
+                error = error or ValueError(result["msg"])
+            assert subkind in mion.RESULT_CLASS
+            results.append(result)
+        if error is not None:
+            raise error
+        return results
+
     async def console(self, command: str):
         """Experimental"""
 
         self.stream_queue = deque[str](maxlen=None)
-        self.process.stdin.write(
-            f'-interpreter-exec console "{command}"\n'.encode()
+        result = await self.run_command(
+            f'-interpreter-exec console "{command}"'
         )
-
-        subkind, result = await self.result_queue.get()
-        self.result_queue.task_done()
-        if subkind == mion.RESULT_ERROR:
-            raise ValueError(result["msg"])
-        assert subkind in mion.RESULT_CLASS
         assert result == {}
 
         res = "".join(
@@ -109,11 +139,14 @@ class BaseDebugger:
             if line == "(gdb)":
                 continue
 
+            token, line = _split_token(line)
             kind, message = line[:1], line[1:]
             match kind:
                 case mion.RESULT:
                     subkind, message = _split_subkind(message)
-                    await self.result_queue.put((subkind, mion.loads(message)))
+                    future = self.pending.pop(token, None)
+                    if future is not None and not future.done():
+                        future.set_result((subkind, mion.loads(message)))
                 case _ if kind in mion.ASYNC:
                     subkind, message = _split_subkind(message)
                     if iscoroutinefunction(self.oob_handler):
@@ -138,6 +171,19 @@ class BaseDebugger:
         self._inferior_dispatch_done.set()
 
 
+def _split_token(line: str) -> tuple[int | None, str]:
+    """
+    >>> _split_token('12^done')
+    (12, '^done')
+    >>> _split_token('*stopped,reason="exited-normally"')
+    (None, '*stopped,reason="exited-normally"')
+    """
+
+    if match := fullmatch(r"(\d+)(.*)", line):
+        return int(match.group(1)), match.group(2)
+    return None, line
+
+
 def _split_subkind(message: str) -> tuple[str, str]:
     """
     >>> _split_subkind('abc')
@@ -3,7 +3,21 @@ from asyncio.subprocess import PIPE
 from pathlib import Path
 
 
-async def compile(source_path: str | Path, output_path: str | Path) -> None:
+async def compile(
+    source_path: str | Path,
+    output_path: str | Path,
+    debug_name: str | None = None,
+) -> None:
+    """
+    `debug_name` replaces the source path in the debug info, so compiling
+    the same code from different temporary files gives identical binaries
+    """
+
+    remap = []
+    if debug_name is not None:
+        source_path = Path(source_path).absolute()
+        remap = [f"-ffile-prefix-map={source_path}={debug_name}"]
+
     clang = await create_subprocess_exec(
         "gcc",
         str(source_path),
@@ -11,6 +25,7 @@ async def compile(source_path: str | Path, output_path: str | Path) -> None:
         str(output_path),
         "-ggdb",
         "-O0",
+        *remap,
         stdin=PIPE,
         stdout=PIPE,
         stderr=PIPE,
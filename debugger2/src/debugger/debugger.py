@@ -1,13 +1,31 @@
 from __future__ import annotations
-from collections import deque
+from asyncio import create_task
+from asyncio import gather
+from asyncio import iscoroutinefunction
+from asyncio import wait
 from contextlib import suppress
 from dataclasses import dataclass
+from dataclasses import field
+from dataclasses import replace
+from heapq import heappop
+from heapq import heappush
+from itertools import count
 from json import JSONDecodeError
+import os
+from re import fullmatch
+from re import search
+from termios import TCIFLUSH
+from termios import tcflush
+from time import perf_counter
 from typing import TypedDict
 
+from debugger import heap
 from debugger import mion
+from debugger.address_space import AddressSpace, DANGLING, HEAP
 
 from .base_debugger import BaseDebugger
+from .metrics import metrics, MEMORY_READ, PARSE
+from .stdin_wait import waiting_for_input
 
 
 @dataclass(slots=True, frozen=True)
@@ -28,9 +46,92 @@ class Obj:
     type: str
     value: str | Obj
     addr: str | None
+    truncated: bool = False  # has pointers the trace did not follow
+    length: int | None = None  # cells in all, when value is a page of them
+
+
+@dataclass(slots=True)
+class CachedFrame:
+    """A traced frame, reused while the memory it read is unchanged"""
+
+    vars: dict[str, Obj]
+    objects: dict[tuple[str, str], Obj]  # everything reachable from vars
+    structs: dict[str, list[tuple[str, str]]]  # legacy
+    regions: list[tuple[int, int]] = field(default_factory=list)
+    contents: list[str | None] = field(default_factory=list)
+
+
+# Going back a step should take at most about this many seconds of replay
+REPLAY_TARGET = 0.25
+# Each checkpoint is a forked copy of the inferior
+MAX_CHECKPOINTS = 32
+# Only answered once the inferior has stopped after an -exec-* command
+SYNC = "-inferior-tty-show"
+# How often a running step checks whether the inferior is blocked on stdin
+INPUT_POLL = 0.02
+
+# GDB prints at most this many characters of a string
+STRING_BYTES = 200
+# Cells of an array or string sent at once, the client asks for the rest
+PAGE_CELLS = 200
+# Objects and bytes of them a trace follows pointers to, beyond the stack
+MAX_NODES = 1_000
+MAX_BYTES = 256 * 1024
+# Expressions evaluated at once while tracing
+LEVEL_SIZE = 128
+# Bytes of the heap read by one command while scanning it
+HEAP_READ = 1 << 20
+# Scanned heaps kept, by the state of the arena when they were scanned
+HEAP_CACHE = 64
+# How a traced expression was reached from the one it was followed from
+FIELD, INDEX, POINTEE = "field", "index", "pointee"
+
+
+@dataclass(slots=True)
+class Budget:
+    """What one trace may still spend following pointers"""
+
+    nodes: int
+    bytes: int
 
 
 class Debugger(BaseDebugger):
+    def __init__(self) -> None:
+        super().__init__()
+        self.step = 0
+        self.history = list[str]()  # history[i] moves from step i to i + 1
+        self.inputs = list[str]()  # stdin sent for history[i]
+        self.input = ""  # stdin sent since the last step
+        self.checkpoints = dict[int, int]()  # step -> gdb checkpoint number
+        self.live = 0  # gdb fork number of the process being debugged
+        self.step_cost: float | None = None
+        self.restore_cost: float | None = None
+        self.thinning = 1
+        self.pid: int | None = None  # of the live inferior process
+        self.input_handler = lambda: None
+        self.frame_cache = dict[tuple[str, int], CachedFrame]()
+        self.sizes = dict[str, int | None]()  # type -> sizeof
+        # Stack variables and types to trace first, see annotate()
+        self.annotated = set[str](), set[str]()
+        # struct type -> {array field: count field}, see annotate()
+        self.lengths = dict[str, dict[str, str]]()
+        self.expanded = set[tuple[str, str]]()  # (addr, type) to trace past
+        self.max_nodes = MAX_NODES
+        self.max_bytes = MAX_BYTES
+        self.heap_cache = dict[tuple, dict[int, int]]()  # see heap_blocks()
+        self.blocks = dict[int, int]()  # the heap_blocks() of this trace
+        self.space: AddressSpace | None = None  # and its address_space()
+
+    def on_input[F](self, func: F) -> F:
+        """Called when a step blocks until the user sends stdin"""
+        self.input_handler = func
+        return func
+
+    def send_input(self, data: str) -> None:
+        """Write to the inferior's stdin, kept to feed again on replays"""
+        os.write(self.fd_master, data.encode())
+        self.input += data
+
     async def functions(self) -> list[str]:
         """Do not call while the inferior process is running"""
 
@@ -45,8 +146,18 @@ class Debugger(BaseDebugger):
         res = await self.run_command(f"-break-insert {function}")
         return int(res["bkpt"]["number"])
 
+    async def breakpoints(self, functions: list[str]) -> list[int]:
+        res = await self.batch(*(f"-break-insert {f}" for f in functions))
+        return [int(r["bkpt"]["number"]) for r in res]
+
     async def run(self) -> None:
         await self.run_command("-exec-run")
+        self.step = 0
+        self.frame_cache.clear()
+        self.expanded.clear()
+        self.heap_cache.clear()
+        await self._update_pid()
+        await self._checkpoint()
 
     async def frames(self) -> list[Frame]:
         res = await self.run_command("-stack-list-frames")
@@ -56,13 +167,161 @@ class Debugger(BaseDebugger):
         ]
 
     async def next(self) -> None:
-        await self.run_command("-exec-next")
+        await self._step("-exec-next")
 
     async def cont(self) -> None:
-        await self.run_command("-exec-continue")
+        await self._step("-exec-continue")
 
     async def finish(self) -> None:
-        await self.run_command("-exec-finish")
+        await self._step("-exec-finish")
+
+    async def step_back(self) -> None:
+        await self.go_to_step(max(0, self.step - 1))
+
+    async def go_to_step(self, step: int) -> None:
+        """
+        Restore the latest checkpoint at or before `step` (unless the
+        current step is closer) and replay the recorded steps after it.
+
+        The stdin sent for the replayed steps is sent again. Output the
+        program already printed is not taken back.
+        """
+
+        if not 0 <= step <= len(self.history):
+            raise ValueError(f"No step {step}, only 0 to {len(self.history)}")
+
+        start = max((s for s in self.checkpoints if s <= step), default=None)
+        if self.step > step or (start is not None and start > self.step):
+            if start is None:
+                raise ValueError(f"No checkpoint to go back to step {step}")
+            await self._restore(start)
+
+        if commands := self.history[self.step : step]:
+            # The input of the replayed steps goes ahead of any sent for
+            # the step after the last one, which no step has read yet
+            tcflush(self.fd_slave, TCIFLUSH)
+            replayed = "".join(self.inputs[self.step : step]) + self.input
+            if replayed:
+                os.write(self.fd_master, replayed.encode())
+            begin = perf_counter()
+            await self._until_stopped(*commands, SYNC)
+            self.step_cost = _average(
+                self.step_cost, (perf_counter() - begin) / len(commands)
+            )
+            self.step = step
+
+    async def rewind(self, step: int) -> None:
+        """
+        go_to_step() to carry on from an earlier step, dropping the stdin
+        sent since the last step, which was meant for the step left behind
+        """
+
+        self.input = ""
+        tcflush(self.fd_slave, TCIFLUSH)
+        await self.go_to_step(step)
+
+    async def _step(self, command: str) -> None:
+        if self.step < len(self.history):
+            # Leaving the recorded steps, the program may now do something
+            # else (e.g. read different input) so drop what was recorded
+            del self.history[self.step :]
+            del self.inputs[self.step :]
+            await self._delete_checkpoints(
+                [s for s in self.checkpoints if s > self.step]
+            )
+
+        begin = perf_counter()
+        await self._until_stopped(command, SYNC)
+        self.step_cost = _average(self.step_cost, perf_counter() - begin)
+        self.history.append(command)
+        self.inputs.append(self.input)
+        self.input = ""
+        self.step += 1
+
+        last = max(self.checkpoints, default=None)
+        if last is None or self.step - last >= self._spacing():
+            await self._checkpoint()
+
+    async def _until_stopped(self, *commands: str) -> list:
+        """
+        Run commands that resume the inferior, calling the input handler if
+        it blocks reading stdin. The batch only returns once the inferior
+        has stopped again, which may need the user to send input first.
+        """
+
+        task = create_task(self.batch(*commands))
+        waiting = False
+        while self.pid is not None:
+            done, _ = await wait([task], timeout=INPUT_POLL)
+            if done:
+                break
+            blocked = waiting_for_input(self.pid)
+            if blocked and not waiting:
+                if iscoroutinefunction(self.input_handler):
+                    await self.input_handler()
+                else:
+                    self.input_handler()
+            waiting = blocked
+        return await task
+
+    async def _update_pid(self) -> None:
+        res = await self.run_command("-list-thread-groups")
+        self.pid = next(
+            (int(g["pid"]) for g in res.get("groups", []) if "pid" in g),
+            None,
+        )
+
+    def _spacing(self) -> int:
+        """Steps between checkpoints that keep replays within the target"""
+
+        if self.step_cost is None:
+            return self.thinning
+        budget = REPLAY_TARGET - (self.restore_cost or 0)
+        return max(self.thinning, int(budget / self.step_cost))
+
+    async def _checkpoint(self) -> None:
+        try:
+            output = await self.console("checkpoint")
+        except ValueError:
+            # e.g. the program has exited
+            return
+        if match := search(r"checkpoint (\d+):", output):
+            self.checkpoints[self.step] = int(match.group(1))
+
+        if len(self.checkpoints) > MAX_CHECKPOINTS:
+            # Keep covering the whole run with half as many checkpoints
+            self.thinning *= 2
+            await self._delete_checkpoints(sorted(self.checkpoints)[1::2])
+
+    async def _restore(self, step: int) -> None:
+        begin = perf_counter()
+        number = self.checkpoints.pop(step)
+        await self.console(f"restart {number}")
+        # The checkpoint is now the live process, so the process we left
+        # is of no more use and the checkpoint needs to be taken again
+        with suppress(ValueError):
+            await self.console(f"delete checkpoint {self.live}")
+        self.live = number
+        self.step = step
+        await self._update_pid()
+        await self._checkpoint()
+        self.restore_cost = _average(
+            self.restore_cost, perf_counter() - begin
+        )
+
+    async def _delete_checkpoints(self, steps: list[int]) -> None:
+        if not steps:
+            return
+        with suppress(ValueError):
+            await self.batch(
+                *(
+                    f'-interpreter-exec console "delete checkpoint '
+                    f'{self.checkpoints[step]}"'
+                    for step in steps
+                )
+            )
+        for step in steps:
+            del self.checkpoints[step]
 
     async def variables(self, frame: int = 0) -> dict[str, str]:
         res = await self.run_command(
@@ -73,84 +332,309 @@ class Debugger(BaseDebugger):
     async def var_details(
         self, var: str, frame: int = 0
     ) -> tuple[str, str | dict, str, list[tuple[str, str]]]:
-        await self.run_command(f"-stack-select-frame {frame}")
-
-        await self.run_command(f"-var-create VARIABLE * {var}")
-        res = await self.run_command(f"-var-info-type VARIABLE")
-        type = res["type"]
+        # GDB runs these in order and none of them needs the result of an
+        # earlier one, so they are sent in one go. Each variable object gets
+        # a unique name so several var_details() calls can be in flight.
+        name = f"VARIABLE{next(self.tokens)}"
+        _, _, info, children, _, value, address, _ = await self.batch(
+            f"-stack-select-frame {frame}",
+            f"-var-create {name} * {_quote(var)}",
+            f"-var-info-type {name}",
+            f"-var-list-children {name} 0 {PAGE_CELLS}",
+            f"-var-delete {name}",
+            f"-data-evaluate-expression {_quote(var)}",
+            f"-data-evaluate-expression {_quote(f'&{var}')}",
+            f"-stack-select-frame 0",
+        )
+        type = info["type"]
+        if children.get("has_more") == "1" and _array(type) is None:
+            # Arrays are listed a page at a time, anything else in full
+            _, _, children, _, _ = await self.batch(
+                f"-stack-select-frame {frame}",
+                f"-var-create {name} * {_quote(var)}",
+                f"-var-list-children {name}",
+                f"-var-delete {name}",
+                f"-stack-select-frame 0",
+            )
 
-        res = await self.run_command("-var-list-children VARIABLE")
         childs = (
-            [(c["exp"], c["type"]) for c in res["children"]]
-            if res["numchild"] != "0"
+            [(c["exp"], c["type"]) for c in children["children"]]
+            if children["numchild"] != "0"
             else []
         )
-        await self.run_command("-var-delete VARIABLE")
 
-        res = await self.run_command(f"-data-evaluate-expression {var}")
-        value = res["value"]
-        with suppress(JSONDecodeError):
-            value = mion.valueloads(res["value"])
+        value = value["value"]
+        with suppress(JSONDecodeError), metrics.span(PARSE, var=var):
+            value = mion.valueloads(value)
 
-        res = await self.run_command(f"-data-evaluate-expression &{var}")
-        address = res["value"].split(" ", 1)[0]
+        address = address["value"].split(" ", 1)[0]
 
-        await self.run_command(f"-stack-select-frame 0")
         return (type, value, address, childs)
 
+    async def paged_details(
+        self, var: str, frame: int = 0
+    ) -> tuple[str, str | dict | list, str, list, int | None]:
+        """
+        var_details() with an array's value cut to its first page of cells,
+        and the number of cells of an array or of a string GDB cut short
+        """
+
+        type, value, address, childs = await self.var_details(var, frame)
+        length = None
+        if (array := _array(type)) is not None:
+            element, length = array
+            cells = _cells(value) if isinstance(value, str) else None
+            if cells is None or len(cells) != length:
+                # GDB stops printing after STRING_BYTES cells, and prints a
+                # char[] as a string; an unreadable array has no cells
+                count = min(length, PAGE_CELLS)
+                with suppress(ValueError):
+                    cells = await self.read_range(address, element, 0, count)
+            value = (cells or [])[:PAGE_CELLS]
+        elif (
+            type.endswith("char *")
+            and isinstance(value, str)
+            and value.endswith("...")
+        ):
+            strlen = f"$_strlen((char *) {_address(value):#x})"
+            with suppress(ValueError):
+                res = await self.run_command(
+                    f"-data-evaluate-expression {_quote(strlen)}"
+                )
+                length = int(res["value"])
+        return type, value, address, childs, length
+
+    async def read_range(
+        self, addr: str, element: str, start: int, count: int
+    ) -> list:
+        """
+        Cells [start, start + count) of the array of `element` at addr, at
+        most a page of them
+        """
+
+        count = max(0, min(count, PAGE_CELLS))
+        if count == 0:
+            return []
+        cells = f"(({_pointer(element)}) {addr})"
+        if element.endswith("char"):
+            # GDB prints chars as a string, with escapes and repeats
+            res = await self.run_command(
+                f"-data-read-memory-bytes {_quote(f'&{cells}[{start}]')}"
+                f" {count}"
+            )
+            contents = "".join(m["contents"] for m in res.get("memory", []))
+            return [chr(byte) for byte in bytes.fromhex(contents)]
+
+        res = await self.run_command(
+            f"-data-evaluate-expression {_quote(f'{cells}[{start}]@{count}')}"
+        )
+        with metrics.span(PARSE, var=cells):
+            return _cells(res["value"]) or []
+
     async def trace(self):
-        def follow(var: str, type: str, children: list[tuple[str, str]]):
-            queue = list[str]()
+        with metrics.span(MEMORY_READ):
+            return await self._trace()
+
+    async def _trace(self):
+        maps = self._maps()
+        self.blocks = await self.heap_blocks(maps) if maps else {}
+        self.space = AddressSpace(maps, self.blocks) if maps else None
+        frames = await self.frames()
+        keys = await self._frame_keys(frames)
+        # The active frame is always traced again: which of its locals are
+        # in scope changes with the pc, which its key and memory miss
+        unchanged = await self._unchanged_frames(
+            [*keys[1:], *map(_expansion_key, self.expanded)]
+        )
+        self.frame_cache = {
+            key: cached
+            for key, cached in self.frame_cache.items()
+            if key in unchanged
+        }
+
+        # Frames that did not change since the last step, usually every
+        # caller of the active frame, are served from the cache. The budget
+        # is shared, the active frame goes first so it gets the most.
+        budget = Budget(self.max_nodes, self.max_bytes)
+        traced = dict[tuple[str, int], CachedFrame]()
+        for i, key in enumerate(keys):
+            if key not in self.frame_cache and key not in traced:
+                traced[key] = await self._trace_frame(i, budget)
+
+        full_frames = list[FullFrame]()
+        addresses: dict[tuple[str, str], Obj] = {}
+        structs: dict[str, list[tuple[str, str]]] = {}  # legacy
+        for frame, key in zip(frames, keys):
+            cached = self.frame_cache.get(key) or traced[key]
+            full_frames.append(FullFrame(frame, cached.vars))
+            _merge_objects(addresses, cached.objects)
+            structs.update(cached.structs)
+
+        # Subtrees the user expanded, while they are still reachable
+        for addr, type in self.expanded:
+            if (addr, type) not in addresses:
+                continue
+            key = _expansion_key((addr, type))
+            if key not in self.frame_cache and key not in traced:
+                root = f"(*({type} *) {addr})"
+                budget = Budget(self.max_nodes, self.max_bytes)
+                traced[key] = await self._trace_from(
+                    0, [root], budget, stack=False
+                )
+            cached = self.frame_cache.get(key) or traced[key]
+            _merge_objects(addresses, cached.objects)
+            structs.update(cached.structs)
+
+        await self._snapshot(traced)
+        self.frame_cache.update(traced)
+        return full_frames, addresses, structs
+
+    def annotate(
+        self,
+        variables: list[str],
+        types: list[str],
+        lengths: dict[str, dict[str, str]] | None = None,
+    ) -> None:
+        """
+        Trace from these stack variables and types first. `lengths` names
+        the field counting the cells of a struct's malloced array field,
+        like a graph's vertex count for its adjacency lists.
+        """
+
+        self.annotated = set(variables), set(types)
+        self.lengths = lengths or {}
+        # Traced frames may have spent their budget on other objects
+        self.frame_cache.clear()
+
+    def expand(self, addr: str, type: str) -> None:
+        """Follow a truncated object's pointers, with a budget of its own"""
+
+        self.expanded.add((addr, type))
+
+    async def _trace_frame(self, i: int, budget: Budget) -> CachedFrame:
+        names = list(await self.variables(i))
+        return await self._trace_from(i, names, budget, stack=True)
+
+    async def _trace_from(
+        self, i: int, roots: list[str], budget: Budget, stack: bool
+    ) -> CachedFrame:
+        """
+        Evaluate the roots (the variables of frame i if `stack`) and follow
+        pointers from them, annotated roots and types first, until the
+        budget runs out. Objects with pointers left unfollowed are marked
+        truncated so the client can ask to expand them.
+        """
+
+        # Pointer expression -> the cells its array has, from a count field
+        bounds = dict[str, int]()
+
+        def follow(
+            var: str, type: str, value, children: list[tuple[str, str]]
+        ):
+            queue = list[tuple[str, str, str]]()  # expression, type, kind
+            counts = self.lengths.get(type, {})
             for subname, subtype in children:
                 if subtype == "char":
                     # Avoid insepcting each char in each string
                     continue
                 if subname.startswith("*"):
                     # It is a pointer
-                    queue.append(subname)
+                    if var in bounds:
+                        bounds[subname] = bounds[var]
+                    queue.append((subname, subtype, POINTEE))
                 elif subname.isdigit():
                     # It is an array index
-                    queue.append(f"{var}[{subname}]")
+                    queue.append((f"{var}[{subname}]", subtype, INDEX))
                 elif type.endswith("*"):
                     # It is a struct pointer
-                    queue.append(f"(*{var})")
+                    queue.append((f"(*{var})", subtype, POINTEE))
                 else:
                     # It is a struct field
-                    queue.append(f"({var}.{subname})")
+                    expr = f"({var}.{subname})"
+                    if subname in counts and isinstance(value, dict):
+                        with suppress(KeyError, TypeError, ValueError):
+                            bounds[expr] = int(value[counts[subname]])
+                    queue.append((expr, subtype, FIELD))
             return queue
 
-        frames = list[FullFrame]()
+        variables, types = self.annotated
+        order = count()
+        # (priority, depth, order, expression, owner, kind), where owner is
+        # the object to mark truncated if the expression is not evaluated
+        heap = list[tuple[int, int, int, str, tuple[str, str], str]]()
+
+        def push(var, type, value, childs, priority, depth, owner) -> None:
+            for expr, subtype, kind in follow(var, type, value, childs):
+                urgent = subtype.rstrip(" *") in types
+                item = (0 if urgent else priority, depth, next(order))
+                heappush(heap, (*item, expr, owner, kind))
+
+        # Only what these roots reach, even if another frame reaches it
+        # too, so the frame can be cached on its own
         addresses: dict[tuple[str, str], Obj] = {}
         structs: dict[str, list[tuple[str, str]]] = {}  # legacy
 
-        for i, frame in enumerate(await self.frames()):
-            queue = deque()
+        vars = dict[str, Obj]()
+        details = await gather(
+            *(self.paged_details(v, i) for v in roots), return_exceptions=True
+        )
+        for var, detail in zip(roots, details):
+            if isinstance(detail, ValueError):
+                continue
+            if isinstance(detail, BaseException):
+                raise detail
+            type, value, addr, childs, length = detail
+            if stack:
+                vars[var] = Obj(type, value, addr, length=length)
+            addresses[addr, type] = Obj(type, value, addr, length=length)
+            if childs and not type.endswith("*") and _array(type) is None:
+                structs[type] = childs
+            if value != "0x0" and type != "void *":
+                priority = 0 if var in variables or not stack else 1
+                push(var, type, value, childs, priority, 1, (addr, type))
 
-            vars = dict[str, Obj]()
-            for var in await self.variables(i):
-                type, value, addr, childs = await self.var_details(var, i)
-                vars[var] = Obj(type, value, addr)
-                addresses[addr, type] = Obj(type, value, addr)
-                if childs and not type.endswith("*"):
-                    structs[type] = childs
-                if value != "0x0" and type != "void *":
-                    queue.extend(follow(var, type, childs))
-            frames.append(FullFrame(frame, vars))
-
-            while queue:
-                var = queue.popleft()
-                try:
-                    type, value, addr, childs = await self.var_details(var, i)
-                except ValueError:
+        while heap and budget.nodes > 0 and budget.bytes > 0:
+            # Evaluate the most important expressions at once and then
+            # process the results in order, annotated ones before the rest
+            level = list[tuple]()
+            while (
+                heap
+                and heap[0][0] == (level[0][0] if level else heap[0][0])
+                and len(level) < min(budget.nodes, LEVEL_SIZE)
+            ):
+                level.append(heappop(heap))
+            details = await gather(
+                *(self.paged_details(item[3], i) for item in level),
+                return_exceptions=True,
+            )
+            await self._sizes(
+                d[0] for d in details if not isinstance(d, BaseException)
+            )
+            for item, detail in zip(level, details):
+                priority, depth, _, var, owner, kind = item
+                if isinstance(detail, ValueError):
+                    continue
+                if isinstance(detail, BaseException):
+                    raise detail
+                type, value, addr, childs, length = detail
+                cells = (
+                    self._heap_cells(addr, type, bounds.get(var))
+                    if kind == POINTEE
+                    else 1
+                )
+                if cells > 1:
+                    # The pointer is to the first cell of a malloced array,
+                    # which is traced as the whole array instead
+                    array = f"(*({_pointer(f'{type} [{cells}]')}) {addr})"
+                    item = (priority, depth, next(order), array, owner, INDEX)
+                    heappush(heap, item)
                     continue
                 if (addr, type) in addresses:
                     continue
-                addresses[addr, type] = Obj(type, value, addr)
-                if (
-                    childs
-                    and not type.endswith("*")
-                    and not type.endswith("[]")
-                ):
+                budget.nodes -= 1
+                budget.bytes -= self.sizes.get(type) or 0
+                addresses[addr, type] = Obj(type, value, addr, length=length)
+                if childs and not type.endswith("*") and _array(type) is None:
                     try:
                         structs[type] = childs
                         addresses[addr, type] = Obj(
@@ -167,13 +651,257 @@ class Debugger(BaseDebugger):
                             value,
                         )
                 if value != "0x0" and type != "void *":
-                    queue.extend(follow(var, type, childs))
+                    # A field's pointers are unfollowed pointers of its struct
+                    owner = owner if kind == FIELD else (addr, type)
+                    push(var, type, value, childs, priority, depth + 1, owner)
+
+        for *_, owner, _ in heap:
+            if owner in addresses:
+                addresses[owner] = replace(addresses[owner], truncated=True)
+            for name, obj in vars.items():
+                if (obj.addr, obj.type) == owner:
+                    vars[name] = replace(obj, truncated=True)
 
-        return frames, addresses, structs
+        return CachedFrame(vars, addresses, structs)
+
+    def _heap_cells(
+        self, addr: str, type: str, bound: int | None = None
+    ) -> int:
+        """
+        How many objects of type the heap block starting at addr was
+        malloced for, so a pointer to the first of a malloced array leads to
+        all of them. A count field's `bound` is taken if the block holds
+        that many, else only the cells the block's size proves were asked
+        for.
+        """
+
+        usable = self.blocks.get(_address(addr) or 0)
+        size = self.sizes.get(type)
+        if usable is None or size is None or _array(type) or type == "char":
+            return 1
+        if bound is not None and 0 < bound * size <= usable:
+            return bound
+        return heap.array_cells(usable, size)
+
+    async def _frame_keys(self, frames: list[Frame]) -> list[tuple[str, int]]:
+        """
+        Identify frames by function and stack pointer. A caller's stack
+        pointer stays put while it waits for its callees, like its CFA, and
+        no two live frames share one, so recursive calls are told apart.
+        """
+
+        commands = list[str]()
+        for i in range(len(frames)):
+            commands.append(f"-stack-select-frame {i}")
+            commands.append("-data-evaluate-expression (unsigned long)$sp")
+        res = await self.batch(*commands, "-stack-select-frame 0")
+        return [
+            (frame.func, int(r["value"]))
+            for frame, r in zip(frames, res[1:-1:2])
+        ]
+
+    async def _unchanged_frames(self, keys: list) -> set[tuple[str, int]]:
+        """
+        Cached frames whose stack slots and reachable memory are as they
+        were when the frame was traced
+        """
+
+        candidates = [key for key in keys if key in self.frame_cache]
+        regions = sorted(
+            {r for key in candidates for r in self.frame_cache[key].regions}
+        )
+        memory = dict(zip(regions, await self._read_regions(regions)))
+        return {
+            key
+            for key in candidates
+            if None not in self.frame_cache[key].contents
+            and self.frame_cache[key].contents
+            == [memory[r] for r in self.frame_cache[key].regions]
+        }
+
+    async def _snapshot(self, frames: dict[tuple[str, int], CachedFrame]):
+        """Record the memory each newly traced frame depends on"""
+
+        objects = [
+            obj
+            for frame in frames.values()
+            for obj in (*frame.vars.values(), *frame.objects.values())
+        ]
+        await self._sizes(obj.type for obj in objects)
+
+        for frame in frames.values():
+            regions = list[tuple[int, int]]()
+            for obj in (*frame.vars.values(), *frame.objects.values()):
+                addr = _address(obj.addr)
+                size = self.sizes[obj.type]
+                if obj.length and size is not None and _array(obj.type):
+                    # Only the first page of an array is part of its value
+                    size = min(size, size // obj.length * PAGE_CELLS)
+                regions.append((addr, size))
+                if obj.type.endswith("char *") and _address(obj.value) != 0:
+                    # The string it points to is part of its value
+                    regions.append((_address(obj.value), STRING_BYTES))
+            if any(a is None or n is None for a, n in regions):
+                frame.regions = []
+                frame.contents = [None]  # never considered unchanged
+            else:
+                frame.regions = _merge(regions)
+
+        regions = sorted({r for f in frames.values() for r in f.regions})
+        memory = dict(zip(regions, await self._read_regions(regions)))
+        for frame in frames.values():
+            if frame.regions:
+                frame.contents = [memory[r] for r in frame.regions]
+
+    async def _sizes(self, types) -> None:
+        """Look up the size of types not seen before, None if unknown"""
+
+        types = set(types) - self.sizes.keys()
+        sizes = await gather(
+            *(
+                self.run_command(
+                    f"-data-evaluate-expression {_quote(f'sizeof({type})')}"
+                )
+                for type in types
+            ),
+            return_exceptions=True,
+        )
+        for type, size in zip(types, sizes):
+            if isinstance(size, BaseException):
+                self.sizes[type] = None
+            else:
+                self.sizes[type] = int(size["value"])
+
+    async def _read_regions(self, regions: list[tuple[int, int]]) -> list:
+        """Hex contents of each (address, size), None if unreadable"""
+
+        results = await gather(
+            *(
+                self.run_command(f"-data-read-memory-bytes {addr} {size}")
+                for addr, size in regions
+            ),
+            return_exceptions=True,
+        )
+        contents = list[str | None]()
+        for result in results:
+            if isinstance(result, ValueError):
+                contents.append(None)
+            elif isinstance(result, BaseException):
+                raise result
+            else:
+                contents.append(
+                    "".join(m["contents"] for m in result.get("memory", []))
+                )
+        return contents
+
+    def _maps(self) -> str | None:
+        """The inferior's /proc/<pid>/maps, None if it is not running"""
+
+        if self.pid is None:
+            return None
+        try:
+            with open(f"/proc/{self.pid}/maps") as file:
+                return file.read()
+        except OSError:
+            return None
+
+    async def address_space(self) -> AddressSpace | None:
+        """The inferior's mappings and live heap blocks, as they are now"""
+
+        if (maps := self._maps()) is None:
+            return None
+        return AddressSpace(maps, await self.heap_blocks(maps))
+
+    async def heap_blocks(self, maps: str | None = None) -> dict[int, int]:
+        """
+        Every block allocated in the main arena, library ones included, as
+        the address malloc returned -> usable size. Found in one scan of
+        the heap's chunk headers, which is reused for as long as the arena's
+        top chunk and free lists are unchanged, even across steps.
+        """
+
+        if maps is None and (maps := self._maps()) is None:
+            return {}
+        region = heap.heap_region(maps)
+        if region is None:
+            return {}  # nothing malloced yet
+        start, end = region
+
+        # Without glibc's debug symbols (libc6-dbg, see Dockerfile.prod)
+        # there is no main_arena, so nothing to tell whether the heap
+        # changed and no fast bins to leave out
+        key, top, fastbins = None, None, list[int]()
+        with suppress(ValueError):
+            top, bins, arena, size = await self.batch(
+                "-data-evaluate-expression main_arena.top",
+                "-data-evaluate-expression main_arena.fastbinsY",
+                '-data-evaluate-expression "(unsigned long) &main_arena"',
+                '-data-evaluate-expression "sizeof(main_arena)"',
+            )
+            top = _address(top["value"])
+            fastbins = [_address(b) or 0 for b in _cells(bins["value"]) or []]
+            # The arena's bins and the tcache's counts and entries change
+            # with every malloc and free
+            key = (
+                start,
+                end,
+                *await self._read_regions(
+                    [
+                        (int(arena["value"]), int(size["value"])),
+                        (start, max(heap.TCACHE_CHUNKS)),
+                    ]
+                ),
+            )
+            if None in key:
+                key = None
+        if key in self.heap_cache:
+            return self.heap_cache[key]
+
+        regions = [
+            (addr, min(HEAP_READ, end - addr))
+            for addr in range(start, end, HEAP_READ)
+        ]
+        contents = await self._read_regions(regions)
+        if None in contents:
+            return {}
+        memory = bytes.fromhex("".join(contents))
+        free = heap.fastbin_free(memory, start, fastbins)
+        blocks = heap.live_blocks(memory, start, free, top)
+
+        if key is not None:
+            self.heap_cache[key] = blocks
+            if len(self.heap_cache) > HEAP_CACHE:
+                del self.heap_cache[next(iter(self.heap_cache))]
+        return blocks
 
     async def legacy_trace(self):
         frame = (await self.frames())[0]
         frames, memory, types = await self.trace()
+        space = self.space  # the heap is scanned once a step
+
+        def on_heap(obj: Obj) -> bool:
+            if space is None:
+                return not obj.addr.startswith("0xffff")
+            return space.classify(_address(obj.addr) or 0) in (HEAP, DANGLING)
+
+        heap_objects = [
+            o
+            for o in reversed(memory.values())
+            if "*" not in o.type
+            and "struct" in o.type
+            and not _array(o.type)
+            and on_heap(o)
+        ]
+        # Malloced arrays, which the tracer finds from heap block sizes, as
+        # the client cannot reach them through the structs alone
+        heap_arrays = [
+            o
+            for o in reversed(memory.values())
+            if space is not None
+            and _array(o.type)
+            and _address(o.addr) in space.blocks
+        ]
+        pointers = _pointers([*frames[0].vars.values(), *heap_objects])
 
         legacy_types = [
             {
@@ -192,16 +920,189 @@ class Debugger(BaseDebugger):
                 "line_num": frame.line,
             },
             "stack_data": {
-                name: {"addr": o.addr, "typeName": o.type, "value": o.value}
-                for name, o in frames[0].vars.items()
-            },
-            "heap_data": {
-                addr: {"addr": addr, "typeName": o.type, "value": o.value}
-                for (addr, _), o in reversed(memory.items())
-                if "*" not in o.type
-                and "struct" in o.type
-                and not o.addr.startswith("0xffff")
+                name: _legacy_value(o) for name, o in frames[0].vars.items()
             },
+            "heap_data": {o.addr: _legacy_value(o) for o in heap_objects},
         }
+        for o in heap_arrays:
+            # A struct at the start of the block takes its address
+            legacy_mem["heap_data"].setdefault(o.addr, _legacy_value(o))
+        if space is not None:
+            # Including blocks nothing on the stack leads to any more
+            legacy_mem["heap_blocks"] = {
+                f"{addr:#x}": n for addr, n in space.blocks.items()
+            }
+            # What each pointer in the state points to, see address_space
+            legacy_mem["pointers"] = {
+                f"{addr:#x}": space.classify(addr) for addr in pointers
+            }
 
         return legacy_types, legacy_mem
+
+
+def _legacy_value(obj: Obj) -> dict:
+    """
+    >>> _legacy_value(Obj("int *", "0x10", "0x20", truncated=True))
+    {'addr': '0x20', 'typeName': 'int *', 'value': '0x10', 'truncated': True}
+    >>> array = _legacy_value(Obj("int [9]", [1, 2], "0x20", length=9))
+    >>> array["value"], array["length"], array["elementType"]
+    ([1, 2], 9, 'int')
+    >>> string = _legacy_value(Obj("char *", '0x30 "ab"...', "0x20", length=9))
+    >>> string["value"], string["length"], string["elementType"]
+    ('0x30 "ab"...', 9, 'char')
+    """
+
+    value = {"addr": obj.addr, "typeName": obj.type, "value": obj.value}
+    if obj.truncated:
+        # The client can send expandObject to see past it
+        value["truncated"] = True
+    if obj.length is not None:
+        # The client can send readRange for the cells past the first page
+        array = _array(obj.type)
+        value["length"] = obj.length
+        value["elementType"] = array[0] if array else obj.type[:-1].rstrip()
+    return value
+
+
+def _pointers(objects: list[Obj]) -> set[int]:
+    """
+    The addresses pointers among objects and their fields point to
+
+    >>> field = Obj("struct node *", "0x30", None)
+    >>> node = Obj("struct node", {"next": field}, "0x20")
+    >>> sorted(_pointers([Obj("char *", '0x10 "hi"', "0x8"), node]))
+    [16, 48]
+    """
+
+    addresses = set[int]()
+    for obj in objects:
+        addr = _address(obj.value) if obj.type.endswith("*") else None
+        if addr is not None:
+            addresses.add(addr)
+        elif isinstance(obj.value, dict):
+            addresses |= _pointers(
+                [v for v in obj.value.values() if isinstance(v, Obj)]
+            )
+    return addresses
+
+
+def _average(average: float | None, sample: float) -> float:
+    """
+    Exponential moving average
+
+    >>> _average(None, 1.0)
+    1.0
+    >>> _average(1.0, 2.0)
+    1.2
+    """
+
+    return sample if average is None else average + 0.2 * (sample - average)
+
+
+def _address(value) -> int | None:
+    """
+    >>> _address("0x7ffe10"), _address("(int *) 0x7ffe10"), _address(None)
+    (8388112, 8388112, None)
+    >>> _address('0x5555a0 "hello"'), _address(3)
+    (5592480, None)
+    """
+
+    if isinstance(value, str) and (match := search(r"0x[0-9a-fA-F]+", value)):
+        return int(match.group(), 16)
+    return None
+
+
+def _merge(regions: list[tuple[int, int]]) -> list[tuple[int, int]]:
+    """
+    Merge overlapping and touching (address, size) regions
+
+    >>> _merge([(16, 4), (0, 8), (20, 4), (4, 2), (40, 8)])
+    [(0, 8), (16, 8), (40, 8)]
+    """
+
+    merged = list[tuple[int, int]]()
+    for addr, size in sorted(regions):
+        if merged and addr <= merged[-1][0] + merged[-1][1]:
+            start, length = merged[-1]
+            merged[-1] = (start, max(length, addr + size - start))
+        else:
+            merged.append((addr, size))
+    return merged
+
+
+def _array(type: str) -> tuple[str, int] | None:
+    """
+    The element type and length of an array type
+
+    >>> _array("int [1000000]"), _array("int *"), _array("char [0]")
+    (('int', 1000000), None, ('char', 0))
+    >>> _array("int [3][4]"), _array("struct node *[8]")
+    (('int [4]', 3), ('struct node *', 8))
+    """
+
+    match = fullmatch(r"(.*?) ?\[(\d+)\](.*)", type)
+    if match is None:
+        return None
+    base, length, rest = match.groups()
+    if rest:
+        base = f"{base}{'' if base.endswith('*') else ' '}{rest}"
+    return base, int(length)
+
+
+def _cells(value: str) -> list | None:
+    """
+    The cells of an array as GDB prints it, None if it is cut short
+
+    >>> _cells("{1, 7 <repeats 2 times>}"), _cells("{0x0, 0x10}")
+    ([1, 7, 7], ['0x0', '0x10'])
+    >>> _cells("{{v = 1}, {v = 2}}"), _cells("{0, 1, 2...}")
+    ([{'v': 1}, {'v': 2}], None)
+    """
+
+    if not value.startswith("{") or not value.endswith("}"):
+        return None
+    with suppress(JSONDecodeError):
+        # As a field, so the array is parsed like one inside a struct
+        return mion.valueloads(f"{{cells = [{value[1:-1]}]}}")["cells"]
+    return None
+
+
+def _pointer(type: str) -> str:
+    """
+    A pointer to type, which for arrays goes before their brackets
+
+    >>> _pointer("int"), _pointer("struct node *"), _pointer("int [4]")
+    ('int *', 'struct node **', 'int (*)[4]')
+    """
+
+    if "[" in type:
+        base, rest = type.split("[", 1)
+        return f"{base.rstrip()} (*)[{rest}"
+    return f"{type} *" if not type.endswith("*") else f"{type}*"
+
+
+def _quote(expression: str) -> str:
+    """
+    MI arguments are split at spaces unless quoted
+
+    >>> _quote("(*head).next"), _quote("(*(struct node *) 0x10)")
+    ('(*head).next', '"(*(struct node *) 0x10)"')
+    """
+
+    if " " not in expression:
+        return expression
+    escaped = expression.replace("\\", "\\\\").replace('"', '\\"')
+    return f'"{escaped}"'
+
+
+def _expansion_key(object: tuple[str, str]) -> tuple[str, int]:
+    addr, type = object
+    return f"*({type} *)", _address(addr)
+
+
+def _merge_objects(addresses: dict, objects: dict) -> None:
+    """Add objects, preferring ones that were not truncated"""
+
+    for key, obj in objects.items():
+        if key not in addresses or addresses[key].truncated:
+            addresses[key] = obj
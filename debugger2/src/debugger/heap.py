@@ -0,0 +1,202 @@
+from struct import unpack_from
+
+"""
+Live blocks of glibc's main arena, found by walking its chunk headers in
+one pass instead of following pointers to them or watching malloc calls
+"""
+
+SIZE_SZ = 8  # glibc on 64 bit targets
+CHUNK_HEADER = 2 * SIZE_SZ  # prev_size and size, before the user's memory
+MIN_CHUNK = 4 * SIZE_SZ
+PREV_INUSE = 0x1
+SIZE_BITS = 0x7  # PREV_INUSE, IS_MMAPPED and NON_MAIN_ARENA
+
+# The tcache_perthread_struct is the first chunk of the heap, its size
+# tells the layout: 64 uint16_t counts since glibc 2.30, chars before
+TCACHE_BINS = 64
+TCACHE_CHUNKS = {0x290: 2, 0x250: 1}  # chunk size -> bytes per count
+# Safe-linking (glibc 2.32) stores next pointers xored with their address
+SAFE_LINKING_SHIFT = 12
+
+
+def heap_region(maps: str) -> tuple[int, int] | None:
+    """
+    The [heap] mapping of a /proc/<pid>/maps, where the main arena grows
+
+    >>> heap_region(
+    ...     "555555554000-555555555000 r--p 00000000 08:01 42 /tmp/a\\n"
+    ...     "555555559000-55555557a000 rw-p 00000000 00:00 0  [heap]\\n"
+    ... )
+    (93824992251904, 93824992387072)
+    >>> heap_region("7ffff7d80000-7ffff7da8000 r--p 00000000 08:01 7 /libc")
+    """
+
+    for line in maps.splitlines():
+        fields = line.split()
+        if fields and fields[-1] == "[heap]":
+            start, end = fields[0].split("-")
+            return int(start, 16), int(end, 16)
+    return None
+
+
+def tcache_free(heap: bytes, base: int) -> set[int]:
+    """
+    Chunks in the tcache bins, from the tcache_perthread_struct at the
+    start of the heap. They are free but still look in use to the chunks
+    after them.
+
+    >>> heap = bytearray(0x290 + 0x40)
+    >>> heap[8:16] = (0x290 | PREV_INUSE).to_bytes(8, "little")
+    >>> heap[16:18] = (2).to_bytes(2, "little")  # two chunks in bin 0
+    >>> first, second = 0x1000 + 0x290, 0x1000 + 0x2b0
+    >>> entries = 16 + 2 * TCACHE_BINS
+    >>> heap[entries:entries + 8] = (first + 16).to_bytes(8, "little")
+    >>> mangled = ((first + 16) >> SAFE_LINKING_SHIFT) ^ (second + 16)
+    >>> heap[0x2a0:0x2a8] = mangled.to_bytes(8, "little")
+    >>> sorted(map(hex, tcache_free(bytes(heap), 0x1000)))
+    ['0x1290', '0x12b0']
+    """
+
+    size = unpack_from("<Q", heap, SIZE_SZ)[0] & ~SIZE_BITS
+    if size not in TCACHE_CHUNKS or len(heap) < size:
+        return set()
+    count_bytes = TCACHE_CHUNKS[size]
+    counts = [
+        int.from_bytes(heap[at : at + count_bytes], "little")
+        for at in range(CHUNK_HEADER, size, count_bytes)
+    ][:TCACHE_BINS]
+    entries = CHUNK_HEADER + count_bytes * TCACHE_BINS
+
+    def inside(mem: int) -> bool:
+        return base + CHUNK_HEADER <= mem < base + len(heap) - SIZE_SZ
+
+    free = set[int]()
+    for i, count in enumerate(counts):
+        # Entries point past the chunk header, like malloc's result
+        mem = unpack_from("<Q", heap, entries + i * SIZE_SZ)[0]
+        for _ in range(count):
+            if not inside(mem) or mem - CHUNK_HEADER in free:
+                break
+            free.add(mem - CHUNK_HEADER)
+            mem = _next(heap, base, mem, inside)
+    return free
+
+
+def fastbin_free(heap: bytes, base: int, heads: list[int]) -> set[int]:
+    """
+    Chunks in the fast bins, which also keep PREV_INUSE set after them
+
+    >>> heap = bytearray(0x60)
+    >>> mangled = ((0x1000 + 0x30 + 16) >> SAFE_LINKING_SHIFT) ^ 0x1000
+    >>> heap[0x40:0x48] = mangled.to_bytes(8, "little")
+    >>> sorted(map(hex, fastbin_free(bytes(heap), 0x1000, [0x1030, 0])))
+    ['0x1000', '0x1030']
+    """
+
+    def inside(fd: int) -> bool:
+        return base <= fd < base + len(heap) - CHUNK_HEADER - SIZE_SZ
+
+    free = set[int]()
+    for chunk in heads:
+        while chunk and inside(chunk) and chunk not in free:
+            free.add(chunk)
+            # fd points at the next chunk itself
+            chunk = _next(heap, base, chunk + CHUNK_HEADER, inside)
+    return free
+
+
+def live_blocks(
+    heap: bytes, base: int, free=frozenset[int](), top: int | None = None
+) -> dict[int, int]:
+    """
+    The blocks the program allocated, leaving out free chunks and malloc's
+    own tcache_perthread_struct
+    """
+
+    blocks = walk(heap, base, tcache_free(heap, base) | free, top)
+    if unpack_from("<Q", heap, SIZE_SZ)[0] & ~SIZE_BITS in TCACHE_CHUNKS:
+        blocks.pop(base + CHUNK_HEADER, None)
+    return blocks
+
+
+def array_cells(usable: int, size: int) -> int:
+    """
+    The fewest cells of `size` bytes a block of `usable` bytes was malloced
+    for, or 1 if it may have been asked for just one. Malloc rounds
+    requests up to less than the next chunk, so a block was asked for more
+    than usable - CHUNK_HEADER bytes, unless it is a smallest chunk, which
+    any small request gets. Cells past the fewest may be malloc's rounding,
+    which was never written, so they are left out: an array can come out a
+    few cells short, never long.
+
+    >>> array_cells(40, 8), array_cells(24, 8), array_cells(24, 16)
+    (4, 1, 1)
+    >>> array_cells(4008, 4), array_cells(56, 16), array_cells(40, 32)
+    (999, 3, 1)
+    """
+
+    if size <= 0 or usable <= MIN_CHUNK - SIZE_SZ:
+        return 1
+    return (usable - CHUNK_HEADER) // size + 1
+
+
+def walk(
+    heap: bytes, base: int, free: set[int], top: int | None = None
+) -> dict[int, int]:
+    """
+    The blocks in use in contiguous chunks from base, as the address
+    malloc returned -> usable size. A chunk is in use when the next one
+    has PREV_INUSE set, unless it is in a free list that keeps the bit
+    (`free`). The walk ends at the top chunk, which is the one running to
+    the end of the heap if `top` is not known.
+
+    >>> def chunk(size, prev_inuse=True):
+    ...     header = (0).to_bytes(8, "little")
+    ...     header += (size | prev_inuse).to_bytes(8, "little")
+    ...     return header + bytes(size - CHUNK_HEADER)
+    >>> heap = chunk(0x20) + chunk(0x30) + chunk(0x40) + chunk(0x50, False)
+    >>> heap += chunk(0x100)  # top
+    >>> {hex(a): n for a, n in walk(heap, 0x1000, set()).items()}
+    {'0x1010': 24, '0x1030': 40, '0x10a0': 72}
+    >>> {hex(a): n for a, n in walk(heap, 0x1000, {0x1020}).items()}
+    {'0x1010': 24, '0x10a0': 72}
+    >>> {hex(a): n for a, n in walk(heap, 0x1000, set(), top=0x1050).items()}
+    {'0x1010': 24, '0x1030': 40}
+    """
+
+    blocks = dict[int, int]()
+    offset = 0
+    previous: tuple[int, int] | None = None  # chunk address and size
+    while offset + CHUNK_HEADER <= len(heap):
+        chunk = base + offset
+        size_field = unpack_from("<Q", heap, offset + SIZE_SZ)[0]
+        if previous is not None and size_field & PREV_INUSE:
+            address, size = previous
+            if address not in free:
+                # The next chunk's prev_size field is usable too
+                blocks[address + CHUNK_HEADER] = size - SIZE_SZ
+        size = size_field & ~SIZE_BITS
+        if (
+            chunk == top
+            or size < MIN_CHUNK
+            or offset + size >= len(heap)
+        ):
+            break
+        previous = chunk, size
+        offset += size
+    return blocks
+
+
+def _next(heap: bytes, base: int, field: int, inside) -> int:
+    """
+    The next pointer of a free chunk stored at field, demangled if
+    safe-linking mangled it
+    """
+
+    stored = unpack_from("<Q", heap, field - base)[0]
+    demangled = (field >> SAFE_LINKING_SHIFT) ^ stored
+    if stored == 0 or demangled == 0:
+        return 0  # the end of the list, with or without safe-linking
+    if inside(demangled) and demangled % CHUNK_HEADER == 0:
+        return demangled
+    return stored
@@ -0,0 +1,117 @@
+from bisect import bisect_left
+from collections import OrderedDict
+from collections import defaultdict
+from collections import deque
+from contextlib import contextmanager
+from contextvars import ContextVar
+from time import perf_counter_ns
+import os
+
+from .phases import BUCKETS, HEADER, MAX_TRACE_EVENTS, MAX_TRACED_SESSIONS
+from .phases import PHASES, histogram_lines
+from .phases import COMPILE, GDB_COMMAND, MEMORY_READ, PARSE  # noqa: F401
+from .phases import SERIALISE, EMIT, STEP  # noqa: F401
+
+"""Per-phase step timings, exported as Prometheus text and Chrome traces"""
+
+session = ContextVar[str | None]("session", default=None)
+
+
+class Histogram:
+    def __init__(self) -> None:
+        self.counts = [0] * (len(BUCKETS) + 1)
+        self.sum = 0.0
+        self.count = 0
+
+    def observe(self, seconds: float) -> None:
+        self.counts[bisect_left(BUCKETS, seconds)] += 1
+        self.sum += seconds
+        self.count += 1
+
+
+class Metrics:
+    def __init__(self) -> None:
+        self.histograms = defaultdict[str, Histogram](Histogram)
+        self.traces = OrderedDict[str, deque[dict]]()
+        self.origin = perf_counter_ns()
+
+    @contextmanager
+    def span(self, phase: str, **args):
+        """
+        Time the body of a `with` block as `phase` of the current session
+
+        >>> metrics = Metrics()
+        >>> token = session.set("sid")
+        >>> with metrics.span(PARSE, var="n"):
+        ...     pass
+        >>> session.reset(token)
+        >>> metrics.histograms[PARSE].count
+        1
+        >>> [e["name"] for e in metrics.chrome_trace("sid")["traceEvents"]]
+        ['parse']
+        """
+
+        start = perf_counter_ns()
+        try:
+            yield
+        finally:
+            self.record(phase, start, perf_counter_ns(), args)
+
+    def record(self, phase: str, start: int, end: int, args: dict) -> None:
+        self.histograms[phase].observe((end - start) / 1e9)
+
+        sid = session.get()
+        if sid is None:
+            return
+        if sid not in self.traces:
+            self.traces[sid] = deque(maxlen=MAX_TRACE_EVENTS)
+            if len(self.traces) > MAX_TRACED_SESSIONS:
+                self.traces.popitem(last=False)
+        self.traces[sid].append(
+            {
+                "name": phase,
+                "cat": "debugger",
+                "ph": "X",
+                "ts": (start - self.origin) / 1e3,
+                "dur": (end - start) / 1e3,
+                "pid": os.getpid(),
+                "tid": PHASES.index(phase) if phase in PHASES else -1,
+                "args": args,
+            }
+        )
+
+    def chrome_trace(self, sid: str) -> dict:
+        """Load the result in chrome://tracing or https://ui.perfetto.dev"""
+
+        return {
+            "traceEvents": list(self.traces.get(sid, ())),
+            "displayTimeUnit": "ms",
+            "otherData": {"session": sid},
+        }
+
+    def prometheus(self) -> str:
+        """
+        >>> metrics = Metrics()
+        >>> metrics.histograms[EMIT].observe(0.003)
+        >>> print(metrics.prometheus())  # doctest: +ELLIPSIS
+        # HELP debugger_phase_seconds Time spent in each phase of a debug step
+        # TYPE debugger_phase_seconds histogram
+        debugger_phase_seconds_bucket{phase="emit",le="0.0001"} 0
+        ...
+        debugger_phase_seconds_bucket{phase="emit",le="0.005"} 1
+        ...
+        debugger_phase_seconds_bucket{phase="emit",le="+Inf"} 1
+        debugger_phase_seconds_sum{phase="emit"} 0.003
+        debugger_phase_seconds_count{phase="emit"} 1
+        <BLANKLINE>
+        """
+
+        lines = list(HEADER)
+        for phase, histogram in sorted(self.histograms.items()):
+            lines += histogram_lines(
+                phase, histogram.counts, histogram.sum, histogram.count
+            )
+        return "\n".join(lines) + "\n"
+
+
+metrics = Metrics()
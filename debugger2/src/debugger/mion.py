@@ -57,6 +57,7 @@ def valueloads(result: str) -> any:
 
     result = _remove_octals(result)
     result = _remove_array_keys(result)
+    result = _expand_repeats(result)
     result = _remove_hexnums(result)
     result = sub(r"= (\d+) '[^']+'", r"= \1", result)  # remove char aliases
     result = sub(
@@ -105,6 +106,21 @@ def _remove_array_keys(text: str) -> str:
     return "".join(chars)
 
 
+def _expand_repeats(text: str) -> str:
+    """
+    >>> _expand_repeats('{1, 0 <repeats 3 times>, 2}')
+    '{1, 0, 0, 0, 2}'
+    >>> _expand_repeats('[0x0 <repeats 2 times>, {v = 0} <repeats 2 times>]')
+    '[0x0, 0x0, {v = 0}, {v = 0}]'
+    """
+
+    def repeat(match: Match):
+        return ", ".join([match.group(1)] * int(match.group(2)))
+
+    cell = r"(\{[^{}]*\}|[^\s{}\[\],]+)"  # a scalar or a flat struct
+    return sub(rf"{cell} <repeats (\d+) times>", repeat, text)
+
+
 def _remove_octals(text: str) -> str:
     """
     >>> input = '\\\\000\\\\265zv'
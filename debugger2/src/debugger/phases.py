@@ -0,0 +1,58 @@
+"""
+Step phases and their histograms, the same for both backends so that their
+/metrics can be compared. Each backend is built on its own, so
+debugger/src/phases.py is a copy for the legacy server and gdb scripts, kept
+identical by debugger/src/test_shared.py.
+"""
+
+COMPILE = "compile"
+GDB_COMMAND = "gdb_command"
+MEMORY_READ = "memory_read"
+PARSE = "parse"
+SERIALISE = "serialise"
+EMIT = "emit"
+STEP = "step"
+PHASES = (COMPILE, GDB_COMMAND, MEMORY_READ, PARSE, SERIALISE, EMIT, STEP)
+
+# Upper bounds in seconds, from a single MI round trip to a slow compile
+BUCKETS = (
+    0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+    0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0,
+)
+
+MAX_TRACE_EVENTS = 20_000
+MAX_TRACED_SESSIONS = 64
+
+METRIC = "debugger_phase_seconds"
+HEADER = [
+    f"# HELP {METRIC} Time spent in each phase of a debug step",
+    f"# TYPE {METRIC} histogram",
+]
+
+
+def histogram_lines(
+    phase: str, counts: list[int], total: float, count: int
+) -> list[str]:
+    """
+    Prometheus text lines of one phase, from the count in each bucket and
+    above the last
+
+    >>> lines = histogram_lines(EMIT, [0] * 5 + [1] + [0] * 11, 0.003, 1)
+    >>> lines[5], lines[-3]
+    ('debugger_phase_seconds_bucket{phase="emit",le="0.005"} 1', \
+'debugger_phase_seconds_bucket{phase="emit",le="+Inf"} 1')
+    >>> lines[-2:]
+    ['debugger_phase_seconds_sum{phase="emit"} 0.003', \
+'debugger_phase_seconds_count{phase="emit"} 1']
+    """
+
+    lines = []
+    cumulative = 0
+    for bound, bucket in zip((*BUCKETS, "+Inf"), counts):
+        cumulative += bucket
+        lines.append(
+            f'{METRIC}_bucket{{phase="{phase}",le="{bound}"}} {cumulative}'
+        )
+    lines.append(f'{METRIC}_sum{{phase="{phase}"}} {total}')
+    lines.append(f'{METRIC}_count{{phase="{phase}"}} {count}')
+    return lines
@@ -0,0 +1,24 @@
+#include <string.h>
+
+#define LENGTH 250000
+
+int sum(int *array, int length) {
+    char name[1000];
+    memset(name, 'a', sizeof name - 1);
+    name[sizeof name - 1] = '\0';
+    char *string = name;
+    int total = 0;
+    for (int i = 0; i < length; i++) {
+        total += array[i];
+    }
+    return total + (int)strlen(string);
+}
+
+int main() {
+    char initials[3] = "ab";
+    int big[LENGTH];
+    for (int i = 0; i < LENGTH; i++) {
+        big[i] = i;
+    }
+    return sum(big, LENGTH);
+}
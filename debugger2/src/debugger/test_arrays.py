@@ -0,0 +1,46 @@
+from pathlib import Path
+
+from debugger import Debugger, compile
+from debugger.debugger import PAGE_CELLS
+
+here = Path(__file__).parent
+
+
+async def test_arrays_and_strings_are_paged():
+    source = here / "test_arrays.c"
+    exe = here / "exe_arrays"
+    await compile(source, exe)
+
+    debug = Debugger()
+    try:
+        await debug.init(exe)
+        await debug.breakpoint("sum")
+        await debug.run()
+        for _ in range(5):
+            await debug.next()
+
+        frames, _, _ = await debug.trace()
+        name = frames[0].vars["name"]
+        assert name.length == 1000
+        assert name.value[:3] == ["a", "a", "a"]
+        assert len(name.value) == PAGE_CELLS
+
+        string = frames[0].vars["string"]
+        assert string.length == 999
+
+        big = frames[1].vars["big"]
+        assert big.length == 250_000
+        assert big.value == list(range(PAGE_CELLS))
+
+        initials = frames[1].vars["initials"]
+        assert initials.length == 3
+        assert initials.value == ["a", "b", "\0"]
+
+        page = await debug.read_range(big.addr, "int", 1000, 5)
+        assert page == [1000, 1001, 1002, 1003, 1004]
+        tail = await debug.read_range(name.addr, "char", 998, 2)
+        assert tail == ["a", "\0"]
+
+    finally:
+        await debug.deinit()
+        exe.unlink()
@@ -0,0 +1,41 @@
+from pathlib import Path
+
+from debugger import Debugger, compile
+
+here = Path(__file__).parent
+
+
+async def test_truncate_and_expand():
+    source = here / "test_recursion.c"
+    exe = here / "exe_budget"
+    await compile(source, exe)
+
+    debug = Debugger()
+    debug.max_nodes = 4
+    try:
+        await debug.init(exe)
+        await debug.breakpoint("delete")
+        await debug.run()
+
+        def nodes(memory):
+            return {k: o for k, o in memory.items() if k[1] == "struct node"}
+
+        # head -> 5 nodes, each with a value and next field
+        _, memory, _ = await debug.trace()
+        assert len(nodes(memory)) < 5
+        truncated = [k for k, o in memory.items() if o.truncated]
+        assert truncated
+
+        debug.expand(*truncated[0])
+        _, memory, _ = await debug.trace()
+        assert len(nodes(memory)) > 1
+
+        debug.max_nodes = 1_000
+        debug.frame_cache.clear()
+        _, memory, _ = await debug.trace()
+        assert len(nodes(memory)) == 5
+        assert not any(o.truncated for o in memory.values())
+
+    finally:
+        await debug.deinit()
+        exe.unlink()
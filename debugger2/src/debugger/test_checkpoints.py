@@ -0,0 +1,107 @@
+from asyncio import wait_for
+from pathlib import Path
+
+from debugger import Debugger, compile, Frame
+
+here = Path(__file__).parent
+
+
+async def test_step_back():
+    source = here / "test_fibonacci.c"
+    exe = here / "exe_checkpoints"
+    await compile(source, exe)
+
+    debug = Debugger()
+    try:
+        await debug.init(exe)
+        await debug.breakpoint("main")
+        await debug.run()
+        assert await debug.frames() == [Frame("main", str(source), 16)]
+
+        await debug.next()
+        await debug.next()
+        assert debug.step == 2
+        assert await debug.frames() == [Frame("main", str(source), 18)]
+
+        await debug.step_back()
+        assert debug.step == 1
+        assert await debug.frames() == [Frame("main", str(source), 17)]
+        assert (await debug.variables()) == {"n": "10"}
+
+        await debug.go_to_step(0)
+        assert await debug.frames() == [Frame("main", str(source), 16)]
+
+        await debug.go_to_step(2)
+        assert await debug.frames() == [Frame("main", str(source), 18)]
+
+        # Stepping from an earlier step forgets the steps after it
+        await debug.go_to_step(1)
+        await debug.next()
+        assert debug.step == 2
+        assert len(debug.history) == 2
+        assert max(debug.checkpoints) <= 2
+
+    finally:
+        await debug.deinit()
+        exe.unlink()
+
+
+async def test_replay_input():
+    source = here / "test_input.c"
+    exe = here / "exe_checkpoints_input"
+    await compile(source, exe)
+
+    debug = Debugger()
+    try:
+        await debug.init(exe)
+        await debug.breakpoint("main")
+        await debug.run()
+        await debug.next()
+        await debug.next()
+        debug.send_input("3\n")
+        await debug.next()
+        debug.send_input("4\n")
+        await debug.next()
+        await debug.next()
+        assert (await debug.variables())["sum"] == "7"
+        assert debug.inputs == ["", "", "3\n", "4\n", ""]
+
+        # Replaying the scanf steps feeds them the same input again, rather
+        # than blocking until the user sends it
+        await debug.go_to_step(1)
+        await wait_for(debug.go_to_step(5), 5)
+        assert await debug.frames() == [Frame("main", str(source), 9)]
+        assert (await debug.variables())["sum"] == "7"
+
+    finally:
+        await debug.deinit()
+        exe.unlink()
+
+
+async def test_rewind_takes_other_input():
+    source = here / "test_input.c"
+    exe = here / "exe_checkpoints_rewind"
+    await compile(source, exe)
+
+    debug = Debugger()
+    try:
+        await debug.init(exe)
+        await debug.breakpoint("main")
+        await debug.run()
+        for data in ["", "", "3\n", "4\n", ""]:
+            debug.send_input(data)
+            await debug.next()
+        assert (await debug.variables())["sum"] == "7"
+
+        # Input typed for the step left behind is not read after rewinding
+        debug.send_input("9\n")
+        await debug.rewind(2)
+        for data in ["5\n", "6\n", ""]:
+            debug.send_input(data)
+            await wait_for(debug.next(), 5)
+        assert (await debug.variables())["sum"] == "11"
+        assert debug.inputs == ["", "", "5\n", "6\n", ""]
+
+    finally:
+        await debug.deinit()
+        exe.unlink()
@@ -0,0 +1,78 @@
+from pathlib import Path
+
+from debugger import Debugger, compile
+
+here = Path(__file__).parent
+
+
+async def test_callers_are_cached():
+    source = here / "test_recursion.c"
+    exe = here / "exe_frame_cache"
+    await compile(source, exe)
+
+    debug = Debugger()
+    traced = list[int]()
+    trace_frame = debug._trace_frame
+
+    async def counting_trace_frame(i: int, budget):
+        traced.append(i)
+        return await trace_frame(i, budget)
+
+    debug._trace_frame = counting_trace_frame
+    try:
+        await debug.init(exe)
+        await debug.breakpoint("delete")
+        await debug.run()
+        for _ in range(5):
+            await debug.cont()
+        assert len(await debug.frames()) == 7
+        await debug.trace()
+
+        for step in range(6):
+            traced.clear()
+            cached = await debug.trace()
+            if step < 2:
+                # Stepping the innermost call leaves its callers alone, until
+                # it returns and the free() writes into the list they reach
+                assert traced == [0]
+
+            debug.frame_cache.clear()
+            fresh = await debug.trace()
+            assert cached == fresh
+
+            await debug.next()
+
+    finally:
+        await debug.deinit()
+        exe.unlink()
+
+
+async def test_active_frame_is_retraced():
+    source = here / "test_recursion.c"
+    exe = here / "exe_frame_cache_scope"
+    await compile(source, exe)
+
+    debug = Debugger()
+    try:
+        await debug.init(exe)
+        await debug.breakpoint("main")
+        await debug.run()
+
+        # The loop body's `new` comes into and goes out of scope with the pc,
+        # while main's stack pointer stays put
+        scopes = list[set[str]]()
+        for _ in range(12):
+            cached = await debug.trace()
+            debug.frame_cache.clear()
+            fresh = await debug.trace()
+            assert cached == fresh
+            scopes.append(set(cached[0][0].vars))
+
+            await debug.next()
+
+        assert any("new" in names for names in scopes)
+        assert any("new" not in names for names in scopes)
+
+    finally:
+        await debug.deinit()
+        exe.unlink()
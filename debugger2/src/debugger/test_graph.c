@@ -0,0 +1,40 @@
+#include <stdlib.h>
+
+struct node {
+    int vertex;
+    struct node *next;
+};
+
+struct graph {
+    int n;
+    struct node **adj;
+};
+
+void add_edge(struct graph *graph, int from, int to) {
+    struct node *new = malloc(sizeof(struct node));
+    new->vertex = to;
+    new->next = graph->adj[from];
+    graph->adj[from] = new;
+}
+
+int degree(struct graph *graph, int v) {
+    int degree = 0;
+    for (struct node *curr = graph->adj[v]; curr; curr = curr->next) {
+        degree++;
+    }
+    return degree;
+}
+
+int main() {
+    struct graph *graph = malloc(sizeof(struct graph));
+    graph->n = 3;
+    // Fits the smallest chunk, whose size says nothing of the count
+    graph->adj = malloc(graph->n * sizeof(struct node *));
+    for (int v = 0; v < graph->n; v++) {
+        graph->adj[v] = NULL;
+    }
+    for (int v = 0; v < graph->n; v++) {
+        add_edge(graph, v, (v + 1) % graph->n);
+    }
+    return degree(graph, 0);
+}
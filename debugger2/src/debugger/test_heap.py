@@ -0,0 +1,90 @@
+from pathlib import Path
+
+from debugger import Debugger, compile
+from debugger.address_space import DANGLING, HEAP, STACK
+
+here = Path(__file__).parent
+
+
+async def test_heap_blocks():
+    source = here / "test_recursion.c"
+    exe = here / "exe_heap"
+    await compile(source, exe)
+
+    debug = Debugger()
+    try:
+        await debug.init(exe)
+        await debug.breakpoint("delete")
+        await debug.run()
+
+        # The five nodes, whether or not the trace reached them
+        before = await debug.heap_blocks()
+        _, memory, _ = await debug.trace()
+        nodes = {int(a, 16) for a, type in memory if type == "struct node"}
+        assert nodes <= before.keys()
+        assert all(before[node] >= 16 for node in nodes)
+
+        # Into delete(NULL), then back to free the last node
+        for _ in range(5):
+            await debug.cont()
+        await debug.finish()
+        await debug.next()
+        await debug.next()
+        after = await debug.heap_blocks()
+        assert after.keys() < before.keys()
+
+        # The freed node is dangling now, the others are still live
+        space = await debug.address_space()
+        assert space is not None
+        assert {space.classify(a) for a in before.keys() - after.keys()} == {
+            DANGLING
+        }
+        assert {space.classify(a) for a in nodes & after.keys()} == {HEAP}
+        frame = (await debug.trace())[0][0]
+        assert space.classify(int(frame.vars["head"].addr, 16)) == STACK
+
+    finally:
+        await debug.deinit()
+        exe.unlink()
+
+
+async def test_malloced_arrays():
+    source = here / "test_graph.c"
+    exe = here / "exe_graph"
+    await compile(source, exe)
+
+    debug = Debugger()
+    try:
+        await debug.init(exe)
+        await debug.breakpoint("degree")
+        await debug.run()
+
+        def adjacency_lists(memory):
+            heap_data = memory["heap_data"]
+            graph = next(
+                o
+                for o in heap_data.values()
+                if o["typeName"] == "struct graph"
+            )
+            return heap_data, heap_data[graph["value"]["adj"].value]
+
+        # Three pointers fit the smallest chunk, so the heap can't tell the
+        # array from a single pointer and only the first cell is read
+        _, memory = await debug.legacy_trace()
+        _, adj = adjacency_lists(memory)
+        assert adj["typeName"] == "struct node *"
+
+        # The adjacency lists are only reachable through graph->adj[v], as
+        # many as the annotated count field says
+        debug.annotate([], ["struct graph"], {"struct graph": {"adj": "n"}})
+        _, memory = await debug.legacy_trace()
+        heap_data, adj = adjacency_lists(memory)
+        assert adj["typeName"] == "struct node *[3]"
+        assert adj["length"] == 3
+        heads = [heap_data[head] for head in adj["value"]]
+        vertices = [int(head["value"]["vertex"].value) for head in heads]
+        assert vertices == [1, 2, 0]
+
+    finally:
+        await debug.deinit()
+        exe.unlink()
@@ -0,0 +1,10 @@
+#include <stdio.h>
+
+int main(void) {
+    int a = 0;
+    int b = 0;
+    scanf("%d", &a);
+    scanf("%d", &b);
+    int sum = a + b;
+    return sum;
+}
@@ -0,0 +1,27 @@
+#include <stdlib.h>
+
+struct node {
+    int value;
+    struct node *next;
+};
+
+struct node *delete(struct node *head) {
+    if (head == NULL) {
+        return NULL;
+    }
+    struct node *rest = delete(head->next);
+    free(head);
+    return rest;
+}
+
+int main() {
+    struct node *head = NULL;
+    for (int i = 0; i < 5; i++) {
+        struct node *new = malloc(sizeof(struct node));
+        new->value = i;
+        new->next = head;
+        head = new;
+    }
+    head = delete(head);
+    return 0;
+}
@@ -0,0 +1,206 @@
+from asyncio import create_task
+from asyncio import timeout
+from asyncio import Queue
+from asyncio import QueueShutDown
+from dataclasses import dataclass
+from pathlib import Path
+from time import perf_counter
+import json
+import os
+import re
+
+from simple_websocket import AioClient
+from simple_websocket import ConnectionClosed
+
+"""Headless Socket.IO client and sample programs for benchmarking serve.py"""
+
+here = Path(__file__).parent
+legacy_samples = here.parent.parent / "debugger" / "src" / "samples"
+
+# Engine.IO v4 / Socket.IO v5 packet prefixes
+EIO_OPEN = "0"
+EIO_PING = "2"
+EIO_PONG = "3"
+EIO_MESSAGE = "4"
+SIO_CONNECT = "0"
+SIO_EVENT = "2"
+
+
+@dataclass(slots=True, frozen=True)
+class Event:
+    name: str
+    args: list
+    received_at: float
+    bytes_received: int  # total for the connection, including this event
+
+
+class HeadlessClient:
+    """
+    Just enough of a Socket.IO client to drive serve.py like the frontend
+    does, while counting every byte the server sends.
+    """
+
+    async def connect(self, url: str, path: str = "debugger"):
+        url = re.sub(r"^http", "ws", url.rstrip("/"))
+        self.ws = await AioClient.connect(
+            f"{url}/{path}/?EIO=4&transport=websocket"
+        )
+        self.bytes_received = 0
+
+        packet = await self._receive()
+        assert packet.startswith(EIO_OPEN), packet
+        await self.ws.send(EIO_MESSAGE + SIO_CONNECT)
+        while not (packet := await self._receive()).startswith(
+            EIO_MESSAGE + SIO_CONNECT
+        ):
+            pass
+        self.sid = json.loads(packet[2:])["sid"]
+
+        self.events = Queue[Event]()
+        self._reader = create_task(self._read())
+        return self
+
+    async def close(self) -> None:
+        self._reader.cancel()
+        await self.ws.close()
+
+    async def emit(self, event: str, *args) -> None:
+        await self.ws.send(
+            EIO_MESSAGE + SIO_EVENT + json.dumps([event, *args])
+        )
+
+    async def wait_for(self, *names: str, seconds: float = 30.0) -> Event:
+        """Skip events until one of `names` arrives"""
+
+        try:
+            async with timeout(seconds):
+                while (event := await self.events.get()).name not in names:
+                    pass
+        except QueueShutDown:
+            raise ConnectionError("Server closed the connection")
+        return event
+
+    async def _receive(self) -> str:
+        packet = await self.ws.receive()
+        if isinstance(packet, bytes):
+            packet = packet.decode()
+        self.bytes_received += len(packet.encode())
+        return packet
+
+    async def _read(self) -> None:
+        try:
+            while True:
+                packet = await self._receive()
+                if packet == EIO_PING:
+                    await self.ws.send(EIO_PONG)
+                elif packet.startswith(EIO_MESSAGE + SIO_EVENT):
+                    name, *args = json.loads(packet[2:])
+                    await self.events.put(
+                        Event(name, args, perf_counter(), self.bytes_received)
+                    )
+        except (ConnectionClosed, QueueShutDown):
+            self.events.shutdown()
+
+
+def samples() -> dict[str, str]:
+    """
+    Single-file C sources of the sample programs, keyed by name. The
+    multi-file linked list samples are concatenated with their library
+    since mainDebug only accepts one file.
+    """
+
+    linkedlist = legacy_samples / "linkedlist"
+    library = "\n".join(
+        _strip_local_includes((linkedlist / name).read_text())
+        for name in ("linkedlist.h", "linkedlist.c")
+    )
+
+    sources = {
+        f"linkedlist/{main}": library
+        + _strip_local_includes((linkedlist / f"{main}.c").read_text())
+        for main in ("main1", "main2", "main3")
+    }
+    sources["linkedlist/main4"] = (linkedlist / "main4.c").read_text()
+    for name in ("adjList", "heapArr", "2dArr", "stack_frames"):
+        sources[name] = (legacy_samples / f"{name}.c").read_text()
+    sources["fibonacci"] = (here / "debugger" / "test_fibonacci.c").read_text()
+    return sources
+
+
+def _strip_local_includes(source: str) -> str:
+    """
+    >>> _strip_local_includes('#include "list.h"\\n#include <stdio.h>\\n')
+    '\\n#include <stdio.h>\\n'
+    """
+
+    return re.sub(r'#include\s+"[^"]+"', "", source)
+
+
+def process_tree(pid: int) -> list[int]:
+    """A process and all of its descendants (e.g. the server and its gdbs)"""
+
+    children = dict[int, list[int]]()
+    for stat in Path("/proc").glob("[0-9]*/stat"):
+        try:
+            fields = stat.read_text().rsplit(")", 1)[1].split()
+        except OSError:
+            continue
+        children.setdefault(int(fields[1]), []).append(int(stat.parent.name))
+
+    tree = list[int]()
+    stack = [pid]
+    while stack:
+        tree.append(current := stack.pop())
+        stack.extend(children.get(current, []))
+    return tree
+
+
+def rss_bytes(pid: int) -> int:
+    """Resident memory of a process and all of its descendants"""
+
+    total = 0
+    for current in process_tree(pid):
+        try:
+            status = Path(f"/proc/{current}/status").read_text()
+        except OSError:
+            continue
+        if match := re.search(r"VmRSS:\s+(\d+) kB", status):
+            total += int(match.group(1)) * 1024
+    return total
+
+
+def cpu_seconds(pid: int) -> float:
+    """User + system CPU time a single process has used so far"""
+
+    try:
+        fields = Path(f"/proc/{pid}/stat").read_text().rsplit(")", 1)[1]
+    except OSError:
+        return 0.0
+    utime, stime = fields.split()[11:13]
+    return (int(utime) + int(stime)) / os.sysconf("SC_CLK_TCK")
+
+
+def process_name(pid: int) -> str | None:
+    try:
+        return Path(f"/proc/{pid}/comm").read_text().strip()
+    except OSError:
+        return None
+
+
+def percentile(values: list[float], p: float) -> float | None:
+    """
+    Nearest-rank percentile
+
+    >>> percentile([5, 1, 4, 2, 3], 50)
+    3
+    >>> percentile(list(range(1, 101)), 99)
+    99
+    >>> percentile([], 50) is None
+    True
+    """
+
+    if not values:
+        return None
+    ordered = sorted(values)
+    rank = max(1, -(-len(ordered) * p // 100))
+    return ordered[int(rank) - 1]
@@ -0,0 +1,344 @@
+"""
+Concurrent load generator for serve.py
+
+Simulates a class of students opening the debugger at the start of a lab:
+each simulated client arrives at some point during the ramp, submits a
+sample program with `mainDebug` and then steps through it with
+`executeNext`, pausing for a random think time between steps.
+
+While the load runs it probes the server every --interval seconds:
+    - event loop lag, as the round trip of an `echo` event
+    - CPU use of the server process and of the server plus its gdbs
+    - number of gdb processes and of active sessions
+
+and reports throughput, tail step latency, and the first interval at which
+the server saturated (echo lag above --lag-threshold, or the single-threaded
+server process above 90% CPU). Everything runs locally.
+
+Usage (from debugger2/src):
+    python3 loadtest.py --clients 200 --ramp 60 --think 3
+    python3 loadtest.py --mix linkedlist/main3=4 fibonacci=1 --output load.json
+    python3 loadtest.py --url http://localhost:8000 --pid <server pid>
+
+Every client of a sample submits the same program, which after the first
+one the server replays from its trace cache without starting gdb. So the
+server started here runs with TRACE_CACHE=0, and a --url server should be
+too; pass --trace-cache to load the server as deployed instead.
+"""
+
+from argparse import ArgumentParser
+from asyncio import create_task
+from asyncio import gather
+from asyncio import run
+from asyncio import sleep
+from dataclasses import dataclass
+from dataclasses import field
+from pathlib import Path
+from time import perf_counter
+import json
+import os
+import random
+import sys
+
+from benchmark import start_server
+from headless import HeadlessClient, samples, percentile
+from headless import process_tree, process_name, cpu_seconds, rss_bytes
+
+CPU_SATURATION = 0.9
+
+
+@dataclass(slots=True)
+class Results:
+    started: float
+    steps: list[tuple[float, float]] = field(default_factory=list)
+    sessions: dict[str, int] = field(
+        default_factory=lambda: {
+            "arrived": 0,
+            "active": 0,
+            "completed": 0,
+            "compile_errors": 0,
+            "failed": 0,
+        }
+    )
+    probes: list[dict] = field(default_factory=list)
+
+
+def arrivals(n: int, ramp: float, model: str) -> list[float]:
+    """
+    Arrival times in seconds since the start of the lab
+
+    lab:        front-loaded, most students arrive early in the ramp
+    poisson:    constant rate of n / ramp arrivals per second
+    burst:      everyone at once
+
+    >>> len(arrivals(10, 60, "lab"))
+    10
+    >>> arrivals(3, 60, "burst")
+    [0.0, 0.0, 0.0]
+    """
+
+    match model:
+        case "lab":
+            times = [ramp * random.betavariate(1.2, 4) for _ in range(n)]
+        case "poisson":
+            times, t = [], 0.0
+            for _ in range(n):
+                t += random.expovariate(n / ramp) if ramp else 0.0
+                times.append(t)
+        case "burst":
+            times = [0.0] * n
+        case _:
+            raise ValueError(f"Unknown arrival model: {model}")
+    return sorted(times)
+
+
+async def student(
+    url: str,
+    arrive_at: float,
+    code: str,
+    steps: int,
+    think: float,
+    step_timeout: float,
+    results: Results,
+) -> None:
+    await sleep(max(0.0, arrive_at - (perf_counter() - results.started)))
+    results.sessions["arrived"] += 1
+    results.sessions["active"] += 1
+    try:
+        client = await HeadlessClient().connect(url)
+        try:
+            await client.emit("mainDebug", code)
+            event = await client.wait_for(
+                "mainDebug", "compileError", seconds=120
+            )
+            if event.name == "compileError":
+                results.sessions["compile_errors"] += 1
+                return
+
+            for _ in range(steps):
+                await sleep(random.expovariate(1 / think) if think else 0)
+                sent_at = perf_counter()
+                await client.emit("executeNext")
+                try:
+                    event = await client.wait_for(
+                        "sendBackendStateToUser", seconds=step_timeout
+                    )
+                except TimeoutError:
+                    # Most likely the program finished
+                    break
+                results.steps.append(
+                    (sent_at - results.started, event.received_at - sent_at)
+                )
+            results.sessions["completed"] += 1
+        finally:
+            await client.close()
+    except Exception:
+        results.sessions["failed"] += 1
+    finally:
+        results.sessions["active"] -= 1
+
+
+async def probe(url: str, pid: int | None, interval: float, results: Results):
+    client = await HeadlessClient().connect(url)
+    cores = os.cpu_count() or 1
+    previous = None
+    try:
+        while True:
+            sent_at = perf_counter()
+            await client.emit("echo", sent_at)
+            try:
+                await client.wait_for("echo", seconds=interval * 10)
+                lag = perf_counter() - sent_at
+            except TimeoutError:
+                lag = None
+
+            sample = {
+                "t": perf_counter() - results.started,
+                "lag": lag,
+                "active": results.sessions["active"],
+            }
+            if pid is not None:
+                tree = process_tree(pid)
+                now = (cpu_seconds(pid), sum(map(cpu_seconds, tree)))
+                sample["gdb_processes"] = sum(
+                    process_name(p) == "gdb" for p in tree
+                )
+                sample["rss_bytes"] = rss_bytes(pid)
+                if previous is not None:
+                    elapsed = sample["t"] - previous[0]
+                    sample["server_cpu"] = (now[0] - previous[1][0]) / elapsed
+                    # gdbs that exited take their CPU time with them
+                    sample["total_cpu"] = max(
+                        0.0, (now[1] - previous[1][1]) / elapsed / cores
+                    )
+                previous = (sample["t"], now)
+            results.probes.append(sample)
+            await sleep(max(0.0, interval - (perf_counter() - sent_at)))
+    finally:
+        await client.close()
+
+
+def summarise(results: Results, interval: float, lag_threshold: float):
+    elapsed = perf_counter() - results.started
+    latencies = [latency for _, latency in results.steps]
+
+    windows = list[dict]()
+    for sample in results.probes:
+        start = sample["t"] - interval
+        window = [l for t, l in results.steps if start <= t < sample["t"]]
+        windows.append(
+            sample
+            | {
+                "steps_per_second": len(window) / interval,
+                "p95": percentile(window, 95),
+            }
+        )
+
+    saturation = next(
+        (
+            w
+            for w in windows
+            if (w["lag"] is None or w["lag"] > lag_threshold)
+            or w.get("server_cpu", 0) > CPU_SATURATION
+            or w.get("total_cpu", 0) > CPU_SATURATION
+        ),
+        None,
+    )
+
+    return {
+        "duration": elapsed,
+        "sessions": results.sessions,
+        "steps": len(latencies),
+        "throughput": len(latencies) / elapsed if elapsed else 0,
+        "p50": percentile(latencies, 50),
+        "p95": percentile(latencies, 95),
+        "p99": percentile(latencies, 99),
+        "max_gdb_processes": max(
+            (w.get("gdb_processes", 0) for w in windows), default=0
+        ),
+        "saturation": saturation,
+        "windows": windows,
+    }
+
+
+def report(summary: dict) -> None:
+    def ms(x):
+        return f"{x * 1e3:8.1f}" if x is not None else f"{'-':>8}"
+
+    def pct(x):
+        return f"{x:6.0%}" if x is not None else f"{'-':>6}"
+
+    print(f"{'t':>6} {'active':>6} {'gdb':>4} {'steps/s':>8} {'p95 ms':>8} "
+          f"{'lag ms':>8} {'server':>6} {'total':>6}")
+    for w in summary["windows"]:
+        print(
+            f"{w['t']:6.0f} {w['active']:6} {w.get('gdb_processes', '-'):>4} "
+            f"{w['steps_per_second']:8.1f} {ms(w['p95'])} {ms(w['lag'])} "
+            f"{pct(w.get('server_cpu'))} {pct(w.get('total_cpu'))}"
+        )
+
+    print()
+    print(f"sessions:     {summary['sessions']}")
+    print(f"steps:        {summary['steps']} "
+          f"({summary['throughput']:.1f} steps/s)")
+    print(f"latency (ms): p50 {ms(summary['p50']).strip()} "
+          f"p95 {ms(summary['p95']).strip()} "
+          f"p99 {ms(summary['p99']).strip()}")
+    print(f"gdb peak:     {summary['max_gdb_processes']}")
+    if (saturation := summary["saturation"]) is not None:
+        print(f"saturated:    at {saturation['t']:.0f}s with "
+              f"{saturation['active']} active sessions")
+    else:
+        print("saturated:    no")
+
+
+def parse_mix(specs: list[str] | None, names: list[str]) -> dict[str, float]:
+    """
+    >>> parse_mix(["a=3", "b"], ["a", "b", "c"])
+    {'a': 3.0, 'b': 1.0}
+    >>> parse_mix(None, ["a", "b"])
+    {'a': 1.0, 'b': 1.0}
+    """
+
+    if not specs:
+        return {name: 1.0 for name in names}
+    mix = {}
+    for spec in specs:
+        name, _, weight = spec.partition("=")
+        if name not in names:
+            raise ValueError(f"Unknown sample {name}, expected one of {names}")
+        mix[name] = float(weight or 1)
+    return mix
+
+
+async def main() -> int:
+    parser = ArgumentParser(description="Concurrent load generator")
+    parser.add_argument("--url", help="load a running server instead")
+    parser.add_argument("--pid", type=int, help="pid of the --url server")
+    parser.add_argument("--clients", type=int, default=200)
+    parser.add_argument("--ramp", type=float, default=60.0,
+                        help="seconds over which clients arrive")
+    parser.add_argument("--arrival", choices=("lab", "poisson", "burst"),
+                        default="lab")
+    parser.add_argument("--think", type=float, default=3.0,
+                        help="mean seconds between steps of a client")
+    parser.add_argument("--steps", type=int, default=30,
+                        help="steps per client")
+    parser.add_argument("--step-timeout", type=float, default=30.0)
+    parser.add_argument("--mix", nargs="*", metavar="SAMPLE[=WEIGHT]",
+                        help="program mix, default: all samples equally")
+    parser.add_argument("--interval", type=float, default=2.0)
+    parser.add_argument("--lag-threshold", type=float, default=0.1)
+    parser.add_argument("--seed", type=int)
+    parser.add_argument("--output", type=Path, help="write results as JSON")
+    parser.add_argument("--trace-cache", action="store_true",
+                        help="replay repeated sessions, see serve.py")
+    args = parser.parse_args()
+
+    random.seed(args.seed)
+    sources = samples()
+    mix = parse_mix(args.mix, list(sources))
+
+    server = None
+    url, pid = args.url, args.pid
+    if url is None:
+        url, server = await start_server(args.trace_cache)
+        pid = server.pid
+
+    results = Results(started=perf_counter())
+    prober = create_task(probe(url, pid, args.interval, results))
+    try:
+        programs = random.choices(
+            list(mix), weights=list(mix.values()), k=args.clients
+        )
+        await gather(
+            *(
+                student(
+                    url,
+                    arrive_at,
+                    sources[program],
+                    args.steps,
+                    args.think,
+                    args.step_timeout,
+                    results,
+                )
+                for arrive_at, program in zip(
+                    arrivals(args.clients, args.ramp, args.arrival), programs
+                )
+            )
+        )
+    finally:
+        prober.cancel()
+        if server is not None:
+            server.terminate()
+            await server.wait()
+
+    summary = summarise(results, args.interval, args.lag_threshold)
+    report(summary)
+    if args.output:
+        args.output.write_text(json.dumps(summary, indent=2))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(run(main()))
@@ -1,4 +1,8 @@
+from contextlib import asynccontextmanager
+from contextlib import suppress
 from dataclasses import asdict
+from dataclasses import dataclass
+from dataclasses import field
 import json
 from pprint import pp
 from tempfile import mkstemp
@@ -11,6 +15,10 @@ from socketio import AsyncServer
 from socketio import ASGIApp
 
 from debugger import Debugger, compile
+from debugger.metrics import metrics, session
+from debugger.metrics import COMPILE, SERIALISE, EMIT, STEP
+from trace_cache import Recording, TraceCache
+from trace_file import TraceFiles
 
 logging.basicConfig(level=logging.INFO)
 debug = logging.debug
@@ -22,10 +30,20 @@ critical = logging.critical
 
 
 server = AsyncServer(async_mode="asgi", cors_allowed_origins="*")
+cache = TraceCache()
+# TRACE_CACHE=0 gives every session its own gdb, e.g. to benchmark them
+use_cache = os.environ.get("TRACE_CACHE", "1") != "0"
+traces = TraceFiles(
+    os.environ.get("TRACE_DIR", Path(__file__).parent / "traces")
+)
+TRACE_CHUNK_SIZE = 64 * 1024
+# Trace name -> the sid that saved it, the only one that can save over it
+trace_owners = dict[str, str]()
 
 
 class State:
-    async def init(self, code: str):
+    async def init(self, sid: str, code: str):
+        self.sid = sid
         fd, path = mkstemp(suffix=".c")
         os.close(fd)
         self.source = Path(path)
@@ -34,17 +52,67 @@ class State:
         os.close(fd)
         self.exe = Path(path)
 
-        self.debugger = Debugger()
+        self.debugger: Debugger | None = None
+        self.seen = set()
+        self.step = 0
+        self.stdin = ""  # sent since the last step
+        self.waited = False  # the program waited for input this step
+        self.waiting = False  # a replayed step waits for the rest of stdin
+        self.on_recording = True  # every step so far matches the recording
+        self.captured: list | None = None
+        self.sent = list[list]()  # the events of each step, for saveTrace
+        self.annotated = [], [], {}  # see setAnnotatedRoots
 
         self.source.write_text(code)
-        await compile(self.source, self.exe)
-        await self.debugger.init(self.exe)
+        with metrics.span(COMPILE):
+            await compile(self.source, self.exe, debug_name="main.c")
 
-        self.seen = set()
+        self.key = TraceCache.key(self.exe.read_bytes())
+        # An unshared recording is never added to, see TraceCache.extend
+        self.recording = (
+            cache.recording(self.key) if use_cache else Recording()
+        )
+        if not self.recording.steps:
+            await self.go_live()
         return self
 
+    async def go_live(self):
+        """Start gdb and catch up with the steps served from the recording"""
+
+        self.debugger = Debugger()
+        await self.debugger.init(self.exe)
+        self.debugger.on_input(self.request_input)
+        self.debugger.annotate(*self.annotated)
+        await self.debugger.breakpoints(await self.debugger.functions())
+        await self.debugger.run()
+        for step in self.recording.steps[: self.step]:
+            self.write_stdin(step.stdin)
+            await self.debugger.next()
+        self.write_stdin(self.stdin)
+
+    def context(self) -> str:
+        """Besides stdin, what decides the states traced for a step"""
+
+        variables, types, lengths = self.annotated
+        expanded = self.debugger.expanded if self.debugger else ()
+        return json.dumps(
+            [sorted(variables), sorted(types), lengths, sorted(expanded)],
+            sort_keys=True,
+        )
+
+    async def request_input(self) -> None:
+        # Not through emit(): only the owner can type, viewers just watch
+        info(f"[{self.sid}] program is waiting for input")
+        self.waited = True
+        await server.emit("programWaitingForInput", to=self.sid)
+
+    def write_stdin(self, data: str) -> None:
+        if data and self.debugger is not None:
+            self.debugger.send_input(data)
+
     async def deinit(self):
-        await self.debugger.deinit()
+        if self.debugger is not None:
+            await self.debugger.deinit()
         self.exe.unlink()
         self.source.unlink()
 
@@ -52,6 +120,50 @@ class State:
 state = dict[str, State]()
 
 
+@dataclass(slots=True)
+class Room:
+    """
+    A lecture: the owner's session is sent to every viewer in the room, so
+    the server does the same work however many students are watching
+    """
+
+    owner: str
+    types: list[dict] = field(default_factory=list)
+    latest: dict | None = None  # the last backend state, for late joiners
+    step: int = 0  # the owner's step that latest is the state after
+
+    def observe(self, event: str, data: any) -> None:
+        if event == "sendTypeDeclaration":
+            self.types.append(data)
+        elif event == "sendBackendStateToUser":
+            self.latest = data
+            self.step += 1
+        elif event == "goToStep":
+            self.latest = data["state"]
+            self.step = data["step"]
+
+
+rooms = dict[str, Room]()  # socket.io room -> lecture
+owned = dict[str, str]()  # owner sid -> socket.io room
+
+
+def lecture_room(name: str) -> str:
+    # Keeps lectures apart from the room socket.io makes for every sid
+    return f"lecture:{name}"
+
+
+async def has_session(sid: str, event: str) -> bool:
+    """Viewers of a lecture have no session of their own to act on"""
+
+    if sid in state:
+        return True
+    warning(f"[{sid}] '{event}' without a debug session")
+    await server.emit(
+        "lectureError", f"Only the lecturer can '{event}' here", to=sid
+    )
+    return False
+
+
 @server.event
 async def connect(sid: str, environ: dict) -> None:
     info(f"[{sid}] connected")
@@ -59,6 +171,8 @@ async def connect(sid: str, environ: dict) -> None:
 
 @server.event
 async def disconnect(sid: str) -> None:
+    if sid in owned:
+        await close_lecture(sid)
     if sid in state:
         await state[sid].deinit()
         del state[sid]
@@ -74,56 +188,391 @@ async def echo(sid: str, data: any) -> None:
 
 @server.event
 async def mainDebug(sid: str, code: str) -> None:
+    session.set(sid)
     if sid in state:
         await state[sid].deinit()
         del state[sid]
 
     try:
         state[sid] = State()
-        await state[sid].init(code)
+        await state[sid].init(sid, code)
     except AssertionError as e:
         info(f"[{sid}] failed to compile code")
         await server.emit("compileError", e.args[0][1].decode(), to=sid)
         return
 
-    for func in await state[sid].debugger.functions():
-        await state[sid].debugger.breakpoint(func)
-    await state[sid].debugger.run()
-
     info(f"[{sid}] compiled code")
+    if sid in owned:
+        # Viewers start over along with the owner
+        rooms[owned[sid]] = Room(sid)
     await server.emit(
-        "mainDebug", "Finished mainDebug event on server", to=sid
+        "mainDebug",
+        "Finished mainDebug event on server",
+        to=owned.get(sid, sid),
     )
 
 
 @server.event
 async def executeNext(sid: str) -> None:
-    assert sid in state
-    debugger = state[sid].debugger
+    if not await has_session(sid, "executeNext"):
+        return
+    session.set(sid)
+    with metrics.span(STEP):
+        await execute_next(sid)
+
+
+async def execute_next(sid: str) -> None:
+    current = state[sid]
+    recording = current.recording
+    if current.debugger is None and recording.awaits_input(
+        current.step, current.stdin
+    ):
+        # Continued by send_stdin, as a live step would be
+        current.waiting = True
+        await current.request_input()
+        return
+    if current.on_recording and current.step < len(recording.steps):
+        current.on_recording = recording.matches(
+            current.step, current.stdin, current.context()
+        )
 
-    await debugger.next()
+    if current.debugger is None:
+        if current.on_recording and current.step < len(recording.steps):
+            info(f"[{sid}] replay 'executeNext' from the trace cache")
+            events = recording.steps[current.step].events
+            for event, data in events:
+                if event == "sendTypeDeclaration":
+                    current.seen.add(data["typeName"])
+                await emit(sid, event, data)
+            del current.sent[current.step :]
+            current.sent.append(events)
+            current.step += 1
+            current.stdin = ""
+            current.waited = False
+            return
+        if current.on_recording and recording.finished:
+            return
+        await current.go_live()
+
+    current.captured = []
+    try:
+        await current.debugger.next()
+    except ValueError:
+        if current.on_recording and current.step == len(recording.steps):
+            recording.finished = True
+        raise
     info(f"[{sid}] run 'executeNext'")
-    await server.emit(
-        "executeNext", "Finished executeNext event on server-side", to=sid
+    await emit(
+        sid, "executeNext", "Finished executeNext event on server-side"
     )
+    await send_state(sid)
+
+    if current.on_recording:
+        cache.extend(
+            current.key,
+            recording,
+            current.step,
+            current.stdin,
+            current.waited,
+            current.context(),
+            current.captured,
+        )
+    del current.sent[current.step :]
+    current.sent.append(current.captured)
+    current.captured = None
+    current.step += 1
+    current.stdin = ""
+    current.waited = False
+
+
+@server.event
+async def stepBack(sid: str) -> None:
+    if not await has_session(sid, "stepBack"):
+        return
+    session.set(sid)
+    with metrics.span(STEP, direction="back"):
+        await go_to_step(sid, state[sid].step - 1)
+
+
+@server.event
+async def goToStep(sid: str, step: int) -> None:
+    if not await has_session(sid, "goToStep"):
+        return
+    session.set(sid)
+    with metrics.span(STEP, direction="goto"):
+        await go_to_step(sid, step)
+
+
+async def go_to_step(sid: str, step: int) -> None:
+    """
+    Take the program back to an earlier step, for the next executeNext to
+    carry on from there, e.g. with other input. The client drops the states
+    after it, and gets the state of the step again for viewers that joined
+    later. A live session restores gdb's nearest checkpoint and replays the
+    steps after it, a replayed one just replays the recording from there.
+    """
+
+    current = state[sid]
+    step = max(0, min(step, current.step))
+    if current.debugger is not None:
+        try:
+            await current.debugger.rewind(step)
+        except ValueError as e:
+            warning(f"[{sid}] could not go to step {step}: {e}")
+            return
+    latest = None
+    for event, data in current.sent[step - 1] if step > 0 else []:
+        if event == "sendBackendStateToUser":
+            latest = data
+    current.step = step
+    current.stdin = ""
+    current.waited = False
+    current.waiting = False
+    del current.sent[step:]
+    info(f"[{sid}] went to step {step}")
+    await emit(sid, "goToStep", {"step": step, "state": latest})
+
+
+async def send_state(sid: str) -> None:
+    debugger = state[sid].debugger
 
     legacy_types, legacy_mem = await debugger.legacy_trace()
+    await send_types(sid, legacy_types)
+
+    with metrics.span(SERIALISE):
+        data = json.loads(json.dumps(legacy_mem, default=asdict))
+    with metrics.span(EMIT):
+        await emit(sid, "sendBackendStateToUser", data)
+
+
+async def send_types(sid: str, legacy_types: list[dict]) -> None:
     for type in legacy_types:
         if type["typeName"] in state[sid].seen:
             continue
         state[sid].seen.add(type["typeName"])
-        await server.emit(
-            "sendTypeDeclaration",
-            json.loads(json.dumps(type, default=asdict)),
-            to=sid,
-        )
+        with metrics.span(SERIALISE):
+            data = json.loads(json.dumps(type, default=asdict))
+        with metrics.span(EMIT):
+            await emit(sid, "sendTypeDeclaration", data)
+
+
+async def emit(sid: str, event: str, data: any) -> None:
+    """
+    Emit an event of a step, capturing it for the trace cache. The events of
+    a lecture owner go to the whole room, which socket.io encodes once.
+    """
+
+    if state[sid].captured is not None:
+        state[sid].captured.append((event, data))
+    if (room := owned.get(sid)) is not None:
+        rooms[room].observe(event, data)
+    await server.emit(event, data, to=room or sid)
+
+
+@server.event
+async def setAnnotatedRoots(sid: str, roots: dict) -> None:
+    """
+    Stack variables and types the user annotated, which are traced first,
+    and the count fields of annotated structs' malloced arrays.
+    Recorded steps are only replayed with the annotations they were traced
+    with, see State.context.
+    """
+
+    if not await has_session(sid, "setAnnotatedRoots"):
+        return
+    current = state[sid]
+    current.annotated = (
+        roots.get("variables", []),
+        roots.get("types", []),
+        roots.get("lengths", {}),
+    )
+    if current.debugger is not None:
+        current.debugger.annotate(*current.annotated)
+
+
+@asynccontextmanager
+async def at_step(debugger: Debugger, step: int):
+    """
+    Go to an earlier step for the body, and back to the session's step
+    after it however it ends, so the next executeNext steps from there
+    """
+
+    back = debugger.step
+    if step == back:
+        # Read in place, the usual case of the step being looked at
+        yield
+        return
+    try:
+        await debugger.go_to_step(step)
+        yield
+    finally:
+        await debugger.go_to_step(back)
+
+
+@server.event
+async def expandObject(sid: str, request: dict) -> None:
+    """
+    Trace past an object marked truncated in the state after a step. The
+    objects found are sent back for the client to merge into that state,
+    later steps trace past it too.
+    """
+
+    if not await has_session(sid, "expandObject"):
+        return
+    session.set(sid)
+    current = state[sid]
+    if current.debugger is None:
+        await current.go_live()
+    debugger = current.debugger
+    debugger.expand(request["addr"], request["typeName"])
+
+    step = request.get("step", debugger.step)
+    try:
+        async with at_step(debugger, step):
+            legacy_types, legacy_mem = await debugger.legacy_trace()
+    except ValueError as e:
+        warning(f"[{sid}] could not expand at step {step}: {e}")
+        return
+
+    info(f"[{sid}] expanded {request['typeName']} at {request['addr']}")
+    await send_types(sid, legacy_types)
+    await server.emit(
+        "expandObject",
+        {
+            "step": step,
+            "addr": request["addr"],
+            "typeName": request["typeName"],
+            "heap_data": legacy_mem["heap_data"],
+        },
+        to=owned.get(sid, sid),
+    )
+
+
+@server.event
+async def readRange(sid: str, request: dict) -> None:
+    """
+    Cells of an array or string that was sent as its first page, read in
+    the state after a step. Only the pages the client shows are asked for.
+    """
+
+    if not await has_session(sid, "readRange"):
+        return
+    session.set(sid)
+    current = state[sid]
+    if current.debugger is None:
+        await current.go_live()
+    debugger = current.debugger
+
+    step = request.get("step", debugger.step)
+    try:
+        async with at_step(debugger, step):
+            cells = await debugger.read_range(
+                request["addr"],
+                request["elementType"],
+                request["start"],
+                request["count"],
+            )
+    except ValueError as e:
+        warning(f"[{sid}] could not read {request['addr']} at {step}: {e}")
+        return
+
     await server.emit(
-        "sendBackendStateToUser",
-        json.loads(json.dumps(legacy_mem, default=asdict)),
+        "readRange",
+        {
+            "step": step,
+            "addr": request["addr"],
+            "start": request["start"],
+            "cells": cells,
+        },
         to=sid,
     )
 
 
+@server.event
+async def startLecture(sid: str, name: str) -> None:
+    room = lecture_room(name)
+    if room in rooms and rooms[room].owner != sid:
+        await server.emit("lectureError", f"'{name}' is taken", to=sid)
+        return
+    if sid in owned:
+        await close_lecture(sid)
+
+    rooms[room] = Room(sid)
+    owned[sid] = room
+    await server.enter_room(sid, room)
+    info(f"[{sid}] started lecture '{name}'")
+    await server.emit("startLecture", name, to=sid)
+
+
+@server.event
+async def joinLecture(sid: str, name: str) -> None:
+    room = lecture_room(name)
+    if room not in rooms:
+        await server.emit("lectureError", f"No lecture '{name}'", to=sid)
+        return
+
+    await server.enter_room(sid, room)
+    info(f"[{sid}] joined lecture '{name}'")
+    # Catch up from the latest state, which is all the frontend draws. Its
+    # step keeps the viewer's timeline in line with the owner's, which
+    # expandObject refers to.
+    lecture = rooms[room]
+    await server.emit(
+        "joinLecture", {"name": name, "step": lecture.step}, to=sid
+    )
+    for type in lecture.types:
+        await server.emit("sendTypeDeclaration", type, to=sid)
+    if lecture.latest is not None:
+        await server.emit("sendBackendStateToUser", lecture.latest, to=sid)
+
+
+@server.event
+async def leaveLecture(sid: str, name: str) -> None:
+    if owned.get(sid) == lecture_room(name):
+        await close_lecture(sid)
+    else:
+        await server.leave_room(sid, lecture_room(name))
+
+
+async def close_lecture(sid: str) -> None:
+    room = owned.pop(sid)
+    del rooms[room]
+    info(f"[{sid}] closed lecture '{room}'")
+    await server.emit("lectureClosed", room.removeprefix("lecture:"), to=room)
+    await server.close_room(room)
+
+
+@server.event
+async def saveTrace(sid: str, name: str) -> None:
+    """
+    Save the steps so far as a trace file, served at /traces/<name>. A
+    name saved by another session, or before the server started, is
+    refused, so a published walkthrough can't be replaced by anyone else.
+    """
+
+    if not await has_session(sid, "saveTrace"):
+        return
+    types, states = [], []
+    for events in state[sid].sent:
+        for event, data in events:
+            if event == "sendTypeDeclaration":
+                types.append(data)
+            elif event == "sendBackendStateToUser":
+                states.append(data)
+
+    try:
+        if traces.path(name).exists() and trace_owners.get(name) != sid:
+            raise ValueError(f"Trace '{name}' is taken")
+        traces.write(name, types, states)
+    except ValueError as e:
+        warning(f"[{sid}] could not save trace: {e}")
+        await server.emit("saveTraceError", str(e), to=sid)
+        return
+    trace_owners[name] = sid
+    info(f"[{sid}] saved {len(states)} steps to trace '{name}'")
+    await server.emit("saveTrace", f"/traces/{name}", to=sid)
+
+
 @server.event
 async def EOF(sid: str) -> None:
     error("event 'EOF' not implemented")
@@ -135,11 +584,112 @@ async def SIGINT(sid: str) -> None:
 
 
 @server.event
-async def send_stdin(sid: str) -> None:
-    error("event 'send_stdin' not implemented")
+async def send_stdin(sid: str, data: str) -> None:
+    if not await has_session(sid, "send_stdin"):
+        return
+    current = state[sid]
+    current.stdin += data + "\n"
+    current.write_stdin(data + "\n")
+    if current.waiting:
+        current.waiting = False
+        session.set(sid)
+        with metrics.span(STEP):
+            await execute_next(sid)
+
+
+async def http(scope: dict, receive, send) -> None:
+    """
+    Plain HTTP endpoints for saved traces:
+        GET /traces/<name>          the trace file, for the frontend to load
+        GET /traces/<name>/types    its type declarations as JSON
+        GET /traces/<name>/<step>   the backend state after a step as JSON
+
+    and for local tooling only:
+        GET /metrics        step phase histograms, Prometheus text format
+        GET /trace/<sid>    Chrome trace JSON of one session's steps
+    """
+
+    if scope["type"] != "http":
+        return
+
+    path = scope["path"]
+    headers = []
+    status, content_type, body = 404, "text/plain", b"Not Found"
+    if path.startswith("/traces/"):
+        headers.append((b"access-control-allow-origin", b"*"))
+        name, _, part = path.removeprefix("/traces/").partition("/")
+        if not part:
+            try:
+                file = traces.path(name).open("rb")
+            except (ValueError, FileNotFoundError):
+                pass
+            else:
+                with file:
+                    await send_trace(scope, send, file, headers)
+                return
+        with suppress(KeyError, ValueError, IndexError):
+            content_type, body = trace_response(name, part)
+            status = 200
+    elif scope["client"] and scope["client"][0] not in ("127.0.0.1", "::1"):
+        status, body = 403, b"Forbidden"
+    elif path == "/metrics":
+        status, body = 200, metrics.prometheus().encode()
+        content_type = "text/plain; version=0.0.4"
+    elif path.startswith("/trace/"):
+        sid = path.removeprefix("/trace/")
+        status, body = 200, json.dumps(metrics.chrome_trace(sid)).encode()
+        content_type = "application/json"
+
+    await send(
+        {
+            "type": "http.response.start",
+            "status": status,
+            "headers": [(b"content-type", content_type.encode()), *headers],
+        }
+    )
+    await send({"type": "http.response.body", "body": body})
+
+
+async def send_trace(scope: dict, send, file, headers: list) -> None:
+    """
+    A whole trace file, streamed rather than read into memory. Its ETag
+    changes when the name is saved over, so the frontend can revalidate the
+    copy it keeps for offline playback.
+    """
+
+    stat = os.fstat(file.fileno())
+    etag = f'"{stat.st_mtime_ns:x}-{stat.st_size:x}"'.encode()
+    headers.append((b"access-control-expose-headers", b"etag"))
+    headers.append((b"etag", etag))
+    status = 200
+    if scope["method"] == "OPTIONS":
+        # Preflight, for the If-None-Match header
+        headers.append((b"access-control-allow-headers", b"if-none-match"))
+        status = 204
+    elif dict(scope["headers"]).get(b"if-none-match") == etag:
+        status = 304
+    else:
+        headers.append((b"content-type", b"application/octet-stream"))
+        headers.append((b"content-length", str(stat.st_size).encode()))
+
+    await send(
+        {"type": "http.response.start", "status": status, "headers": headers}
+    )
+    while status == 200 and (chunk := file.read(TRACE_CHUNK_SIZE)):
+        await send(
+            {"type": "http.response.body", "body": chunk, "more_body": True}
+        )
+    await send({"type": "http.response.body", "body": b""})
+
+
+def trace_response(name: str, part: str) -> tuple[str, bytes]:
+    trace = traces[name]
+    if part == "types":
+        return "application/json", json.dumps(trace.types()).encode()
+    return "application/json", json.dumps(trace.state(int(part))).encode()
 
 
-app = ASGIApp(server, socketio_path="/debugger")
+app = ASGIApp(server, other_asgi_app=http, socketio_path="/debugger")
 
 if __name__ == "__main__":
     host = "0.0.0.0"
@@ -149,5 +699,6 @@ if __name__ == "__main__":
     info("( ^.^ )")
     info(" > ^ < ")
     info(f"Server is available at [http://localhost:{port}/]")
+    info(f"Step metrics at [http://localhost:{port}/metrics]")
 
     run("__main__:app", port=port, host=host, log_level="error")
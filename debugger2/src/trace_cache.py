@@ -0,0 +1,174 @@
+from collections import OrderedDict
+from dataclasses import dataclass
+from dataclasses import field
+from hashlib import sha256
+import json
+
+"""
+Recorded steps of deterministic programs, shared between sessions
+
+gdb disables ASLR, so running the same binary with the same stdin and
+stepping it the same way always produces the same states. The first
+session to step a binary records the events it sent for each step, and
+later sessions with the same binary are served those events without
+starting gdb. A session only goes live (see serve.State.go_live) once it
+sends input the recording did not see, or steps past the end of it.
+
+Instead of keying by the whole stdin transcript up front, each step
+records the input sent before it and while it waited for input, so
+sessions share a recording for as long as their transcripts agree. The
+annotations and expanded objects a step was traced with are recorded the
+same way, since they change what its state holds.
+"""
+
+# Breakpoints on every function, then -exec-next
+STEP_POLICY = "next/all-functions"
+
+MAX_RECORDINGS = 256
+MAX_STEPS = 5_000
+MAX_BYTES = 256 * 2**20  # of events, as JSON
+
+
+@dataclass(slots=True)
+class Step:
+    stdin: str  # sent by the user since the previous step
+    waited: bool  # the program waited for input during the step
+    context: str  # see serve.State.context
+    events: list[tuple[str, object]]
+
+
+@dataclass(slots=True)
+class Recording:
+    steps: list[Step] = field(default_factory=list)
+    finished: bool = False  # the program exited after the last step
+    size: int = 0  # bytes of events
+
+    def matches(self, step: int, stdin: str, context: str) -> bool:
+        """
+        Whether step number `step` was recorded with the same input, and
+        traced with the same annotations and expansions
+
+        >>> recording = Recording(
+        ...     [Step("", False, "", []), Step("4\\n", True, "", [])]
+        ... )
+        >>> recording.matches(0, "", ""), recording.matches(1, "5\\n", "")
+        (True, False)
+        >>> recording.matches(0, "", "[[\\"list\\"], [], []]")
+        False
+        >>> recording.matches(2, "", "")
+        False
+        """
+
+        return (
+            step < len(self.steps)
+            and self.steps[step].stdin == stdin
+            and self.steps[step].context == context
+        )
+
+    def awaits_input(self, step: int, stdin: str) -> bool:
+        """
+        Whether step number `step` waited for input the session has only
+        sent part of so far. A replay waits there too rather than diverge.
+
+        >>> recording = Recording([Step("4\\n", True, "", [])])
+        >>> recording.awaits_input(0, ""), recording.awaits_input(0, "4\\n")
+        (True, False)
+        >>> recording.awaits_input(0, "5\\n")
+        False
+        """
+
+        if step >= len(self.steps) or not self.steps[step].waited:
+            return False
+        recorded = self.steps[step].stdin
+        return len(stdin) < len(recorded) and recorded.startswith(stdin)
+
+    def extend(
+        self, step: int, stdin: str, waited: bool, context: str, events: list
+    ) -> int:
+        """
+        Record a live step, unless a concurrent session already did. Returns
+        the bytes added.
+
+        >>> recording = Recording()
+        >>> recording.extend(0, "", False, "", [("executeNext", "")])
+        21
+        >>> recording.extend(0, "", False, "", [("executeNext", "")])
+        0
+        >>> len(recording.steps), recording.size
+        (1, 21)
+        """
+
+        if step != len(self.steps) or step >= MAX_STEPS:
+            return 0
+        self.steps.append(Step(stdin, waited, context, events))
+        size = len(json.dumps(events, default=str))
+        self.size += size
+        return size
+
+
+class TraceCache:
+    """Recordings by key, least recently used first"""
+
+    def __init__(
+        self, max_recordings: int = MAX_RECORDINGS, max_bytes: int = MAX_BYTES
+    ) -> None:
+        self.recordings = OrderedDict[str, Recording]()
+        self.max_recordings = max_recordings
+        self.max_bytes = max_bytes
+        self.size = 0  # bytes of every recording
+
+    @staticmethod
+    def key(binary: bytes, policy: str = STEP_POLICY) -> str:
+        return sha256(binary + policy.encode()).hexdigest()
+
+    def recording(self, key: str) -> Recording:
+        """
+        The recording for `key`, created empty if there is none yet
+
+        >>> cache = TraceCache(max_recordings=2)
+        >>> a, b = cache.recording("a"), cache.recording("b")
+        >>> cache.recording("a") is a
+        True
+        >>> _ = cache.recording("c")
+        >>> list(cache.recordings)
+        ['a', 'c']
+        """
+
+        if key in self.recordings:
+            self.recordings.move_to_end(key)
+        else:
+            self.recordings[key] = Recording()
+            self.evict()
+        return self.recordings[key]
+
+    def extend(self, key: str, recording: Recording, *step) -> None:
+        """
+        Recording.extend, counting the bytes against the budget. Sessions
+        keep replaying a recording once it is evicted, but no longer add to
+        it.
+
+        >>> cache = TraceCache(max_bytes=50)
+        >>> a, b = cache.recording("a"), cache.recording("b")
+        >>> cache.extend("a", a, 0, "", False, "", [("executeNext", "")])
+        >>> cache.extend("b", b, 0, "", False, "", [("executeNext", "")])
+        >>> cache.extend("a", a, 1, "", False, "", [("executeNext", "")])
+        >>> list(cache.recordings), cache.size
+        (['a'], 42)
+        >>> cache.extend("b", b, 1, "", False, "", [("executeNext", "")])
+        >>> len(b.steps)
+        1
+        """
+
+        if self.recordings.get(key) is not recording:
+            return
+        self.size += recording.extend(*step)
+        self.recordings.move_to_end(key)
+        self.evict()
+
+    def evict(self) -> None:
+        while self.recordings and (
+            len(self.recordings) > self.max_recordings
+            or self.size > self.max_bytes
+        ):
+            _, recording = self.recordings.popitem(last=False)
+            self.size -= recording.size
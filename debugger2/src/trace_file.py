@@ -0,0 +1,339 @@
+from collections import OrderedDict
+from mmap import mmap, ACCESS_READ
+from pathlib import Path
+import json
+import struct
+import zlib
+
+"""
+Seekable trace files of recorded debug sessions
+
+Everything is little-endian. The client reads the same format in
+client/src/visualiser-debugger/Trace/traceFile.ts, so keep them in sync.
+
+    header      magic "DSVT", u16 version, u16 flags, u32 steps,
+                u32 keyframe interval, u64 offsets of the string table,
+                type table and index
+    strings     u32 count, then for each a u32 length and UTF-8 bytes
+    types       u32 length, then a block of the type declarations
+    blocks      one per step, see below
+    index       for each step a u64 offset, u32 length, u8 kind, 3 padding
+
+Blocks are JSON, deflated if FLAG_DEFLATE is set. Every keyframe interval
+steps there is a keyframe with the whole backend state, the steps in
+between are deltas from the step before them. Stack variable names, heap
+addresses and frame info strings are indices into the string table:
+
+    keyframe    {"f": frame, "s": [[name, value], ...], "h": [[addr, value], ...],
+                 "b": [[addr, size], ...], "p": [[addr, tag], ...]}
+    delta       same, but "f" only if it changed, the other sections only
+                hold changed entries, and "S", "H", "B" and "P" list the
+                removed ones
+    frame       [file, function, line_num], plus an object of any other
+                frame_info fields
+
+"b" holds the live heap blocks and "p" what each pointer points to, they
+are missing from files written before the debugger found them.
+"""
+
+MAGIC = b"DSVT"
+VERSION = 1
+FLAG_DEFLATE = 1
+
+HEADER = struct.Struct("<4sHHIIQQQ")
+INDEX_ENTRY = struct.Struct("<QIB3x")
+U32 = struct.Struct("<I")
+
+KEYFRAME = 0
+DELTA = 1
+
+KEYFRAME_INTERVAL = 16
+# Sections of a block, with the key of their removed entries in a delta
+SECTIONS = (("s", "S"), ("h", "H"), ("b", "B"), ("p", "P"))
+# Sections only in some states, with their key in the state
+OPTIONAL = {"b": "heap_blocks", "p": "pointers"}
+SUFFIX = ".dsvt"
+
+
+class Strings:
+    def __init__(self) -> None:
+        self.index = dict[str, int]()
+
+    def __call__(self, string: str) -> int:
+        return self.index.setdefault(string, len(self.index))
+
+    def encode(self) -> bytes:
+        chunks = [U32.pack(len(self.index))]
+        for string in self.index:
+            data = string.encode()
+            chunks += [U32.pack(len(data)), data]
+        return b"".join(chunks)
+
+
+def write(
+    path: str | Path,
+    types: list[dict],
+    states: list[dict],
+    keyframe_interval: int = KEYFRAME_INTERVAL,
+    deflate: bool = True,
+) -> None:
+    """
+    Write the backend state after each step, as sent to the frontend
+
+    >>> from tempfile import TemporaryDirectory
+    >>> states = [
+    ...     {
+    ...         "frame_info": {"file": "main.c", "function": "main", "line_num": n},
+    ...         "stack_data": {"i": {"addr": "0x10", "typeName": "int", "value": n}},
+    ...         "heap_data": {f"0x{a}0": {"value": a} for a in range(n % 3)},
+    ...         **({"heap_blocks": {"0x20": n}} if n % 5 else {}),
+    ...         **({"pointers": {"0x20": "heap"}} if n % 3 else {}),
+    ...     }
+    ...     for n in range(40)
+    ... ]
+    >>> with TemporaryDirectory() as directory:
+    ...     write(f"{directory}/t.dsvt", [{"typeName": "int"}], states, 8)
+    ...     with TraceFile(f"{directory}/t.dsvt") as trace:
+    ...         loaded = [trace.state(step) for step in (39, 3, *range(40))]
+    ...         types = trace.types()
+    >>> loaded[2:] == states and loaded[:2] == [states[39], states[3]]
+    True
+    >>> types
+    [{'typeName': 'int'}]
+    """
+
+    strings = Strings()
+    blocks = list[tuple[int, bytes]]()
+    previous = None
+    for step, state in enumerate(states):
+        current = _encode_state(state, strings)
+        if step % keyframe_interval == 0:
+            keyframe = {"f": current["f"]} | {
+                section: [[k, v] for k, v in current[section].items()]
+                for section, _ in SECTIONS
+            }
+            blocks.append((KEYFRAME, _block(keyframe, deflate)))
+        else:
+            blocks.append((DELTA, _block(_delta(previous, current), deflate)))
+        previous = current
+
+    table = strings.encode()
+    type_block = _block(types, deflate)
+
+    offset = HEADER.size
+    strings_offset = offset
+    offset += len(table)
+    types_offset = offset
+    offset += U32.size + len(type_block)
+    index = list[bytes]()
+    for kind, block in blocks:
+        index.append(INDEX_ENTRY.pack(offset, len(block), kind))
+        offset += len(block)
+
+    header = HEADER.pack(
+        MAGIC,
+        VERSION,
+        FLAG_DEFLATE if deflate else 0,
+        len(states),
+        keyframe_interval,
+        strings_offset,
+        types_offset,
+        offset,
+    )
+    with open(path, "wb") as file:
+        file.write(header)
+        file.write(table)
+        file.write(U32.pack(len(type_block)) + type_block)
+        for _, block in blocks:
+            file.write(block)
+        file.write(b"".join(index))
+
+
+class TraceFile:
+    """
+    Reads steps on demand from a memory mapped trace file, so serving a
+    trace costs no more memory than the steps being looked at
+    """
+
+    def __init__(self, path: str | Path) -> None:
+        with open(path, "rb") as file:
+            self.map = mmap(file.fileno(), 0, access=ACCESS_READ)
+
+        (
+            magic,
+            version,
+            self.flags,
+            self.steps,
+            self.keyframe_interval,
+            strings_offset,
+            self.types_offset,
+            self.index_offset,
+        ) = HEADER.unpack_from(self.map)
+        if magic != MAGIC:
+            raise ValueError(f"{path} is not a trace file")
+        if version > VERSION:
+            raise ValueError(f"{path} is version {version}, newer than us")
+
+        (count,) = U32.unpack_from(self.map, strings_offset)
+        offset = strings_offset + U32.size
+        self.strings = list[str]()
+        for _ in range(count):
+            (length,) = U32.unpack_from(self.map, offset)
+            offset += U32.size
+            self.strings.append(self.map[offset : offset + length].decode())
+            offset += length
+
+        # The last state decoded, so stepping forwards applies one delta
+        self.last: tuple[int, dict] | None = None
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *_) -> None:
+        self.close()
+
+    def close(self) -> None:
+        self.map.close()
+
+    def types(self) -> list[dict]:
+        (length,) = U32.unpack_from(self.map, self.types_offset)
+        start = self.types_offset + U32.size
+        return self._load(self.map[start : start + length])
+
+    def state(self, step: int) -> dict:
+        if not 0 <= step < self.steps:
+            raise IndexError(f"No step {step}, only 0 to {self.steps - 1}")
+
+        keyframe = step - step % self.keyframe_interval
+        if self.last is not None and keyframe <= self.last[0] <= step:
+            start, state = self.last
+        else:
+            start, state = keyframe, self._block(keyframe)
+        for delta in range(start + 1, step + 1):
+            state = _apply(state, self._block(delta))
+
+        self.last = step, state
+        return _decode_state(state, self.strings)
+
+    def _block(self, step: int):
+        offset, length, _ = INDEX_ENTRY.unpack_from(
+            self.map, self.index_offset + step * INDEX_ENTRY.size
+        )
+        return self._load(self.map[offset : offset + length])
+
+    def _load(self, block: bytes):
+        if self.flags & FLAG_DEFLATE:
+            block = zlib.decompress(block)
+        return json.loads(block)
+
+
+class TraceFiles:
+    """Open trace files of a directory, closing the least recently used"""
+
+    def __init__(self, directory: str | Path, max_open: int = 32) -> None:
+        self.directory = Path(directory)
+        self.open = OrderedDict[str, TraceFile]()
+        self.max_open = max_open
+
+    def path(self, name: str) -> Path:
+        if not name or not all(c.isalnum() or c in "-_" for c in name):
+            raise ValueError(f"Invalid trace name: {name!r}")
+        return self.directory / f"{name}{SUFFIX}"
+
+    def write(self, name: str, types: list[dict], states: list[dict]) -> None:
+        path = self.path(name)
+        if name in self.open:
+            self.open.pop(name).close()
+        self.directory.mkdir(parents=True, exist_ok=True)
+        # Replaced whole, so downloads of the old file finish reading it
+        partial = path.with_suffix(".partial")
+        write(partial, types, states)
+        partial.replace(path)
+
+    def __getitem__(self, name: str) -> TraceFile:
+        if name in self.open:
+            self.open.move_to_end(name)
+            return self.open[name]
+
+        path = self.path(name)
+        if not path.exists():
+            raise KeyError(name)
+        self.open[name] = TraceFile(path)
+        if len(self.open) > self.max_open:
+            self.open.popitem(last=False)[1].close()
+        return self.open[name]
+
+
+def _block(data, deflate: bool) -> bytes:
+    encoded = json.dumps(data, separators=(",", ":")).encode()
+    return zlib.compress(encoded, 9) if deflate else encoded
+
+
+def _encode_state(state: dict, strings: Strings) -> dict:
+    frame = dict(state["frame_info"])
+    encoded_frame = [
+        strings(frame.pop("file")),
+        strings(frame.pop("function")),
+        frame.pop("line_num"),
+    ]
+    if frame:
+        encoded_frame.append(frame)
+    return {
+        "f": encoded_frame,
+        "s": {strings(k): v for k, v in state["stack_data"].items()},
+        "h": {strings(k): v for k, v in state["heap_data"].items()},
+    } | {
+        section: {strings(k): v for k, v in state.get(key, {}).items()}
+        for section, key in OPTIONAL.items()
+    }
+
+
+def _decode_state(state: dict, strings: list[str]) -> dict:
+    file, function, line_num, *other = state["f"]
+    return {
+        "frame_info": {
+            "file": strings[file],
+            "function": strings[function],
+            "line_num": line_num,
+            **(other[0] if other else {}),
+        },
+        "stack_data": {strings[k]: v for k, v in state["s"]},
+        "heap_data": {strings[k]: v for k, v in state["h"]},
+    } | {
+        key: {strings[k]: v for k, v in state[section]}
+        for section, key in OPTIONAL.items()
+        if state.get(section)
+    }
+
+
+def _delta(previous: dict, current: dict) -> dict:
+    """
+    >>> empty = {"h": {}, "b": {}, "p": {}}
+    >>> _delta({"f": [0, 1, 2], "s": {0: 1, 1: 2}, **empty},
+    ...        {"f": [0, 1, 3], "s": {0: 1, 2: 3}, **empty})
+    {'f': [0, 1, 3], 's': [[2, 3]], 'S': [1]}
+    """
+
+    delta = {}
+    if current["f"] != previous["f"]:
+        delta["f"] = current["f"]
+    for section, removed in SECTIONS:
+        before, after = previous[section], current[section]
+        if changed := [[k, v] for k, v in after.items() if before.get(k) != v]:
+            delta[section] = changed
+        if gone := [k for k in before if k not in after]:
+            delta[removed] = gone
+    return delta
+
+
+def _apply(state: dict, delta: dict) -> dict:
+    """Apply a delta to a decoded block, both as read from the file"""
+
+    result = {"f": delta.get("f", state["f"])}
+    for section, removed in SECTIONS:
+        entries = dict(map(tuple, state.get(section, ())))
+        for key in delta.get(removed, ()):
+            entries.pop(key, None)
+        entries.update(map(tuple, delta.get(section, ())))
+        result[section] = [[k, v] for k, v in entries.items()]
+    return result